@@ -12,6 +12,7 @@ enum class error_type
 
     file_not_found,
     invalid_json,
+    invalid_bundle,
     invalid_value,
     system_error,
     no_handle,
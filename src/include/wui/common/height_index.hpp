@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Prefix sums of the item heights on a Fenwick tree: the item top, the item under y and
+/// the change of one height are O(log n). If all the items have the same height it keeps nothing but the height
+class height_index
+{
+public:
+    height_index();
+
+    /// count items of the same height
+    void reset(int32_t count, int32_t uniform_height);
+
+    void assign(const std::vector<int32_t> &heights);
+
+    void set(int32_t item, int32_t height);
+
+    /// The items from the item are moved down by the new ones, O(n) only if the heights differ
+    void insert(int32_t item, const std::vector<int32_t> &heights);
+    void erase(int32_t item, int32_t count);
+
+    int32_t count() const;
+    int32_t height(int32_t item) const;
+
+    /// Sum of the heights of the items before the item
+    int32_t top(int32_t item) const;
+    int32_t total() const;
+
+    /// The item containing y, -1 if y is negative and count() if y is below the last item
+    int32_t item_at(int32_t y) const;
+
+private:
+    int32_t count_, uniform_height;
+
+    std::vector<int32_t> heights, tree;
+
+    int32_t high_bit;
+
+    bool uniform() const;
+    void build(const std::vector<int32_t> &heights);
+};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// Samples of the series with the minimums and the maximums of their groups: each level keeps one pair
+/// for fan_out pairs of the level below. The min and max of any range is taken from the largest groups
+/// fitting in it, so the cost depends on the count of the levels and not on the length of the range
+class minmax_pyramid
+{
+public:
+    static const int32_t fan_out = 4;
+
+    minmax_pyramid();
+
+    void clear();
+
+    /// Updates the last group of each level, O(levels)
+    void append(double value);
+
+    int64_t size() const;
+    double value(int64_t n) const;
+
+    /// The min and max of the samples [first, last), false if the range is empty
+    bool range(int64_t first, int64_t last, double &min, double &max) const;
+
+private:
+    struct bounds
+    {
+        double min, max;
+    };
+
+    std::vector<double> samples;
+    std::vector<std::vector<bounds>> levels; /// the group of the level k covers fan_out^(k + 1) samples
+};
+
+}
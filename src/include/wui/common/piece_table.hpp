@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// Text of the editor as the pieces of two buffers: the assigned text is never copied again and the inserted text
+/// is appended to the add buffer, so an edit moves the pieces, not the bytes. The line starts are kept sorted
+/// and shifted by the edits, only the inserted text is scanned for the line breaks
+class piece_table
+{
+public:
+    piece_table();
+
+    void assign(std::string text);
+
+    void insert(size_t position, std::string_view text);
+    void erase(size_t position, size_t length);
+
+    size_t size() const;
+
+    std::string text() const;
+    std::string text(size_t position, size_t length) const;
+    char at(size_t position) const;
+
+    int32_t line_count() const;
+
+    /// The offset of the first byte of the line and of its end (the line break is not included)
+    size_t line_start(int32_t line) const;
+    size_t line_end(int32_t line) const;
+
+    /// The line containing the offset
+    int32_t line_of(size_t position) const;
+
+    std::string line(int32_t line) const;
+
+private:
+    struct piece
+    {
+        bool added;
+        size_t start, length;
+    };
+
+    std::string original, added;
+    std::vector<piece> pieces;
+    size_t size_;
+
+    std::vector<size_t> line_starts;
+
+    const char *data(const piece &p) const;
+
+    /// Splits the piece at the position, returns the number of the piece starting there
+    size_t split(size_t position);
+};
+
+}
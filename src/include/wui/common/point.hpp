@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace wui
+{
+
+struct point
+{
+    int32_t x, y;
+
+    inline bool operator==(const point &lv) const
+    {
+        return x == lv.x && y == lv.y;
+    }
+};
+
+}
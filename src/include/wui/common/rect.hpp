@@ -35,6 +35,26 @@ struct rect
         return !((outer.right <= left || right <= outer.left || outer.bottom <= top || bottom <= outer.top));
     }
 
+    /// The common part of the rects, it has zero size if they don't intersect
+    inline rect intersection(const rect &lv) const
+    {
+        rect out = { left > lv.left ? left : lv.left,
+            top > lv.top ? top : lv.top,
+            right < lv.right ? right : lv.right,
+            bottom < lv.bottom ? bottom : lv.bottom };
+
+        if (out.right < out.left)
+        {
+            out.right = out.left;
+        }
+        if (out.bottom < out.top)
+        {
+            out.bottom = out.top;
+        }
+
+        return out;
+    }
+
     inline bool is_null() const
     {
         return left == 0 && top == 0 && right == 0 && bottom == 0;
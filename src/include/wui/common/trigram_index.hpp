@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Case insensitive (ASCII) substring search over the added texts. Each text is split to the trigrams,
+/// so the query of three or more bytes checks only the texts having its rarest trigram
+class trigram_index
+{
+public:
+    trigram_index();
+
+    void clear();
+
+    /// The text gets the number equal to the count of the texts added before
+    void add(std::string_view text);
+
+    int32_t count() const;
+
+    /// Calls match for the numbers of the texts containing the query in the ascending order, match returns false to stop
+    void search(std::string_view query, std::function<bool(int32_t)> match) const;
+
+private:
+    std::vector<std::string> texts; /// lowered
+    std::unordered_map<uint32_t, std::vector<int32_t>> postings;
+};
+
+}
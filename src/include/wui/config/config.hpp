@@ -47,6 +47,10 @@ void delete_value(std::string_view section, std::string_view entry);
 /// Delete the key from config
 void delete_key(std::string_view section);
 
+/// Write the pending changes now, the ini file is otherwise written in the background
+/// after a pause in the changes and when the config is destroyed
+void flush();
+
 }
 
 }
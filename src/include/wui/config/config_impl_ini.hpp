@@ -3,6 +3,10 @@
 #include <wui/config/i_config.hpp>
 
 #include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
 
 namespace wui
 {
@@ -10,10 +14,13 @@ namespace wui
 namespace config
 {
 
+/// The changes are kept in memory and written by the background thread after a pause
+/// in the changes, the file is replaced atomically through a temporary file
 class config_impl_ini : public i_config
 {
 public:
     config_impl_ini(std::string_view file_name);
+    ~config_impl_ini();
 
     int32_t get_int(std::string_view section, std::string_view entry, int32_t default_);
     void set_int(std::string_view section, std::string_view entry, int32_t value);
@@ -28,6 +35,8 @@ public:
 
     void delete_key(std::string_view section);
 
+    virtual void flush();
+
     virtual error get_error() const;
 
 private:
@@ -54,10 +63,21 @@ private:
 
     std::map<std::pair<std::string, std::string>, value> values;
 
+    mutable std::mutex mutex;
+    std::condition_variable flush_condition;
+    std::thread flusher;
+    bool dirty, stopping;
+    std::chrono::steady_clock::time_point first_change, last_change;
+
+    std::mutex save_mutex;
+
     error err;
 
     bool load_values();
     bool save_values();
+
+    void mark_dirty();
+    void flush_work();
 };
 
 }
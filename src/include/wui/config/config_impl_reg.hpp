@@ -32,6 +32,8 @@ public:
 
     void delete_key(std::string_view section);
 
+    virtual void flush();
+
     virtual error get_error() const;
 
 private:
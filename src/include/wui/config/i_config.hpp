@@ -26,6 +26,9 @@ public:
     virtual void delete_value(std::string_view section, std::string_view entry) = 0;
 
     virtual void delete_key(std::string_view section) = 0;
+
+    /// Write the pending changes to the storage now
+    virtual void flush() = 0;
        
     virtual error get_error() const = 0;
 
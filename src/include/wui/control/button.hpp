@@ -6,6 +6,7 @@
 #include <wui/event/event.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -125,13 +126,18 @@ private:
     
     std::function<void(void)> click_callback;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_calm, tk_active, tk_border, tk_border_width, tk_focused_border, tk_text, tk_disabled, tk_anchor, tk_round, tk_focusing, tk_font };
+    static constexpr const char *theme_values[] = { tv_calm, tv_active, tv_border, tv_border_width, tv_focused_border, tv_text, tv_disabled, tv_anchor, tv_round, tv_focusing, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
 
     std::weak_ptr<window> parent_;
-    std::string my_subscriber_id;
+    subscription_id my_subscriber_id;
 
     bool showed_, enabled_, topmost_;
     bool active, focused_;
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/minmax_pyramid.hpp>
+#include <wui/theme/theme_key.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Line chart of the series of samples. Each series keeps the min/max pyramid of its samples, so a pixel column
+/// takes the min and max of its samples in a few steps at any zoom and the draw touches about two points per column.
+/// Each series is drawn by one polyline. The wheel zooms around the mouse, dragging pans.
+/// Uses the theme values of list
+class chart : public i_control, public std::enable_shared_from_this<chart>
+{
+public:
+    chart(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~chart();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Chart's interface
+
+    /// Returns the number of the series
+    int32_t add_series(color color_, uint32_t width = 1);
+    int32_t series_count() const;
+
+    /// Removes the samples of all the series
+    void clear();
+
+    /// The sample n of each series is at the same x
+    void append(int32_t series, double value);
+    void append(int32_t series, const std::vector<double> &values);
+
+    /// The length of the longest series
+    int64_t sample_count() const;
+
+    /// Shows count samples from the first one
+    void set_view(int64_t first, int64_t count);
+    int64_t view_first() const;
+    int64_t view_count() const;
+
+    /// Changes the count of the shown samples by the factor keeping the sample under x on its place
+    void zoom(double factor, int32_t x);
+    void pan(int64_t samples);
+
+    /// The view is moved with the appended samples while it shows the last one
+    void set_follow_tail(bool yes);
+    bool follow_tail() const;
+
+    /// The y range is taken from the shown samples if min is not less than max
+    void set_y_range(double min, double max);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "list";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_round = "round";
+
+private:
+    struct series_data
+    {
+        minmax_pyramid samples;
+        color color_;
+        uint32_t width;
+    };
+
+    std::vector<series_data> series;
+
+    int64_t view_first_, view_count_;
+    bool follow_tail_;
+
+    double y_min, y_max;
+
+    std::vector<point> points; /// kept between the draws to not allocate them each time
+
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_focused_border, tk_border_width, tk_round };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_focused_border, tv_border_width, tv_round };
+
+    std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    subscription_id my_control_sid;
+
+    bool showed_, enabled_, topmost_, focused_;
+
+    bool dragging;
+    int32_t drag_x;
+    int64_t drag_first;
+
+    void receive_control_events(const event &ev);
+
+    void redraw();
+
+    rect plot_area() const;
+
+    /// The samples per pixel column of the plot area
+    double samples_per_pixel() const;
+
+    void appended();
+    void draw_series(graphic &gr, const series_data &series_, const rect &area, int32_t from_x, int32_t to_x, double min, double max);
+};
+
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/control/scroll.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/piece_table.hpp>
+#include <wui/system/timer.hpp>
+#include <wui/theme/theme_key.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+namespace wui
+{
+
+/// Multi-line text editor for the documents of several megabytes. The text lives in the piece table,
+/// the widths of the lines are measured when they are shown and only the edited lines are measured again.
+/// Uses the theme values of input
+class editor : public i_control, public std::enable_shared_from_this<editor>
+{
+public:
+    editor(std::string_view text = "", std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~editor();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Editor's interface
+    void set_text(std::string text);
+    std::string text() const;
+
+    void set_readonly(bool yes);
+    bool readonly() const;
+
+    int32_t line_count() const;
+
+    /// Moves the cursor to the line and shows it
+    void go_to_line(int32_t line);
+
+    /// Called after each edit, text() builds the whole document, so don't call it on each change of the large ones
+    void set_change_callback(std::function<void()> change_callback);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "input";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_text = "text";
+    static constexpr const char *tv_selection = "selection";
+    static constexpr const char *tv_cursor = "cursor";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+private:
+    piece_table buffer;
+
+    std::vector<int32_t> line_widths; /// -1 if the line was not measured after the change
+    int32_t line_height;
+
+    std::function<void()> change_callback;
+
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_text, tk_selection, tk_cursor, tk_border, tk_border_width, tk_focused_border, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_text, tv_selection, tv_cursor, tv_border, tv_border_width, tv_focused_border, tv_round, tv_font };
+
+    std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+    size_t cursor_position, select_start_position, select_end_position;
+    int32_t preferred_x; /// the cursor keeps the column when it goes up and down
+
+    std::weak_ptr<window> parent_;
+    subscription_id my_control_sid, my_plain_sid;
+
+    std::shared_ptr<scroll> vert_scroll;
+
+    timer timer_;
+
+    /// Lives between the clicks to hit test the text without creating a dc each time
+    system_context measure_context;
+    graphic measure_graphic;
+    bool measure_graphic_ready;
+
+    bool showed_, enabled_, topmost_, readonly_;
+    bool focused_;
+    bool cursor_visible;
+    bool selecting;
+    bool mouse_on_slider;
+
+    int32_t left_shift;
+
+    void receive_control_events(const event &ev);
+    void receive_plain_events(const event &ev);
+    void on_scroll(scroll_state, int32_t);
+
+    void redraw();
+    void redraw_cursor();
+
+    rect text_area() const;
+    graphic *measurer();
+
+    int32_t measure_line(graphic &gr, int32_t line);
+    int32_t column_x(graphic &gr, int32_t line, size_t position);
+    size_t column_at(graphic &gr, int32_t line, int32_t x);
+    size_t position_at(int32_t x, int32_t y);
+
+    void replace(size_t position, size_t length, std::string_view text);
+    void changed();
+
+    void move_cursor(size_t position, bool shift_pressed);
+    void make_cursor_visible();
+    void update_scroll_area();
+
+    bool clear_selected_text();
+    std::string selected_text() const;
+    void select_all();
+
+    size_t prev_position(size_t position) const;
+    size_t next_position(size_t position) const;
+
+    void buffer_copy();
+    void buffer_cut();
+    void buffer_paste();
+};
+
+}
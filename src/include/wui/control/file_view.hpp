@@ -0,0 +1,156 @@
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/control/scroll.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/system/mapped_file.hpp>
+#include <wui/theme/theme_key.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Read only view of the large text file. The file is mapped into memory and the offsets of its lines are indexed
+/// on the worker thread, the indexed lines are shown while the rest is indexed. Only the start of each
+/// index_step line is kept, so the memory does not depend on the file size much. Uses the theme values of list
+class file_view : public i_control, public std::enable_shared_from_this<file_view>
+{
+public:
+    file_view(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~file_view();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// File view's interface
+    bool open(std::string_view file_name);
+    void close();
+
+    /// The count of the indexed lines, it grows until indexed() is true
+    int64_t line_count() const;
+    bool indexed() const;
+
+    /// Shows the line at the top and marks it. The line which is not indexed yet is shown when it is indexed
+    void go_to_line(int64_t line);
+    void go_to_offset(uint64_t offset);
+
+    /// The line without the line break
+    std::string_view line(int64_t n) const;
+    int64_t line_of(uint64_t offset) const;
+
+    /// Called on the UI thread after each indexed part of the file
+    void set_index_callback(std::function<void(int64_t lines, bool indexed)> index_callback);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "list";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_title_text = "title_text";
+    static constexpr const char *tv_active_item = "active_item";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+    static const int64_t index_step = 64;
+
+private:
+    mapped_file file;
+
+    std::vector<uint64_t> line_starts; /// the start of each index_step line
+    int64_t lines;
+    uint64_t indexed_size; /// the bytes scanned by the worker
+    bool indexed_;
+
+    int64_t marked_line, pending_line;
+    uint64_t pending_offset;
+
+    std::function<void(int64_t, bool)> index_callback;
+
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_focused_border, tk_border_width, tk_title_text, tk_active_item, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_focused_border, tv_border_width, tv_title_text, tv_active_item, tv_round, tv_font };
+
+    std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    subscription_id my_control_sid;
+
+    /// The scroll position is the line at the top, not the pixel, so the pixel offsets of the large files don't overflow
+    std::shared_ptr<scroll> vert_scroll;
+
+    int32_t line_height;
+
+    bool showed_, enabled_, topmost_, focused_;
+    bool mouse_on_slider;
+
+    std::thread worker;
+    std::atomic<bool> stopping;
+    uint64_t generation; /// the parts posted for the file closed before are dropped
+
+    std::shared_ptr<file_view*> alive; /// the posted parts are dropped after the destruction
+
+    error err;
+
+    void receive_control_events(const event &ev);
+    void on_scroll(scroll_state, int32_t);
+
+    void redraw();
+
+    rect text_area() const;
+    int32_t lines_on_page() const;
+    void update_scroll_area();
+    void scroll_to(int64_t line);
+
+    uint64_t line_start(int64_t n) const;
+    uint64_t line_end(uint64_t start) const;
+
+    void work(uint64_t generation_);
+    void indexed_part(uint64_t generation_, std::vector<uint64_t> &&starts, int64_t lines_, uint64_t scanned, bool done);
+    void apply_pending();
+};
+
+}
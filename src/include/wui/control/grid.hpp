@@ -0,0 +1,171 @@
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/control/scroll.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/height_index.hpp>
+#include <wui/theme/theme_key.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+
+namespace wui
+{
+
+/// Table of rows and columns virtualized in both directions. The row heights and the column widths are kept
+/// as prefix sums, so the cells under the clip are found without walking the rows and the columns before them,
+/// and the draw callback is called for these cells only. The first rows and columns can be frozen:
+/// they are not scrolled and are drawn as titles. Uses the theme values of list
+class grid : public i_control, public std::enable_shared_from_this<grid>
+{
+public:
+    grid(std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~grid();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Grid's interface
+
+    /// The added rows and columns take the default height and width
+    void set_size(int32_t rows, int32_t columns);
+    int32_t row_count() const;
+    int32_t column_count() const;
+
+    /// All the rows or columns take the size, the added ones too
+    void set_default_row_height(int32_t height);
+    void set_default_column_width(int32_t width);
+
+    void set_row_height(int32_t row, int32_t height);
+    void set_column_width(int32_t column, int32_t width);
+    int32_t row_height(int32_t row) const;
+    int32_t column_width(int32_t column) const;
+
+    /// The first rows and columns are not scrolled
+    void set_frozen(int32_t rows, int32_t columns);
+
+    void select_cell(int32_t row, int32_t column);
+    void selected_cell(int32_t &row, int32_t &column) const;
+
+    /// Scrolls the least to show the cell
+    void scroll_to_cell(int32_t row, int32_t column);
+
+    /// Repaints only the shown part of the cell or of the cells range
+    void update_cell(int32_t row, int32_t column);
+    void update_cells(int32_t first_row, int32_t first_column, int32_t last_row, int32_t last_column);
+
+    enum class cell_state
+    {
+        normal,
+        selected,
+        frozen
+    };
+
+    /// Called for the cells under the clip, the background of the cell is filled before
+    void set_draw_callback(std::function<void(graphic&, int32_t row, int32_t column, const rect&, cell_state)> draw_callback);
+    void set_cell_click_callback(std::function<void(int32_t row, int32_t column)> cell_click_callback);
+    void set_cell_change_callback(std::function<void(int32_t row, int32_t column)> cell_change_callback);
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "list";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_title = "title";
+    static constexpr const char *tv_selected_item = "selected_item";
+    static constexpr const char *tv_round = "round";
+
+private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_focused_border, tk_border_width, tk_title, tk_selected_item, tk_round };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_focused_border, tv_border_width, tv_title, tv_selected_item, tv_round };
+
+    std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    subscription_id my_control_sid;
+
+    height_index rows, columns;
+    int32_t default_row_height, default_column_width;
+    int32_t frozen_rows, frozen_columns;
+
+    int32_t selected_row, selected_column;
+
+    std::shared_ptr<scroll> vert_scroll, hor_scroll;
+    std::shared_ptr<scroll> mouse_on_scroll;
+
+    bool showed_, enabled_, topmost_, focused_;
+
+    std::function<void(graphic&, int32_t, int32_t, const rect&, cell_state)> draw_callback;
+    std::function<void(int32_t, int32_t)> cell_click_callback;
+    std::function<void(int32_t, int32_t)> cell_change_callback;
+
+    void receive_control_events(const event &ev);
+    void on_vert_scroll(scroll_state, int32_t);
+    void on_hor_scroll(scroll_state, int32_t);
+
+    void redraw();
+
+    /// The cells area without the border and the scrollbars
+    rect cells_area() const;
+
+    /// The size of the frozen rows and columns
+    int32_t frozen_height() const;
+    int32_t frozen_width() const;
+
+    /// The cell position on the window, the scrolled cells are shifted by the scroll position
+    rect cell_rect(int32_t row, int32_t column) const;
+
+    /// The row or the column under the window's coordinate, -1 if none
+    int32_t row_at(int32_t y) const;
+    int32_t column_at(int32_t x) const;
+
+    /// One of the four parts of the cells area: the frozen corner, the frozen rows, the frozen columns and the scrolled cells
+    rect region(bool scrolled_rows, bool scrolled_columns) const;
+    void draw_region(graphic &gr, bool scrolled_rows, bool scrolled_columns);
+    void redraw_region_cells(int32_t first_row, int32_t first_column, int32_t last_row, int32_t last_column);
+
+    void update_scroll_areas();
+    void move_selection(int32_t row, int32_t column);
+};
+
+}
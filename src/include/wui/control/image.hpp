@@ -3,6 +3,7 @@
 
 #include <wui/control/i_control.hpp>
 #include <wui/graphic/graphic.hpp>
+#include <wui/graphic/image_cache.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 
@@ -11,11 +12,11 @@
 #include <memory>
 #include <vector>
 
-#include <gdiplus.h>
-
 namespace wui
 {
 
+/// The decoded pixels are taken from the shared image cache, so the images with the same source
+/// and size are decoded and scaled once for all the controls
 class image : public i_control, public std::enable_shared_from_this<image>
 {
 public:
@@ -59,6 +60,7 @@ public:
     void change_image(std::string_view file_name);
     void change_image(const std::vector<uint8_t> &data);
 
+    /// Zero while the image is decoded asynchronously
     int32_t width() const;
     int32_t height() const;
 
@@ -82,11 +84,31 @@ private:
     std::string file_name;
 	
     int32_t resource_index;
-    Gdiplus::Image *img;
+
+    image_source source;
+    std::shared_ptr<cached_image> img;
+
+    /// Async decoding: the callbacks reach the image through this pointer, it is cleared when the image changes or dies
+    std::shared_ptr<image*> pending;
+    std::pair<int32_t, int32_t> pending_size;
 
     error err;
 
+    void load(image_source &&source_);
+
+    void request(int32_t width, int32_t height);
+    void loaded(std::shared_ptr<cached_image> img_, int32_t width, int32_t height);
+    void cancel_pending();
+
     void redraw();
 };
 
+/// Decode the images missing in the cache on the worker threads instead of the constructors,
+/// the image controls are drawn empty until their pixels are ready
+void set_async_image_decoding(bool yes);
+
+/// Decode the theme images (or image files) in the background to have them ready for the first paint.
+/// Can be called before window::init(), but after framework::init()
+void prefetch_images(const std::vector<std::string> &names, std::shared_ptr<i_theme> theme_ = nullptr);
+
 }
@@ -3,11 +3,13 @@
 
 #include <wui/control/i_control.hpp>
 #include <wui/graphic/graphic.hpp>
+#include <wui/graphic/text_width_index.hpp>
 #include <wui/event/event.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 #include <wui/system/timer.hpp>
 #include <wui/control/menu.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -91,23 +93,34 @@ public:
 private:
     input_view input_view_;
     std::string text_;
+    text_width_index text_widths;
     
     std::function<void(const std::string&)> change_callback;
     std::function<void()> return_callback;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_text, tk_selection, tk_cursor, tk_border, tk_border_width, tk_focused_border, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_text, tv_selection, tv_cursor, tv_border, tv_border_width, tv_focused_border, tv_round, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
     size_t cursor_position, select_start_position, select_end_position;
     
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     timer timer_;
 
     std::shared_ptr<menu> menu_;
 
+    /// Lives between the clicks to hit test the text without creating a dc each time
+    system_context measure_context;
+    graphic measure_graphic;
+    bool measure_graphic_ready;
+
     bool showed_, enabled_, topmost_;
     bool focused_;
     bool cursor_visible;
@@ -6,7 +6,9 @@
 #include <wui/event/event.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/common/height_index.hpp>
 #include <wui/control/scroll.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <vector>
@@ -75,10 +77,22 @@ public:
 
     void set_column_width(int32_t n_column, int32_t width);
     int32_t get_item_height(int32_t n_item) const;
+
+    /// Makes all the items of the height, the item height callback is not called then. 0 returns to the callback
+    void set_item_height(int32_t height);
+
+    /// Call when the height returned by the item height callback for the item was changed
+    void update_item_height(int32_t n_item);
     
     void set_item_count(int32_t count);
     int32_t get_item_count() const;
 
+    /// The ranges of the items were inserted, removed or changed. Only the heights of the new or changed items are asked
+    /// and only the rows from the first item of the range are repainted
+    void insert_items(int32_t first, int32_t count);
+    void remove_items(int32_t first, int32_t count);
+    void update_items(int32_t first, int32_t count);
+
     void scroll_to_start();
     void scroll_to_end();
 
@@ -98,6 +112,7 @@ public:
         right
     };
 
+    /// Only the rows under the clip of the graphic are drawn, the callback can query graphic::clip() to skip the parts out of it
     void set_draw_callback(std::function<void(graphic&, int32_t, const rect&, item_state)> draw_callback_);
     void set_item_height_callback(std::function<void(int32_t, int32_t&)> item_height_callback_);
     void set_item_click_callback(std::function<void(click_button, int32_t, int32_t, int32_t)> item_click_callback_);
@@ -123,13 +138,18 @@ public:
     static constexpr const char *tv_font = "font";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_focused_border, tk_border_width, tk_title, tk_title_text, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_focused_border, tv_border_width, tv_title, tv_title_text, tv_round, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
     
     std::weak_ptr<window> parent_;
-    std::string my_control_sid;
+    subscription_id my_control_sid;
 
     bool showed_, enabled_, focused_, mouse_on_control, mouse_on_slider;
 
@@ -139,12 +159,21 @@ private:
 
     std::atomic<int32_t> item_count, selected_item_, active_item_;
 
+    mutable height_index item_heights;
+    mutable bool item_heights_valid;
+    int32_t uniform_item_height;
+
     int32_t title_height;
 
     int32_t scroll_area;
 
     std::shared_ptr<scroll> vert_scroll;
 
+    std::unique_ptr<graphic> content; /// items and titles kept between the paints, scrolling moves its pixels
+    rect content_size;
+    int32_t content_scroll_pos;
+    bool content_valid, scrolled, rows_damaged;
+
     std::function<void(graphic&, int32_t, const rect&, item_state)> draw_callback;
     std::function<void(int32_t, int32_t&)> item_height_callback;
     std::function<void(click_button, int32_t, int32_t, int32_t)> item_click_callback;
@@ -160,11 +189,13 @@ private:
     void redraw();
 
     void redraw_item(int32_t item);
+    void redraw_items(int32_t first, int32_t last);
 
     void calc_title_height(graphic &gr_);
     void draw_titles(graphic &gr_);
 
     void draw_items(graphic &gr_);
+    void draw_content(graphic &gr, const rect &size);
 
     bool has_scrollbar();
 
@@ -174,6 +205,8 @@ private:
     void make_selected_visible();
 
     void update_scroll_area();
+
+    void update_item_heights() const;
 };
 
 }
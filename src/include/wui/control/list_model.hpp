@@ -0,0 +1,114 @@
+#pragma once
+
+#include <wui/control/list.hpp>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// Row cells, one per column
+using list_row = std::vector<std::string>;
+
+/// The rows of the application, the model asks them by pages
+class i_list_data_source
+{
+public:
+    /// Called on the worker thread of the model. Returns up to count rows from the first one
+    virtual std::vector<list_row> fetch(int32_t first, int32_t count) = 0;
+
+    virtual ~i_list_data_source() {}
+};
+
+/// Virtualized rows of the list. Only the pages of rows being drawn are kept (the least recently used are dropped),
+/// the missed pages are fetched on the worker thread and the pages ahead of the scroll direction are prefetched.
+/// The rows are drawn as placeholders until their page arrives, then only these rows are repainted.
+/// All the methods are called on the UI thread
+class list_model
+{
+public:
+    list_model(std::shared_ptr<i_list_data_source> source, int32_t page_size = 64, size_t max_pages = 32, int32_t prefetch_pages = 2);
+    ~list_model();
+
+    /// Takes the item count, the draw and the scroll callbacks of the list
+    void attach(std::shared_ptr<list> list_);
+    void detach();
+
+    /// row is nullptr while its page is loading
+    void set_draw_callback(std::function<void(graphic&, int32_t, const list_row *row, const rect&, list::item_state)> draw_callback);
+
+    /// The row if its page is loaded, else nullptr and the page is requested
+    std::shared_ptr<const list_row> row(int32_t n);
+
+    /// The data was replaced
+    void reset(int32_t count);
+
+    /// The ranges of the data were changed, the loaded pages from the range are dropped and fetched again when shown
+    void inserted(int32_t first, int32_t count);
+    void removed(int32_t first, int32_t count);
+    void changed(int32_t first, int32_t count);
+
+    int32_t count() const;
+
+private:
+    struct page
+    {
+        std::vector<list_row> rows;
+        uint64_t last_use;
+    };
+
+    struct request
+    {
+        int32_t page_no;
+        uint64_t generation;
+    };
+
+    std::shared_ptr<i_list_data_source> source;
+    int32_t page_size, prefetch_pages;
+    size_t max_pages;
+
+    std::weak_ptr<list> list_;
+    std::function<void(graphic&, int32_t, const list_row*, const rect&, list::item_state)> draw_callback;
+
+    int32_t count_;
+
+    std::unordered_map<int32_t, std::shared_ptr<page>> pages;
+    uint64_t use_counter;
+
+    int32_t last_scroll_pos, scroll_direction;
+
+    /// Shared with the worker. The page fetched before its rows were shifted has other generation and is dropped
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<request> requests;
+    std::unordered_map<int32_t, uint64_t> in_flight;
+    uint64_t generation;
+    bool stopping;
+    std::thread worker;
+
+    std::shared_ptr<list_model*> alive; /// the posted results are dropped after the destruction
+
+    void draw_row(graphic &gr, int32_t n, const rect &position, list::item_state state);
+    void on_scroll(int32_t scroll_pos);
+
+    void request_page(int32_t page_no, bool prefetch);
+    void prefetch(int32_t page_no);
+    void arrived(int32_t page_no, uint64_t generation_, std::vector<list_row> &&rows);
+
+    void drop_pages(int32_t from_page, int32_t to_page);
+    void drop_unused();
+
+    void work();
+};
+
+}
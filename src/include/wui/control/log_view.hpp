@@ -0,0 +1,145 @@
+#pragma once
+
+#include <wui/control/i_control.hpp>
+#include <wui/control/scroll.hpp>
+#include <wui/graphic/graphic.hpp>
+#include <wui/event/event.hpp>
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+/// Append-only view of the live log. The last max_lines lines are kept in the ring of one byte arena,
+/// the lines are appended from any thread without the locks and the view is updated once per burst of the appends.
+/// Follows the tail until the user scrolls up. Uses the theme values of list
+class log_view : public i_control, public std::enable_shared_from_this<log_view>
+{
+public:
+    log_view(size_t max_lines = 100000, size_t arena_size = 16 * 1024 * 1024, std::string_view theme_control_name = tc, std::shared_ptr<i_theme> theme_ = nullptr);
+    ~log_view();
+
+    virtual void draw(graphic &gr, const rect &);
+
+    virtual void set_position(const rect &position, bool redraw = true);
+    virtual rect position() const;
+
+    virtual void set_parent(std::shared_ptr<window> window_);
+    virtual std::weak_ptr<window> parent() const;
+    virtual void clear_parent();
+
+    virtual void set_topmost(bool yes);
+    virtual bool topmost() const;
+
+    virtual void update_theme_control_name(std::string_view theme_control_name);
+    virtual void update_theme(std::shared_ptr<i_theme> theme_ = nullptr);
+
+    virtual void show();
+    virtual void hide();
+    virtual bool showed() const;
+
+    virtual void enable();
+    virtual void disable();
+    virtual bool enabled() const;
+
+    virtual bool focused() const;
+    virtual bool focusing() const;
+
+    virtual error get_error() const;
+
+public:
+    /// Log view's interface
+
+    /// Can be called from any thread. The text with the line breaks is appended as several lines
+    void append(std::string_view text);
+
+    /// Called on the UI thread, the lines appended after it are shown
+    void clear();
+
+    /// The count of the shown lines, it does not include the lines appended after the last update
+    int32_t line_count() const;
+
+    /// The line n from the oldest shown one, empty if it was overwritten
+    std::string line(int32_t n) const;
+
+    void set_follow_tail(bool yes);
+    bool follow_tail() const;
+
+public:
+    /// Control name in theme
+    static constexpr const char *tc = "list";
+
+    /// Used theme values
+    static constexpr const char *tv_background = "background";
+    static constexpr const char *tv_border = "border";
+    static constexpr const char *tv_focused_border = "focused_border";
+    static constexpr const char *tv_border_width = "border_width";
+    static constexpr const char *tv_title_text = "title_text";
+    static constexpr const char *tv_round = "round";
+    static constexpr const char *tv_font = "font";
+
+private:
+    /// The slot of the line n is n % max_lines. sequence is n + 1 after the line was written
+    struct slot
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> offset; /// in the arena's byte stream, the position in the arena is offset % arena_size
+        std::atomic<uint32_t> length;
+    };
+
+    const size_t max_lines, arena_size;
+
+    std::vector<char> arena;
+    std::unique_ptr<slot[]> slots;
+
+    std::atomic<uint64_t> reserved_lines, reserved_bytes;
+    std::atomic<bool> appended;
+
+    uint64_t committed_lines, first_line; /// the shown lines are [first_line, committed_lines), touched by the UI thread only
+
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_focused_border, tk_border_width, tk_title_text, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_focused_border, tv_border_width, tv_title_text, tv_round, tv_font };
+
+    std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
+    std::shared_ptr<i_theme> theme_;
+
+    rect position_;
+
+    std::weak_ptr<window> parent_;
+    subscription_id my_control_sid;
+
+    std::shared_ptr<scroll> vert_scroll;
+
+    std::shared_ptr<log_view*> alive; /// the posted updates are dropped after the destruction
+
+    int32_t line_height;
+
+    bool showed_, enabled_, topmost_, focused_;
+    bool follow_tail_;
+    bool mouse_on_slider;
+
+    void receive_control_events(const event &ev);
+    void on_scroll(scroll_state, int32_t);
+
+    void redraw();
+
+    /// Posted by the first append after the previous update, takes the lines appended since it
+    void update();
+
+    bool read_line(uint64_t n, std::string &out) const;
+
+    rect text_area() const;
+    void update_scroll_area();
+};
+
+}
@@ -8,9 +8,11 @@
 #include <wui/common/color.hpp>
 
 #include <wui/control/list.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <functional>
 #include <memory>
 
@@ -123,19 +125,36 @@ private:
     std::shared_ptr<i_theme> list_theme;
     std::shared_ptr<list> list_;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_border_width, tk_text, tk_disabled_text, tk_selected_item, tk_scrollbar, tk_scrollbar_slider, tk_scrollbar_slider_acive, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_border_width, tv_text, tv_disabled_text, tv_selected_item, tv_scrollbar, tv_scrollbar_slider, tv_scrollbar_slider_acive, tv_round, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
 
     std::weak_ptr<window> parent_;
-    std::string my_subscriber_id;
+    subscription_id my_subscriber_id;
 
     std::shared_ptr<i_control> activation_control;
     int32_t indent, x, y;
 
     std::vector<menu_item> items;
 
+    /// The shown rows of the items tree, the children of the expanded item follow it
+    std::vector<menu_item*> rows;
+
+    /// The place of each item in the tree and in the rows by its id, the row is -1 for the hidden item
+    struct item_place
+    {
+        menu_items_t *siblings;
+        size_t index;
+        int32_t row;
+    };
+    std::unordered_map<int32_t, item_place> ids;
+
     int32_t max_text_width, max_hotkey_width;
 
     int32_t item_height_;
@@ -149,6 +168,17 @@ private:
 
     void update_size();
 
+    void rebuild_index();
+    void index_items(menu_items_t &items_);
+    void forget_items(const menu_items_t &items_);
+
+    void insert_rows(int32_t first, const std::vector<menu_item*> &rows_);
+    void erase_rows(int32_t first, int32_t count, bool forgotten);
+    void update_rows_index(int32_t first);
+    menu_item *find_item(int32_t id);
+    menu_item *row_item(int32_t n_item);
+    int32_t shown_children(int32_t n_item) const;
+
     void draw_arrow_down(graphic &gr, rect pos, bool expanded);
     void draw_list_item(wui::graphic &gr, int32_t n_item, const wui::rect &item_rect_, list::item_state state);
     void activate_list_item(int32_t n_item);
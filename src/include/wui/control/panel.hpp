@@ -5,6 +5,7 @@
 #include <wui/graphic/graphic.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -56,7 +57,12 @@ public:
     static constexpr const char *tv_background = "background";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background };
+    static constexpr const char *theme_values[] = { tv_background };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
@@ -6,6 +6,7 @@
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 #include <wui/common/orientation.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -64,7 +65,12 @@ public:
     static constexpr const char *tv_meter = "meter";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_border, tk_border_width, tk_background };
+    static constexpr const char *theme_values[] = { tv_border, tv_border_width, tv_background };
+
     std::string tcn;
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
@@ -8,10 +8,11 @@
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 #include <wui/common/orientation.hpp>
+#include <wui/system/timer.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <functional>
 #include <memory>
-#include <thread>
 
 namespace wui
 {
@@ -84,13 +85,18 @@ public:
     static constexpr const char *tv_slider_acive = "slider_active";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_slider, tk_slider_acive };
+    static constexpr const char *theme_values[] = { tv_background, tv_slider, tv_slider_acive };
+
     std::string tcn; // control name
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
 
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     bool showed_, enabled_, topmost_;
 
@@ -112,7 +118,7 @@ private:
     };
 
     worker_action worker_action_;
-    std::thread worker;
+    timer worker;
     bool worker_runned;
 
     int32_t progress;
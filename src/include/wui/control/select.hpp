@@ -7,11 +7,18 @@
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 #include <wui/control/list.hpp>
+#include <wui/theme/theme_key.hpp>
+#include <wui/common/trigram_index.hpp>
 
 #include <string>
 #include <functional>
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 
 namespace wui
 {
@@ -68,6 +75,7 @@ public:
 
     /// Select's interface
     void set_items(const select_items_t &items);
+    void set_items(select_items_t &&items);
     void update_item(const select_item &mi);
     void swap_items(int64_t first_item_id, int64_t second_item_id);
     void delete_item(int64_t id);
@@ -102,17 +110,26 @@ public:
     static constexpr const char *tv_font = "font";
 
 private:
-    std::vector<select_item> items_;
+    /// Shared with the search thread, so the changes copy the items only while it holds them
+    std::shared_ptr<select_items_t> items_;
+    uint64_t items_version;
+
+    std::unordered_map<int64_t, int32_t> ids; /// item number by id
 
     std::function<void(int32_t, int64_t)> change_callback;
     
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_border_width, tk_focused_border, tk_text, tk_scrollbar, tk_scrollbar_slider, tk_scrollbar_slider_acive, tk_selected_item, tk_active_item, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_border_width, tv_focused_border, tv_text, tv_scrollbar, tv_scrollbar_slider, tv_scrollbar_slider_acive, tv_selected_item, tv_active_item, tv_round, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;;
     
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     std::shared_ptr<i_theme> list_theme;
     std::shared_ptr<list> list_;
@@ -125,6 +142,27 @@ private:
 
     int32_t item_height_;
 
+    /// Type-ahead: the dropdown shows the numbers of the items containing the typed filter
+    std::string filter;
+    std::vector<int32_t> shown;
+    int32_t filter_selected;
+    bool quiet_selection;
+
+    /// The matches are searched on the worker thread and come to the dropdown by chunks
+    std::mutex search_mutex;
+    std::condition_variable search_cv;
+    std::shared_ptr<const select_items_t> search_items;
+    std::string search_query;
+    uint64_t search_items_version;
+    std::atomic<uint64_t> search_generation;
+    bool search_pending, search_stopping;
+    std::thread search_worker;
+
+    trigram_index search_index; /// used by the worker only
+    uint64_t indexed_version;
+
+    std::shared_ptr<select*> alive; /// the posted chunks are dropped after the destruction
+
     void receive_control_events(const event &ev);
     void receive_plain_events(const event &ev);
 
@@ -138,6 +176,19 @@ private:
     void select_down();
 
     void show_list();
+    void hide_list();
+
+    select_items_t &own_items();
+    void items_changed();
+    void index_ids(int32_t from);
+    int32_t item_number(int32_t n_row) const;
+
+    /// The count of the dropdown rows, the shown items while filtered
+    int32_t row_count() const;
+
+    void update_filter(const std::string &filter_);
+    void filtered(uint64_t generation, const std::vector<int32_t> &numbers, bool first);
+    void search_work();
 
     void draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect_, list::item_state state);
     void activate_list_item(int32_t n_item);
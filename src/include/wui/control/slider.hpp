@@ -6,6 +6,7 @@
 #include <wui/event/event.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -86,13 +87,18 @@ private:
     int32_t from, to, value;
     std::function<void(int32_t)> change_callback;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_perform, tk_remain, tk_active, tk_slider_width, tk_slider_height, tk_slider_round };
+    static constexpr const char *theme_values[] = { tv_perform, tv_remain, tv_active, tv_slider_width, tv_slider_height, tv_slider_round };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
 
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     bool showed_, enabled_, topmost_;
     bool active, focused_;
@@ -6,6 +6,7 @@
 #include <wui/event/event.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <functional>
 #include <memory>
@@ -76,13 +77,18 @@ private:
     std::function<void(int32_t, int32_t)> callback;
     int32_t margin_min, margin_max;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_calm, tk_active };
+    static constexpr const char *theme_values[] = { tv_calm, tv_active };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
 
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     bool showed_, enabled_, active, topmost_, no_redraw;
 
@@ -6,6 +6,7 @@
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
 #include <wui/common/alignment.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -69,7 +70,12 @@ public:
     static constexpr const char *tv_font = "font";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_color, tk_font };
+    static constexpr const char *theme_values[] = { tv_color, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     rect position_;
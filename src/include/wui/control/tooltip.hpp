@@ -5,6 +5,7 @@
 #include <wui/graphic/graphic.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/color.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <string>
 #include <functional>
@@ -67,7 +68,12 @@ public:
     static constexpr const char *tv_font = "font";
 
 private:
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_border_width, tk_text, tk_text_indent, tk_round, tk_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_border_width, tv_text, tv_text_indent, tv_round, tv_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     std::string text;
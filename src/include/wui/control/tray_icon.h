@@ -52,7 +52,7 @@ private:
     std::string tip;
     std::function<void(tray_icon_action action)> click_callback;
 
-    std::string my_subscriber_id;
+    subscription_id my_subscriber_id;
 
     void receive_event(const event &ev);
 
@@ -20,6 +20,9 @@ enum class event_type : uint32_t
     all = system | mouse | keyboard | internal
 };
 
+/// Handle of the event subscription: the subscriber slot in the low half and the slot generation in the high one
+using subscription_id = uint64_t;
+
 struct event
 {
     event_type type;
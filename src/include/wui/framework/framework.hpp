@@ -4,6 +4,10 @@
 
 #include <wui/common/error.hpp>
 
+#include <functional>
+#include <vector>
+#include <cstdint>
+
 namespace wui
 {
 
@@ -17,6 +21,14 @@ void stop();
 
 bool runned();
 
+/// Runs the task on the UI thread, can be called from any thread. The batch is queued at once and runs in order
+void post(std::function<void(void)> task);
+void post(std::vector<std::function<void(void)>> tasks);
+
+/// The application timers on the single scheduler thread, the callbacks are called on the UI thread while the framework runs
+uint64_t start_timer(uint32_t interval, std::function<void(void)> callback);
+void stop_timer(uint64_t timer_id);
+
 error get_error();
 
 }
@@ -2,6 +2,10 @@
 #pragma once
 
 #include <wui/framework/i_framework.hpp>
+#include <wui/framework/timer_scheduler.hpp>
+#include <wui/framework/task_queue.hpp>
+
+#include <windows.h>
 
 #include <cstdint>
 #include <string>
@@ -16,7 +20,7 @@ namespace framework
 class framework_win_impl : public i_framework
 {
 public:
-    framework_win_impl();
+    framework_win_impl(task_queue &tasks, timer_scheduler &scheduler);
 
     virtual void run();
     virtual void stop();
@@ -28,6 +32,14 @@ public:
 private:
     bool runned_;
 
+    task_queue &tasks;
+    timer_scheduler &scheduler;
+
+    /// Message-only window receiving the wake ups of the task queue, it works in the modal loops too
+    HWND message_wnd;
+
+    static LRESULT CALLBACK message_proc(HWND hwnd, UINT message, WPARAM w_param, LPARAM l_param);
+
     error err;
 };
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+
+namespace wui
+{
+
+namespace framework
+{
+
+/// Lock free multiple producers single consumer queue of the tasks for the UI thread.
+/// The producers push to the intrusive stack by one CAS, the consumer takes the whole stack by one exchange.
+/// The waker is called once until the consumer runs the tasks, so the flood of posts makes one wake up
+class task_queue
+{
+public:
+    task_queue();
+    ~task_queue();
+
+    void push(std::function<void(void)> task);
+    void push(std::vector<std::function<void(void)>> tasks);
+
+    /// Runs the queued tasks in the order of pushing, call from the consumer thread only. Returns the count of the tasks
+    size_t run();
+
+    void set_waker(std::function<void(void)> waker);
+
+    task_queue(const task_queue&) = delete;
+    task_queue& operator=(const task_queue&) = delete;
+
+private:
+    struct node
+    {
+        std::function<void(void)> task;
+        node *next;
+    };
+
+    std::atomic<node*> head;
+    std::atomic<bool> wake_pending;
+
+    std::mutex waker_mutex;
+    std::function<void(void)> waker;
+
+    void push_chain(node *first, node *last);
+};
+
+}
+
+}
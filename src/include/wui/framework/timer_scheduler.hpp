@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+namespace wui
+{
+
+namespace framework
+{
+
+/// Keeps the deadlines of all the application timers and sleeps on one thread until the nearest of them.
+/// While the waker is set (the framework runs) the fired timers are queued, the waker is called once
+/// per batch and the UI thread runs the callbacks by run_fired(). Without the waker the callbacks run on the scheduler thread
+class timer_scheduler
+{
+public:
+    timer_scheduler();
+    ~timer_scheduler();
+
+    /// Returns the timer id, the callback is called each interval milliseconds
+    uint64_t start(uint32_t interval, std::function<void(void)> callback);
+
+    /// After the return the callback is not called, the timer can be stopped from its own callback
+    void stop(uint64_t timer_id);
+
+    void set_waker(std::function<void(void)> waker);
+
+    void run_fired();
+
+    timer_scheduler(const timer_scheduler&) = delete;
+    timer_scheduler& operator=(const timer_scheduler&) = delete;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct entry
+    {
+        std::shared_ptr<std::function<void(void)>> callback;
+        std::chrono::milliseconds interval;
+        clock::time_point deadline;
+        bool fired;
+    };
+
+    std::mutex mutex_;
+    std::condition_variable cv, running_cv;
+
+    std::unordered_map<uint64_t, entry> entries;
+    std::set<std::pair<clock::time_point, uint64_t>> deadlines;
+    std::vector<uint64_t> fired;
+
+    std::function<void(void)> waker;
+    bool wake_pending;
+
+    uint64_t next_id, running_id;
+    std::thread::id running_thread;
+
+    bool stopping;
+    std::thread thread;
+
+    void run();
+    void call(uint64_t timer_id, std::unique_lock<std::mutex> &lock);
+};
+
+}
+
+}
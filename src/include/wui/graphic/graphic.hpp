@@ -1,22 +1,32 @@
-
-
 #pragma once
 
 #include <wui/system/system_context.hpp>
 
 #include <wui/common/color.hpp>
 #include <wui/common/rect.hpp>
+#include <wui/common/point.hpp>
 #include <wui/common/font.hpp>
 #include <wui/common/error.hpp>
 
+#include <wui/graphic/text_measure_cache.hpp>
+
+#ifdef _WIN32
 #include <wui/graphic/primitive_container.hpp>
+#elif __linux__
+#include <cairo.h>
+#endif
 
 #include <string_view>
+#include <vector>
+#include <memory>
 #include <cstdint>
 
 namespace wui
 {
 
+class surface_pool;
+class cached_image;
+
 class graphic
 {
 public:
@@ -36,7 +46,14 @@ public:
 
     void draw_line(const rect &position, color color_, uint32_t width = 1);
 
+    /// Connected segments through the points drawn by one call (one path on cairo) with one pen
+    void draw_polyline(const std::vector<point> &points, color color_, uint32_t width = 1);
+
+    /// The results are cached for all graphics, see set_text_measure_budget()
     rect measure_text(std::string_view text, const font &font_);
+
+    /// The unrounded advance of the text, to sum the widths of the text parts without the rounding drift
+    double measure_advance(std::string_view text, const font &font_);
     void draw_text(const rect &position, std::string_view text, color color_, const font &font_);
 
     void draw_rect(const rect &position, color fill_color);
@@ -48,23 +65,85 @@ public:
     /// draw another graphic on context
     void draw_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift);
 
+    /// Alpha blit of the cached image, it is stretched only if its size differs from the position
+    void draw_image(const rect &position, const cached_image &image_);
+
+    /// Returns a reusable offscreen graphic of at least the given size filled by the background color.
+    /// It shares fonts, pens and brushes with this graphic and returns to the pool when the pointer is released,
+    /// so keep it only while drawing
+    std::shared_ptr<graphic> offscreen(const rect &size, color background_color);
+
+    /// Returns an offscreen graphic owned by the caller, for the content kept between the paints.
+    /// It must not outlive this graphic
+    std::unique_ptr<graphic> make_offscreen(const rect &size, color background_color);
+
+    /// Limits the drawing to the intersection of the position with the current clip until pop_clip()
+    void push_clip(const rect &position);
+    void pop_clip();
+
+    /// The current clip, the whole graphic if nothing is pushed
+    rect clip() const;
+
+    /// True if nothing drawn at the position gets through the clip, so the drawing can be skipped
+    bool clipped(const rect &position) const;
+
+    /// Moves the pixels inside the area by dy (positive is down), the exposed band keeps the old pixels
+    void scroll(const rect &area, int32_t dy);
+
+#ifdef _WIN32
     HDC drawable();
+#elif __linux__
+    cairo_t *drawable();
+
+    /// The in-memory ARGB32 frame. Works without a display server (context_.display == nullptr),
+    /// in this case flush() does nothing and the frame can be read from here
+    const uint8_t *pixels();
+    int32_t stride() const;
+#endif
 
     error get_error() const;
 
+    static text_measure_statistics get_text_measure_statistics();
+    static void reset_text_measure_statistics();
+    static void set_text_measure_budget(size_t bytes);
+
 private:
     system_context &context_;
 
-    primitive_container pc;
+#ifdef _WIN32
+    std::shared_ptr<primitive_container> pc;
+    bool shared_primitives;
+#endif
+
+    std::unique_ptr<surface_pool> pool;
 
     rect max_size;
 
     color background_color;
 
+    std::vector<rect> clips;
+
+#ifdef _WIN32
     HDC mem_dc;
     HBITMAP mem_bitmap;
+#elif __linux__
+    cairo_surface_t *surface;
+    cairo_t *cr;
+
+    xcb_gcontext_t gc;
+#endif
 
     error err;
+
+#ifdef _WIN32
+    graphic(system_context &context, std::shared_ptr<primitive_container> pc);
+#endif
+
+    std::unique_ptr<graphic> make_compatible();
+
+    void apply_clip();
+
+    friend class surface_pool;
 };
 
 }
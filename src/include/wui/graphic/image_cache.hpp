@@ -0,0 +1,161 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif __linux__
+#include <cairo.h>
+#endif
+
+namespace wui
+{
+
+/// Where the image is decoded from
+struct image_source
+{
+    enum class kind
+    {
+        none,
+        file,
+        resource,
+        data
+    };
+
+    kind kind_ = kind::none;
+
+    std::string path;              /// file path or resource section
+    int32_t resource_index = 0;
+    std::vector<uint8_t> data;     /// encoded image bytes
+
+    std::string key() const;
+
+    static image_source from_file(std::string_view path);
+    static image_source from_resource(int32_t resource_index, std::string_view resource_section);
+    static image_source from_data(const std::vector<uint8_t> &data);
+    static image_source from_data(const uint8_t *data, size_t size);
+};
+
+/// Decoded image scaled to the target size, the pixels are premultiplied 32 bpp BGRA,
+/// so painting it is a plain alpha blit. Immutable and shared by all the controls showing it
+class cached_image
+{
+public:
+    ~cached_image();
+
+    int32_t width() const;
+    int32_t height() const;
+
+    /// The size of the decoded source before the scaling
+    int32_t source_width() const;
+    int32_t source_height() const;
+
+    size_t bytes() const;
+
+#ifdef _WIN32
+    HBITMAP bitmap() const;
+#elif __linux__
+    cairo_surface_t *surface() const;
+#endif
+
+private:
+    int32_t width_, height_, source_width_, source_height_;
+
+#ifdef _WIN32
+    HBITMAP bitmap_;
+#elif __linux__
+    cairo_surface_t *surface_;
+#endif
+
+    cached_image();
+
+    friend class image_cache;
+};
+
+struct image_cache_statistics
+{
+    uint64_t hits, misses, evictions, decode_errors;
+    size_t used_bytes, byte_budget;
+};
+
+/// Process-wide cache of the decoded images keyed by the source and the target size.
+/// Above the budget the least recently used images are dropped, but only those not held by any control
+class image_cache
+{
+public:
+    explicit image_cache(size_t byte_budget = 16 * 1024 * 1024);
+    ~image_cache();
+
+    /// Zero width or height means the source size. Decoding runs without the lock,
+    /// returns nullptr if the source can't be decoded
+    std::shared_ptr<cached_image> get(const image_source &source, int32_t width = 0, int32_t height = 0);
+
+    /// Returns the cached image without decoding, nullptr if it is not decoded yet
+    std::shared_ptr<cached_image> find(const image_source &source, int32_t width = 0, int32_t height = 0);
+
+    /// Decodes on the worker threads. The callback is called at once if the image is cached,
+    /// otherwise on the worker thread, the requests of the same image share one decoding
+    void get_async(const image_source &source, int32_t width, int32_t height, std::function<void(std::shared_ptr<cached_image>)> done);
+
+    /// Decodes the images on the worker threads to have them ready for the first paint
+    void prefetch(const std::vector<image_source> &sources);
+
+    void set_byte_budget(size_t byte_budget);
+
+    void clear();
+
+    image_cache_statistics statistics() const;
+
+private:
+    struct entry
+    {
+        std::string key;
+        std::shared_ptr<cached_image> image;
+    };
+
+    using entries_t = std::list<entry>;
+
+    mutable std::mutex mutex_;
+
+    entries_t entries;
+    std::unordered_map<std::string, entries_t::iterator> index;
+
+    image_cache_statistics statistics_;
+
+    struct job
+    {
+        std::string key;
+        image_source source;
+        int32_t width, height;
+    };
+
+    std::deque<job> jobs;
+    std::unordered_map<std::string, std::vector<std::function<void(std::shared_ptr<cached_image>)>>> in_flight;
+    std::condition_variable jobs_condition;
+    std::vector<std::thread> workers;
+    bool stopping;
+
+    static std::string make_key(const image_source &source, int32_t width, int32_t height);
+
+    std::shared_ptr<cached_image> decode(const image_source &source, int32_t width, int32_t height);
+    std::shared_ptr<cached_image> insert(const std::string &key, std::shared_ptr<cached_image> img);
+    void shrink();
+
+    void work();
+};
+
+/// The cache used by the image controls
+image_cache &get_image_cache();
+
+}
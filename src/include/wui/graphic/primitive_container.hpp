@@ -1,6 +1,8 @@
 
 #pragma once
 
+#ifdef _WIN32
+
 #include <wui/common/color.hpp>
 #include <wui/common/rect.hpp>
 #include <wui/common/font.hpp>
@@ -43,3 +45,5 @@ private:
 };
 
 }
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <wui/common/rect.hpp>
+#include <wui/common/color.hpp>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+class graphic;
+
+/// Keeps the offscreen graphics of the owner graphic to reuse them between the paints.
+/// The surfaces are matched by the size class (the size rounded up to 64 pixels),
+/// above max_surfaces the least recently used free surface is dropped
+class surface_pool
+{
+public:
+    surface_pool(graphic &owner, size_t max_surfaces = 8);
+    ~surface_pool();
+
+    std::shared_ptr<graphic> get(const rect &size, color background_color);
+
+    void release();
+
+private:
+    graphic &owner;
+
+    size_t max_surfaces;
+
+    struct surface
+    {
+        std::unique_ptr<graphic> graphic_;
+        int32_t width_class, height_class;
+        bool in_use;
+        uint64_t last_use;
+    };
+
+    /// The handles given by get() share the surface, so release() does not free the drawing ones
+    std::vector<std::shared_ptr<surface>> surfaces;
+
+    uint64_t use_counter;
+
+    void drop_unused();
+};
+
+}
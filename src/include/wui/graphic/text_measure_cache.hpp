@@ -0,0 +1,62 @@
+#pragma once
+
+#include <wui/common/rect.hpp>
+#include <wui/common/font.hpp>
+
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+struct text_measure_statistics
+{
+    uint64_t hits, misses, evictions;
+    size_t used_bytes, byte_budget;
+};
+
+/// LRU cache of the measure_text results keyed by the font and the text.
+/// The entries are evicted from the least recently used when the bytes used by them exceed the budget
+class text_measure_cache
+{
+public:
+    explicit text_measure_cache(size_t byte_budget = 256 * 1024);
+
+    bool find(std::string_view text, const font &font_, rect &size);
+    void put(std::string_view text, const font &font_, const rect &size);
+
+    void set_byte_budget(size_t byte_budget);
+
+    void clear();
+
+    text_measure_statistics statistics() const;
+    void reset_statistics();
+
+private:
+    struct entry
+    {
+        uint64_t hash;
+        std::string text;
+        font font_;
+        rect size;
+    };
+
+    using entries_t = std::list<entry>;
+
+    mutable std::mutex mutex_;
+
+    entries_t entries;
+    std::unordered_multimap<uint64_t, entries_t::iterator> index;
+
+    text_measure_statistics statistics_;
+
+    entries_t::iterator lookup(uint64_t hash, std::string_view text, const font &font_);
+    void shrink();
+};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <wui/common/font.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+class graphic;
+
+/// Keeps the advance of each codepoint of a single line text and the prefix widths summed from them.
+/// insert() and erase() follow the text edits, the new codepoints are measured on the next update(),
+/// so the width of any prefix and the caret hit test are the binary searches
+class text_width_index
+{
+public:
+    text_width_index();
+
+    /// The text was replaced, everything will be measured on the next update()
+    void reset();
+
+    /// Call after the text changed, position and length are in bytes
+    void insert(const std::string &text, size_t position, size_t length);
+    void erase(size_t position, size_t length);
+
+    /// Measures the new codepoints, rebuilds the index if the font or the text was changed
+    void update(graphic &gr, const std::string &text, const font &font_);
+
+    /// Width of the first byte_count bytes, the incomplete codepoint is not counted
+    int32_t width(size_t byte_count) const;
+
+    /// Byte position of the first codepoint boundary at x or righter
+    size_t position(int32_t x) const;
+
+private:
+    std::vector<size_t> codepoint_ends;
+    std::vector<double> advances, prefix_widths; /// unrounded, only the prefix sums are rounded
+
+    font font_;
+    bool valid;
+    size_t dirty_from;
+
+    bool boundary(size_t position, size_t &codepoint) const;
+    void parse(const std::string &text, size_t begin, size_t end, std::vector<size_t> &ends) const;
+};
+
+}
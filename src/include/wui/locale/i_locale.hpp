@@ -19,14 +19,22 @@ public:
     virtual std::string get_name() const = 0;
 
     virtual void set(std::string_view section, std::string_view value, std::string_view str) = 0;
+    /// The bundle's string is copied to the locale at its first request
     virtual const std::string &get(std::string_view section, std::string_view value) const = 0;
 
+    /// The string without the copy, the bundle's strings point into the mapped file.
+    /// The view is valid until the next load or until the value is set again
+    virtual std::string_view get_view(std::string_view section, std::string_view value) const = 0;
+
 
     virtual void load_resource(int32_t resource_index, std::string_view resource_section) = 0;
     virtual void load_json(std::string_view json) = 0;
     virtual void load_file(std::string_view file_name) = 0;
     virtual void load_locale(const i_locale &locale_) = 0;
 
+    /// Map the precompiled bundle and take the part with the locale name, without parsing
+    virtual void load_bundle(std::string_view file_name, std::string_view part) = 0;
+
     virtual error get_error() const = 0;
 
     virtual ~i_locale() {}
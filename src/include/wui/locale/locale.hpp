@@ -13,6 +13,8 @@ namespace wui
 bool set_locale_from_resource(locale_type type, std::string_view name, int32_t resource_index, std::string_view resource_section);
 bool set_locale_from_json(locale_type type, std::string_view name, std::string_view json);
 bool set_locale_from_file(locale_type type, std::string_view name, std::string_view file_name);
+/// Load the part with the locale name from the bundle made by the bundle compiler
+bool set_locale_from_bundle(locale_type type, std::string_view name, std::string_view file_name);
 void set_locale_empty(locale_type type, std::string_view name);
 
 /// Load locale from regsitry on Windows or from file on other systems
@@ -30,4 +32,7 @@ void set_locale_value(std::string_view section, std::string_view value, std::str
 /// Return the item's string value by current locale
 const std::string &locale(std::string_view section, std::string_view value);
 
+/// The same without the copy, see i_locale::get_view()
+std::string_view locale_view(std::string_view section, std::string_view value);
+
 }
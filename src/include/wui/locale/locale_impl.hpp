@@ -5,10 +5,15 @@
 #include <wui/locale/i_locale.hpp>
 
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace wui
 {
 
+class bundle;
+struct bundle_item;
+
 class locale_impl : public i_locale
 {
 public:
@@ -19,11 +24,13 @@ public:
 
     virtual void set(std::string_view section, std::string_view value, std::string_view str);
     virtual const std::string &get(std::string_view section, std::string_view value) const;
+    virtual std::string_view get_view(std::string_view section, std::string_view value) const;
 
     virtual void load_resource(int32_t resource_index, std::string_view resource_section);
     virtual void load_json(std::string_view json);
     virtual void load_file(std::string_view file_name);
     virtual void load_locale(const i_locale &locale_);
+    virtual void load_bundle(std::string_view file_name, std::string_view part);
 
     virtual error get_error() const;
 
@@ -31,11 +38,18 @@ private:
     locale_type type;
     std::string name;
 
-    std::map<std::pair<std::string, std::string>, std::string> strings;
+    /// get() copies the bundle's strings here at their first request
+    mutable std::map<std::pair<std::string, std::string>, std::string> strings;
+
+    /// The bundle's strings are used in place in the mapped file.
+    /// The bundles with their parts, the last loaded is searched first
+    std::vector<std::pair<std::shared_ptr<bundle>, std::string>> strings_bundles;
 
     std::string dummy_string;
 
     error err;
+
+    bool find_bundle_string(std::string_view section, std::string_view value, bundle_item &item) const;
 };
 
 }
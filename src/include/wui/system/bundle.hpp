@@ -0,0 +1,100 @@
+#pragma once
+
+#include <wui/common/error.hpp>
+#include <wui/system/mapped_file.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+namespace wui
+{
+
+/// Precompiled themes and locales bundle.
+/// The file is mapped into memory and used in place: the header, the hash buckets,
+/// the entries sorted by bucket and the data area with the keys, strings and image bytes.
+/// Every entry key is "part\0section\0value", the part is the theme or locale name,
+/// the images are stored with the empty section.
+
+enum class bundle_kind : uint16_t
+{
+    integer = 1,
+    string,
+    font,
+    image
+};
+
+struct bundle_item
+{
+    bundle_kind kind;
+    std::string_view part, section, value;
+    std::string_view data;   /// string, font name or image bytes, points into the mapped file
+    int32_t number;          /// integer value or font size
+    uint16_t flags;          /// font decorations
+};
+
+class bundle
+{
+public:
+    bundle();
+    ~bundle();
+
+    bool open(std::string_view file_name);
+    void close();
+
+    bool find(std::string_view part, std::string_view section, std::string_view value, bundle_item &item) const;
+
+    /// Calls the visitor for each item of the part, the items are valid while the bundle is open
+    void visit(std::string_view part, std::function<void(const bundle_item&)> visitor) const;
+
+    error get_error() const;
+
+private:
+    mapped_file file;
+
+    const uint8_t *data;
+    size_t size;
+
+    error err;
+
+    bool validate();
+    bundle_item item(uint32_t index) const;
+
+    bundle(const bundle&) = delete;
+    bundle& operator=(const bundle&) = delete;
+};
+
+/// Build-time writer used by the bundle compiler
+class bundle_writer
+{
+public:
+    bundle_writer();
+
+    void add_integer(std::string_view part, std::string_view section, std::string_view value, int32_t number);
+    void add_string(std::string_view part, std::string_view section, std::string_view value, std::string_view str);
+    void add_font(std::string_view part, std::string_view section, std::string_view value, std::string_view name, int32_t size, uint16_t decorations);
+    void add_image(std::string_view part, std::string_view name, const std::vector<uint8_t> &image);
+
+    std::vector<uint8_t> build() const;
+    bool save(std::string_view file_name) const;
+
+private:
+    struct record
+    {
+        bundle_kind kind;
+        std::string key;
+        std::string data;
+        int32_t number;
+        uint16_t flags;
+    };
+
+    std::vector<record> records;
+    std::unordered_map<std::string, size_t> record_indices; /// by the record key, to replace the value added twice
+
+    void add(bundle_kind kind, std::string_view part, std::string_view section, std::string_view value, std::string_view data, int32_t number, uint16_t flags);
+};
+
+}
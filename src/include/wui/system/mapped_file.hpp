@@ -0,0 +1,45 @@
+#pragma once
+
+#include <wui/common/error.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace wui
+{
+
+/// Read only file mapped into memory, the pages are loaded by the system when they are touched
+class mapped_file
+{
+public:
+    mapped_file();
+    ~mapped_file();
+
+    /// sequential is for the files read from the start to the end, the system reads ahead and drops the read pages
+    bool open(std::string_view file_name, bool sequential = false);
+    void close();
+
+    /// nullptr if the file is not open or empty
+    const char *data() const;
+    uint64_t size() const;
+
+    error get_error() const;
+
+private:
+    const char *data_;
+    uint64_t size_;
+
+#ifdef _WIN32
+    void *file, *mapping;
+#elif __linux__
+    int file;
+#endif
+
+    error err;
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+};
+
+}
@@ -1,27 +1,20 @@
-
 #pragma once
 
-#ifndef _WIN32
-#include <chrono>
-#include <thread>
-#else
-#include <windows.h>
-#endif
+#include <wui/framework/framework.hpp>
 
-#include <atomic>
 #include <functional>
-#include <exception>
 #include <cstdint>
 
 namespace wui
 {
 
-#ifndef _WIN32
+/// Periodic timer on the framework's timer scheduler, so all the timers share one thread
+/// and the callback is called on the UI thread while the framework runs
 class timer
 {
 public:
 	explicit timer(std::function<void(void)> callback_)
-		: runned(false), thread(), callback(callback_), interval(1000)
+		: callback(callback_), timer_id(0)
 	{
 	}
 
@@ -30,109 +23,22 @@ public:
 		stop();
 	}
 
-	void start(const uint32_t interval_ = 1000 /* in milliseconds */)
+	void start(const uint32_t interval = 1000 /* in milliseconds */)
 	{
-		if (!runned)
+		if (timer_id == 0)
 		{
-			interval = interval_;
-			runned = true;
-
-			thread = std::thread(&timer::run, this);
+			timer_id = framework::start_timer(interval, callback);
 		}
 	}
 
 	void stop()
 	{
-		if (runned)
+		if (timer_id != 0)
 		{
-			runned = false;
-			if (thread.joinable()) thread.join();
+			framework::stop_timer(timer_id);
+			timer_id = 0;
 		}
 	}
-	
-	timer(const timer&) = delete;
-	timer& operator=(const timer&) = delete;
-
-private:
-	std::atomic<bool> runned;
-	std::thread thread;
-	std::function<void(void)> callback;
-
-	uint32_t interval;
-
-	void run()
-	{
-	    auto begin = std::chrono::high_resolution_clock::now();
-
-		while (runned)
-		{
-			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - begin).count();
-			if (elapsed > interval * 1000)
-			{
-			    callback();
-			    begin = std::chrono::high_resolution_clock::now();
-			}
-			else
-			{
-			    std::this_thread::sleep_for(std::chrono::microseconds(100));
-			}
-		}
-	}
-};
-#else
-class timer
-{
-public:
-	explicit timer(std::function<void(void)> callback_)
-		: callback(callback_), h_timer(nullptr), h_timer_queue(nullptr), runned(false)
-	{
-	}
-
-	~timer()
-	{
-		stop();
-	}
-
-	void start(const uint32_t interval = 1000)
-	{
-		if (runned || h_timer_queue)
-		{
-			return;
-		}
-		
-        h_timer_queue = CreateTimerQueue();
-		if (!h_timer_queue)
-		{
-			throw std::exception("Error CreateTimerQueue()");
-		}
-
-		if (!CreateTimerQueueTimer(&h_timer, h_timer_queue,
-			(WAITORTIMERCALLBACK)TimerRoutine, this, 0, interval, WT_EXECUTEDEFAULT))
-		{
-			throw std::exception("Error CreateTimerQueueTimer()");
-		}
-		runned = true;
-	}
-
-	void stop()
-	{
-		if (!runned)
-		{
-			return;
-		}
-				
-		if (h_timer && h_timer_queue)
-		{
-			DeleteTimerQueueTimer(h_timer_queue, h_timer, INVALID_HANDLE_VALUE);
-            h_timer = nullptr;
-		}
-		if (h_timer_queue)
-		{
-			DeleteTimerQueue(h_timer_queue);
-            h_timer_queue = nullptr;
-		}
-		runned = false;
-	}
 
 	timer(const timer&) = delete;
 	timer& operator=(const timer&) = delete;
@@ -140,16 +46,7 @@ public:
 private:
 	std::function<void(void)> callback;
 
-	HANDLE h_timer;
-    HANDLE h_timer_queue;
-
-	std::atomic<bool> runned;
-	
-	static VOID CALLBACK TimerRoutine(PVOID lpParam, BOOLEAN)
-	{
-		static_cast<timer*>(lpParam)->callback();
-	}
+	uint64_t timer_id;
 };
-#endif
 
 }
@@ -5,6 +5,7 @@
 #include <wui/common/color.hpp>
 #include <wui/common/font.hpp>
 #include <wui/common/error.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <cstdint>
 #include <string>
@@ -28,16 +29,30 @@ public:
     virtual const std::string &get_string(std::string_view control, std::string_view value) const = 0;
 
     virtual void set_font(std::string_view control, std::string_view value, const font &font_) = 0;
-    virtual font get_font(std::string_view control, std::string_view value) const = 0;
+    virtual const font &get_font(std::string_view control, std::string_view value) const = 0;
+
+    /// Lookups by the interned key, it is an array index without a strings comparison
+    virtual color get_color(theme_key key) const = 0;
+    virtual int32_t get_dimension(theme_key key) const = 0;
+    virtual const std::string &get_string(theme_key key) const = 0;
+    virtual const font &get_font(theme_key key) const = 0;
 
     virtual void set_image(std::string_view name, const std::vector<uint8_t> &data) = 0;
+    /// The bundle's image is copied to the theme at its first request
     virtual const std::vector<uint8_t> &get_image(std::string_view name) = 0;
 
+    /// The image bytes without the copy, the bundle's images point into the mapped file.
+    /// The view is valid until the next load or until the image is set again
+    virtual std::string_view get_image_view(std::string_view name) const = 0;
+
     virtual void load_resource(int32_t resource_index, std::string_view resource_section) = 0;
     virtual void load_json(std::string_view json) = 0;
     virtual void load_file(std::string_view file_name) = 0;
     virtual void load_theme(const i_theme &theme_) = 0;
 
+    /// Map the precompiled bundle and take the part with the theme name, without parsing
+    virtual void load_bundle(std::string_view file_name, std::string_view part) = 0;
+
     virtual error get_error() const = 0;
 
     virtual ~i_theme() {}
@@ -12,6 +12,8 @@ namespace wui
 bool set_default_theme_from_resource(std::string_view name, int32_t resource_index, std::string_view resource_section);
 bool set_default_theme_from_json(std::string_view name, std::string_view json);
 bool set_default_theme_from_file(std::string_view name, std::string_view file_name);
+/// Load the part with the theme name from the bundle made by the bundle compiler
+bool set_default_theme_from_bundle(std::string_view name, std::string_view file_name);
 void set_default_theme_empty(std::string_view name);
 
 /// Load theme from regsitry on Windows or from file on other systems
@@ -38,8 +40,17 @@ int32_t theme_dimension(std::string_view control, std::string_view value, std::s
 const std::string &theme_string(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_ = nullptr);
 
 /// Return the item's font value by current theme
-font theme_font(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_ = nullptr);
+const font &theme_font(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_ = nullptr);
+
+/// The same by the key resolved once by make_theme_key() or theme_keys, used on the paint paths
+color theme_color(theme_key key, const std::shared_ptr<i_theme> &theme_ = nullptr);
+int32_t theme_dimension(theme_key key, const std::shared_ptr<i_theme> &theme_ = nullptr);
+const std::string &theme_string(theme_key key, const std::shared_ptr<i_theme> &theme_ = nullptr);
+const font &theme_font(theme_key key, const std::shared_ptr<i_theme> &theme_ = nullptr);
 
 const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i_theme> theme_ = nullptr);
 
+/// The image bytes without the copy, see i_theme::get_image_view()
+std::string_view theme_image_view(std::string_view name, std::shared_ptr<i_theme> theme_ = nullptr);
+
 }
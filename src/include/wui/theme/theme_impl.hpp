@@ -5,10 +5,15 @@
 #include <wui/theme/i_theme.hpp>
 
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace wui
 {
 
+class bundle;
+struct bundle_item;
+
 class theme_impl : public i_theme
 {
 public:
@@ -26,10 +31,16 @@ public:
     virtual const std::string &get_string(std::string_view control, std::string_view value) const;
 
     virtual void set_font(std::string_view control, std::string_view value, const font &font_);
-    virtual font get_font(std::string_view control, std::string_view value) const;
+    virtual const font &get_font(std::string_view control, std::string_view value) const;
+
+    virtual color get_color(theme_key key) const;
+    virtual int32_t get_dimension(theme_key key) const;
+    virtual const std::string &get_string(theme_key key) const;
+    virtual const font &get_font(theme_key key) const;
 
     virtual void set_image(std::string_view name, const std::vector<uint8_t> &data);
     virtual const std::vector<uint8_t> &get_image(std::string_view name);
+    virtual std::string_view get_image_view(std::string_view name) const;
 
 #ifdef _WIN32
     virtual void load_resource(int32_t resource_index, std::string_view resource_section);
@@ -37,21 +48,33 @@ public:
     virtual void load_json(std::string_view json);
     virtual void load_file(std::string_view file_name);
     virtual void load_theme(const i_theme &theme_);
+    virtual void load_bundle(std::string_view file_name, std::string_view part);
 
     virtual error get_error() const;
 
 private:
     std::string name;
 
-    std::map<std::pair<std::string, std::string>, int32_t> ints;
-    std::map<std::pair<std::string, std::string>, std::string> strings;
-    std::map<std::pair<std::string, std::string>, font> fonts;
+    /// Values indexed by theme_key, the missing values are zero, empty string and default font
+    std::vector<int32_t> ints;
+    std::vector<std::string> strings;
+    std::vector<font> fonts;
     std::map<std::string, std::vector<uint8_t>> imgs;
 
+    /// The bundle's images are used in place in the mapped file, get_image() copies them to imgs.
+    /// The bundles with their parts, the last loaded is searched first
+    std::vector<std::pair<std::shared_ptr<bundle>, std::string>> images_bundles;
+
     std::string dummy_string;
+    font dummy_font;
     std::vector<uint8_t> dummy_image;
 
     error err;
+
+    bool find_bundle_image(std::string_view name, bundle_item &item) const;
+
+    template<typename T>
+    static void store(std::vector<T> &values, theme_key key, const T &value);
 };
 
 }
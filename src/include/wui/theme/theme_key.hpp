@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wui
+{
+
+/// Dense index of the theme's (control, value) pair, the themes keep their values in arrays by this index
+using theme_key = uint32_t;
+
+/// Return the key of the pair, the pair is interned at the first call and keeps its key for the process lifetime.
+/// Called when a value is set and when a control resolves its values, not on the lookups
+theme_key make_theme_key(std::string_view control, std::string_view value);
+
+/// Return false if the pair was never interned, so no theme has its value. Does not intern the pair
+bool find_theme_key(std::string_view control, std::string_view value, theme_key &key);
+
+/// Return the count of interned keys, all keys are less than it
+theme_key theme_keys_count();
+
+/// The keys of one control's values, resolved at the construction and after the control's theme name changed.
+/// The values are the control's tv_ constants listed in the order of its theme_value enum,
+/// so a lookup is the array index
+class theme_keys
+{
+public:
+    template<size_t N>
+    theme_keys(const std::string &control_, const char *const (&values_)[N])
+        : control(control_),
+        values(values_),
+        keys(N)
+    {
+        reset();
+    }
+
+    theme_key operator[](size_t value) const
+    {
+        return keys[value];
+    }
+
+    /// Must be called after the control's theme name changed
+    void reset();
+
+private:
+    const std::string &control;
+    const char *const *values;
+    std::vector<theme_key> keys;
+};
+
+}
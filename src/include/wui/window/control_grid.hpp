@@ -0,0 +1,41 @@
+#pragma once
+
+#include <wui/common/rect.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace wui
+{
+
+/// Uniform grid over the window's controls for the hit tests and the paint culling.
+/// The controls are identified by their z-order and the queries return them in this order.
+/// The controls covering too many cells are kept aside and checked by every query
+class control_grid
+{
+public:
+    explicit control_grid(int32_t cell_size = 64, int32_t max_cells_per_control = 256);
+
+    void clear();
+
+    /// The controls are inserted from the back to the front
+    void insert(int32_t order, const rect &position);
+
+    /// The controls containing the point
+    void query(int32_t x, int32_t y, std::vector<int32_t> &orders) const;
+
+    /// The controls overlapping the area
+    void query(const rect &area, std::vector<int32_t> &orders) const;
+
+private:
+    int32_t cell_size, max_cells_per_control;
+
+    std::vector<rect> positions;
+    std::unordered_map<uint64_t, std::vector<int32_t>> cells;
+    std::vector<int32_t> large_controls;
+
+    int32_t cell(int32_t coordinate) const;
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <wui/common/rect.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace wui
+{
+
+struct damage_statistics
+{
+    uint64_t submitted_rects, painted_rects;
+};
+
+/// Accumulates the window's invalidated rects between two paints.
+/// Overlapping and adjacent rects are merged, above max_rects the region collapses to its bounding box
+class damage_region
+{
+public:
+    explicit damage_region(size_t max_rects = 16);
+
+    void add(const rect &damaged_rect);
+
+    bool empty() const;
+    const std::vector<rect> &rects() const;
+    rect bounds() const;
+
+    /// Returns the accumulated rects, which are counted as painted, and empties the region
+    std::vector<rect> flush();
+
+    damage_statistics statistics() const;
+    void reset_statistics();
+
+private:
+    size_t max_rects;
+
+    std::vector<rect> rects_;
+
+    damage_statistics statistics_;
+};
+
+}
@@ -54,8 +54,8 @@ public:
 
     virtual void redraw(const rect &position, bool clear = false) = 0;
 
-    virtual std::string subscribe(std::function<void(const event&)> receive_callback, event_type event_types, std::shared_ptr<i_control> control = nullptr) = 0;
-    virtual void unsubscribe(std::string_view subscriber_id) = 0;
+    virtual subscription_id subscribe(std::function<void(const event&)> receive_callback, event_type event_types, std::shared_ptr<i_control> control = nullptr) = 0;
+    virtual void unsubscribe(subscription_id id) = 0;
 
     virtual system_context &context() = 0;
 
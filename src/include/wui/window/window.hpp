@@ -1,12 +1,18 @@
 #pragma once
 
 #include <wui/window/i_window.hpp>
+#include <wui/window/damage_region.hpp>
+#include <wui/window/control_grid.hpp>
 #include <wui/system/system_context.hpp>
 #include <wui/control/i_control.hpp>
 #include <wui/graphic/graphic.hpp>
 #include <wui/common/rect.hpp>
+#include <wui/theme/theme_key.hpp>
 
 #include <vector>
+#include <deque>
+#include <array>
+#include <unordered_map>
 #include <memory>
 
 #include <thread>
@@ -51,8 +57,8 @@ public:
 
     virtual void redraw(const rect &position, bool clear = false);
 
-    virtual std::string subscribe(std::function<void(const event&)> receive_callback, event_type event_types, std::shared_ptr<i_control> control = nullptr);
-    virtual void unsubscribe(std::string_view subscriber_id);
+    virtual subscription_id subscribe(std::function<void(const event&)> receive_callback, event_type event_types, std::shared_ptr<i_control> control = nullptr);
+    virtual void unsubscribe(subscription_id id);
 
     virtual system_context &context();
 
@@ -106,6 +112,13 @@ public:
     void enable_draw();
     bool draw_enabled() const;
 
+    /// Counters of the rects submitted by redraw() and the rects painted after the coalescing
+    damage_statistics get_damage_statistics() const;
+    void reset_damage_statistics();
+
+    /// The controls call it when their position was changed to update the hit test grid
+    void invalidate_controls_grid();
+
     /// Emit event methods
     void emit_event(int32_t x, int32_t y);
     
@@ -150,7 +163,14 @@ private:
     system_context context_;
     graphic graphic_;
 
+    damage_region damage_;
+    bool damage_erase;
+
     std::vector<std::shared_ptr<i_control>> controls;
+
+    control_grid controls_grid;
+    bool controls_grid_valid;
+    std::vector<int32_t> grid_hits;
     std::shared_ptr<i_control> active_control;
 
     std::string caption;
@@ -159,7 +179,12 @@ private:
     window_style window_style_;
     wui::window_state window_state_, prev_window_state_;
 
+    /// The used theme values, tcn_keys is indexed by theme_value
+    enum theme_value { tk_background, tk_border, tk_round, tk_border_width, tk_text, tk_caption_font };
+    static constexpr const char *theme_values[] = { tv_background, tv_border, tv_round, tv_border_width, tv_text, tv_caption_font };
+
     std::string tcn; /// control name in theme
+    theme_keys tcn_keys; /// tcn values resolved to the theme keys
     std::shared_ptr<i_theme> theme_;
 
     bool showed_, enabled_, skip_draw_;
@@ -167,7 +192,7 @@ private:
     size_t focused_index;
 
     std::weak_ptr<window> parent_;
-    std::string my_control_sid, my_plain_sid;
+    subscription_id my_control_sid, my_plain_sid;
 
     std::weak_ptr<window> transient_window;
     bool docked_;
@@ -175,12 +200,26 @@ private:
 
     struct event_subscriber
     {
-        std::string id;
+        subscription_id id; /// 0 if the subscriber was removed
         std::function<void(const event&)> receive_callback;
         event_type event_types;
         std::shared_ptr<i_control> control;
     };
-    std::vector<event_subscriber> subscribers_;
+
+    static constexpr size_t event_types_count = 4;
+    using subscriber_slots = std::array<std::vector<size_t>, event_types_count>;
+
+    /// The deque keeps the callback in place while it runs and subscribes the new ones.
+    /// The removed slots are skipped by the dispatch and compacted outside of it
+    std::deque<event_subscriber> subscribers_;
+    std::vector<size_t> free_subscriber_slots;
+    subscriber_slots plain_subscribers;
+    std::unordered_map<const i_control*, subscriber_slots> control_subscribers;
+    uint32_t subscriber_generation;
+    int32_t dispatch_depth;
+    bool subscribers_dirty;
+
+    void compact_subscribers();
 
     enum class moving_mode
     {
@@ -221,6 +260,10 @@ private:
 
     bool check_control_here(int32_t x, int32_t y);
 
+    rect grid_origin() const;
+    void update_controls_grid();
+    std::shared_ptr<i_control> find_control(int32_t x, int32_t y, bool topmost_only);
+
     void change_focus();
     void execute_focused();
     void set_focused(size_t index);
@@ -235,6 +278,9 @@ private:
 
     void draw_border(graphic &gr);
 
+    void paint(const rect &paint_rect, bool erase);
+    void draw_controls(graphic &gr, const rect &paint_rect);
+
     void send_internal(internal_event_type type, int32_t x, int32_t y);
     void send_system(system_event_type type, int32_t x, int32_t y);
 };
@@ -10,6 +10,7 @@ std::string str(error_type t)
         { error_type::ok,             "ok"             },
         { error_type::file_not_found, "file_not_found" },
         { error_type::invalid_json,   "invalid_json"   },
+        { error_type::invalid_bundle, "invalid_bundle" },
         { error_type::invalid_value,  "invalid_value"  },
         { error_type::system_error,   "system_error"   },
         { error_type::no_handle,      "no_handle"      },
@@ -0,0 +1,212 @@
+#include <wui/common/height_index.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+height_index::height_index()
+    : count_(0),
+    uniform_height(0),
+    heights(),
+    tree(),
+    high_bit(0)
+{
+}
+
+bool height_index::uniform() const
+{
+    return heights.empty();
+}
+
+void height_index::reset(int32_t count, int32_t uniform_height_)
+{
+    count_ = count > 0 ? count : 0;
+    uniform_height = uniform_height_ > 0 ? uniform_height_ : 0;
+
+    heights.clear();
+    tree.clear();
+}
+
+void height_index::assign(const std::vector<int32_t> &heights_)
+{
+    if (heights_.empty() || std::all_of(heights_.begin(), heights_.end(), [&heights_](int32_t h) { return h == heights_.front(); }))
+    {
+        return reset(static_cast<int32_t>(heights_.size()), heights_.empty() ? 0 : heights_.front());
+    }
+
+    build(heights_);
+}
+
+void height_index::build(const std::vector<int32_t> &heights_)
+{
+    count_ = static_cast<int32_t>(heights_.size());
+    uniform_height = 0;
+
+    heights.resize(count_);
+    tree.assign(count_ + 1, 0);
+
+    for (int32_t i = 0; i != count_; ++i)
+    {
+        heights[i] = heights_[i] > 0 ? heights_[i] : 0;
+
+        /// O(n) construction: each node passes its sum to the parent
+        tree[i + 1] += heights[i];
+        auto parent = (i + 1) + ((i + 1) & -(i + 1));
+        if (parent <= count_)
+        {
+            tree[parent] += tree[i + 1];
+        }
+    }
+
+    high_bit = 1;
+    while (high_bit * 2 <= count_)
+    {
+        high_bit *= 2;
+    }
+}
+
+void height_index::set(int32_t item, int32_t height)
+{
+    if (item < 0 || item >= count_)
+    {
+        return;
+    }
+
+    height = height > 0 ? height : 0;
+
+    if (uniform())
+    {
+        if (height == uniform_height)
+        {
+            return;
+        }
+        if (count_ == 1)
+        {
+            uniform_height = height;
+            return;
+        }
+        build(std::vector<int32_t>(count_, uniform_height));
+    }
+
+    auto delta = height - heights[item];
+    heights[item] = height;
+
+    for (auto i = item + 1; i <= count_; i += i & -i)
+    {
+        tree[i] += delta;
+    }
+}
+
+void height_index::insert(int32_t item, const std::vector<int32_t> &heights_)
+{
+    if (heights_.empty())
+    {
+        return;
+    }
+
+    item = std::min(std::max(item, 0), count_);
+
+    auto new_count = count_ + static_cast<int32_t>(heights_.size());
+
+    if (uniform() && std::all_of(heights_.begin(), heights_.end(), [this, &heights_](int32_t h) { return h == (count_ != 0 ? uniform_height : heights_.front()); }))
+    {
+        return reset(new_count, count_ != 0 ? uniform_height : heights_.front());
+    }
+
+    std::vector<int32_t> all = uniform() ? std::vector<int32_t>(count_, uniform_height) : heights;
+    all.insert(all.begin() + item, heights_.begin(), heights_.end());
+
+    assign(all);
+}
+
+void height_index::erase(int32_t item, int32_t count)
+{
+    item = std::min(std::max(item, 0), count_);
+    count = std::min(std::max(count, 0), count_ - item);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (uniform())
+    {
+        return reset(count_ - count, uniform_height);
+    }
+
+    std::vector<int32_t> all = heights;
+    all.erase(all.begin() + item, all.begin() + item + count);
+
+    assign(all);
+}
+
+int32_t height_index::count() const
+{
+    return count_;
+}
+
+int32_t height_index::height(int32_t item) const
+{
+    if (item < 0 || item >= count_)
+    {
+        return 0;
+    }
+
+    return uniform() ? uniform_height : heights[item];
+}
+
+int32_t height_index::top(int32_t item) const
+{
+    item = std::min(std::max(item, 0), count_);
+
+    if (uniform())
+    {
+        return item * uniform_height;
+    }
+
+    int32_t sum = 0;
+    for (auto i = item; i > 0; i -= i & -i)
+    {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+int32_t height_index::total() const
+{
+    return top(count_);
+}
+
+int32_t height_index::item_at(int32_t y) const
+{
+    if (y < 0)
+    {
+        return -1;
+    }
+
+    if (uniform())
+    {
+        if (uniform_height == 0)
+        {
+            return count_;
+        }
+        return std::min(y / uniform_height, count_);
+    }
+
+    /// Descends the tree to the last position whose prefix sum is not above y
+    int32_t position = 0, rest = y;
+    for (auto step = high_bit; step != 0; step /= 2)
+    {
+        auto next = position + step;
+        if (next <= count_ && tree[next] <= rest)
+        {
+            position = next;
+            rest -= tree[next];
+        }
+    }
+
+    return position;
+}
+
+}
@@ -0,0 +1,104 @@
+#include <wui/common/minmax_pyramid.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+minmax_pyramid::minmax_pyramid()
+    : samples(),
+    levels()
+{
+}
+
+void minmax_pyramid::clear()
+{
+    samples.clear();
+    levels.clear();
+}
+
+void minmax_pyramid::append(double value_)
+{
+    samples.emplace_back(value_);
+
+    auto n = static_cast<int64_t>(samples.size()) - 1;
+
+    /// The level is added when its first group is full, the groups are used only when they are full
+    int64_t group_size = fan_out;
+    for (size_t k = 0; group_size <= n + 1; ++k, group_size *= fan_out)
+    {
+        if (k == levels.size())
+        {
+            auto [min, max] = std::minmax_element(samples.begin(), samples.end());
+            levels.push_back({ { *min, *max } });
+            continue;
+        }
+
+        auto group = static_cast<size_t>(n / group_size);
+        if (group == levels[k].size())
+        {
+            levels[k].push_back({ value_, value_ });
+        }
+        else
+        {
+            auto &b = levels[k][group];
+            b.min = std::min(b.min, value_);
+            b.max = std::max(b.max, value_);
+        }
+    }
+}
+
+int64_t minmax_pyramid::size() const
+{
+    return static_cast<int64_t>(samples.size());
+}
+
+double minmax_pyramid::value(int64_t n) const
+{
+    return samples[static_cast<size_t>(n)];
+}
+
+/// Walks from the first sample taking the largest aligned group which ends before the last one
+bool minmax_pyramid::range(int64_t first, int64_t last, double &min, double &max) const
+{
+    first = std::max(first, static_cast<int64_t>(0));
+    last = std::min(last, size());
+
+    if (first >= last)
+    {
+        return false;
+    }
+
+    min = samples[static_cast<size_t>(first)];
+    max = min;
+
+    while (first < last)
+    {
+        int64_t group_size = 1;
+        size_t level = 0;
+        while (level < levels.size() && first % (group_size * fan_out) == 0 && first + group_size * fan_out <= last)
+        {
+            group_size *= fan_out;
+            ++level;
+        }
+
+        if (level == 0)
+        {
+            auto v = samples[static_cast<size_t>(first)];
+            min = std::min(min, v);
+            max = std::max(max, v);
+        }
+        else
+        {
+            auto &b = levels[level - 1][static_cast<size_t>(first / group_size)];
+            min = std::min(min, b.min);
+            max = std::max(max, b.max);
+        }
+
+        first += group_size;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,223 @@
+#include <wui/common/piece_table.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+piece_table::piece_table()
+    : original(),
+    added(),
+    pieces(),
+    size_(0),
+    line_starts(1, 0)
+{
+}
+
+void piece_table::assign(std::string text_)
+{
+    original = std::move(text_);
+    added.clear();
+
+    pieces.clear();
+    if (!original.empty())
+    {
+        pieces.push_back({ false, 0, original.size() });
+    }
+    size_ = original.size();
+
+    line_starts.assign(1, 0);
+    for (size_t i = 0; i != original.size(); ++i)
+    {
+        if (original[i] == '\n')
+        {
+            line_starts.emplace_back(i + 1);
+        }
+    }
+}
+
+const char *piece_table::data(const piece &p) const
+{
+    return (p.added ? added.data() : original.data()) + p.start;
+}
+
+size_t piece_table::split(size_t position)
+{
+    size_t offset = 0;
+    for (size_t i = 0; i != pieces.size(); ++i)
+    {
+        if (offset == position)
+        {
+            return i;
+        }
+
+        auto &p = pieces[i];
+        if (position < offset + p.length)
+        {
+            auto head = position - offset;
+            piece tail = { p.added, p.start + head, p.length - head };
+            p.length = head;
+            pieces.insert(pieces.begin() + i + 1, tail);
+            return i + 1;
+        }
+
+        offset += p.length;
+    }
+
+    return pieces.size();
+}
+
+void piece_table::insert(size_t position, std::string_view text_)
+{
+    if (text_.empty())
+    {
+        return;
+    }
+
+    position = std::min(position, size_);
+
+    auto index = split(position);
+
+    /// The typing goes to the end of the add buffer, so the previous piece just grows
+    if (index != 0 && pieces[index - 1].added && pieces[index - 1].start + pieces[index - 1].length == added.size())
+    {
+        pieces[index - 1].length += text_.size();
+    }
+    else
+    {
+        pieces.insert(pieces.begin() + index, piece{ true, added.size(), text_.size() });
+    }
+
+    added.append(text_);
+    size_ += text_.size();
+
+    auto line = std::upper_bound(line_starts.begin(), line_starts.end(), position) - line_starts.begin();
+    for (auto i = static_cast<size_t>(line); i != line_starts.size(); ++i)
+    {
+        line_starts[i] += text_.size();
+    }
+
+    std::vector<size_t> new_starts;
+    for (size_t i = 0; i != text_.size(); ++i)
+    {
+        if (text_[i] == '\n')
+        {
+            new_starts.emplace_back(position + i + 1);
+        }
+    }
+    line_starts.insert(line_starts.begin() + line, new_starts.begin(), new_starts.end());
+}
+
+void piece_table::erase(size_t position, size_t length)
+{
+    position = std::min(position, size_);
+    length = std::min(length, size_ - position);
+
+    if (length == 0)
+    {
+        return;
+    }
+
+    auto first = split(position);
+    auto last = split(position + length);
+    pieces.erase(pieces.begin() + first, pieces.begin() + last);
+
+    size_ -= length;
+
+    auto from = std::upper_bound(line_starts.begin(), line_starts.end(), position);
+    auto to = std::upper_bound(from, line_starts.end(), position + length);
+    for (auto it = to; it != line_starts.end(); ++it)
+    {
+        *it -= length;
+    }
+    line_starts.erase(from, to);
+}
+
+size_t piece_table::size() const
+{
+    return size_;
+}
+
+std::string piece_table::text() const
+{
+    return text(0, size_);
+}
+
+std::string piece_table::text(size_t position, size_t length) const
+{
+    std::string out;
+
+    position = std::min(position, size_);
+    length = std::min(length, size_ - position);
+    out.reserve(length);
+
+    size_t offset = 0;
+    for (auto &p : pieces)
+    {
+        if (out.size() == length)
+        {
+            break;
+        }
+
+        if (position < offset + p.length)
+        {
+            auto begin = position > offset ? position - offset : 0;
+            auto count = std::min(p.length - begin, length - out.size());
+            out.append(data(p) + begin, count);
+        }
+
+        offset += p.length;
+    }
+
+    return out;
+}
+
+char piece_table::at(size_t position) const
+{
+    size_t offset = 0;
+    for (auto &p : pieces)
+    {
+        if (position < offset + p.length)
+        {
+            return data(p)[position - offset];
+        }
+        offset += p.length;
+    }
+    return 0;
+}
+
+int32_t piece_table::line_count() const
+{
+    return static_cast<int32_t>(line_starts.size());
+}
+
+size_t piece_table::line_start(int32_t line) const
+{
+    if (line < 0)
+    {
+        return 0;
+    }
+    return line < line_count() ? line_starts[line] : size_;
+}
+
+size_t piece_table::line_end(int32_t line) const
+{
+    if (line + 1 < line_count())
+    {
+        return line_starts[line + 1] - 1;
+    }
+    return size_;
+}
+
+int32_t piece_table::line_of(size_t position) const
+{
+    return static_cast<int32_t>(std::upper_bound(line_starts.begin(), line_starts.end(), position) - line_starts.begin()) - 1;
+}
+
+std::string piece_table::line(int32_t line) const
+{
+    auto start = line_start(line);
+    return text(start, line_end(line) - start);
+}
+
+}
@@ -0,0 +1,96 @@
+#include <wui/common/trigram_index.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static char lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static uint32_t trigram(const std::string &text, size_t position)
+{
+    return (static_cast<uint32_t>(static_cast<uint8_t>(text[position])) << 16) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(text[position + 1])) << 8) |
+        static_cast<uint32_t>(static_cast<uint8_t>(text[position + 2]));
+}
+
+trigram_index::trigram_index()
+    : texts(),
+    postings()
+{
+}
+
+void trigram_index::clear()
+{
+    texts.clear();
+    postings.clear();
+}
+
+void trigram_index::add(std::string_view text)
+{
+    auto number = static_cast<int32_t>(texts.size());
+
+    std::string lowered(text);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), lower);
+
+    for (size_t i = 0; i + 3 <= lowered.size(); ++i)
+    {
+        auto &posting = postings[trigram(lowered, i)];
+        if (posting.empty() || posting.back() != number) /// the trigram repeated in the text
+        {
+            posting.emplace_back(number);
+        }
+    }
+
+    texts.emplace_back(std::move(lowered));
+}
+
+int32_t trigram_index::count() const
+{
+    return static_cast<int32_t>(texts.size());
+}
+
+void trigram_index::search(std::string_view query, std::function<bool(int32_t)> match) const
+{
+    std::string lowered(query);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(), lower);
+
+    if (lowered.size() < 3)
+    {
+        for (int32_t i = 0; i != count(); ++i)
+        {
+            if (texts[i].find(lowered) != std::string::npos && !match(i))
+            {
+                return;
+            }
+        }
+        return;
+    }
+
+    const std::vector<int32_t> *rarest = nullptr;
+    for (size_t i = 0; i + 3 <= lowered.size(); ++i)
+    {
+        auto it = postings.find(trigram(lowered, i));
+        if (it == postings.end())
+        {
+            return; /// no text has this trigram
+        }
+        if (!rarest || it->second.size() < rarest->size())
+        {
+            rarest = &it->second;
+        }
+    }
+
+    for (auto number : *rarest)
+    {
+        if ((lowered.size() == 3 || texts[number].find(lowered) != std::string::npos) && !match(number))
+        {
+            return;
+        }
+    }
+}
+
+}
@@ -12,6 +12,15 @@ static std::shared_ptr<i_config> instance = nullptr;
 
 /// Interface
 
+bool use_ini_file(std::string_view file_name)
+{
+    instance.reset();
+    instance = std::make_shared<config_impl_ini>(file_name);
+
+    return instance->get_error().is_ok();
+}
+
+#ifdef _WIN32
 bool use_registry(std::string_view app_key, HKEY root)
 {
     instance.reset();
@@ -19,10 +28,18 @@ bool use_registry(std::string_view app_key, HKEY root)
 
     return instance->get_error().is_ok();
 }
+#endif
 
 bool create_config(std::string_view file_name, std::string_view app_key, int64_t root)
 {
+#ifdef _WIN32
+    (void)file_name;
     return use_registry(app_key, root == 0 ? HKEY_CURRENT_USER : (HKEY)root);
+#elif __linux__
+    (void)app_key;
+    (void)root;
+    return use_ini_file(file_name);
+#endif
 }
 
 error get_error()
@@ -101,6 +118,14 @@ void delete_key(std::string_view section)
     }
 }
 
+void flush()
+{
+    if (instance)
+    {
+        instance->flush();
+    }
+}
+
 }
 
 }
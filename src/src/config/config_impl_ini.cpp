@@ -0,0 +1,383 @@
+#include <wui/config/config_impl_ini.hpp>
+#include <wui/system/path_tools.hpp>
+#include <wui/system/string_tools.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace wui
+{
+
+namespace config
+{
+
+/// Write after the changes stop for this time, but not later than max_flush_delay after the first change
+static const std::chrono::milliseconds flush_delay(500);
+static const std::chrono::milliseconds max_flush_delay(5000);
+
+config_impl_ini::config_impl_ini(std::string_view file_name_)
+    : file_name(wui::real_path(file_name_)),
+    values(),
+    mutex(),
+    flush_condition(),
+    flusher(),
+    dirty(false), stopping(false),
+    first_change(), last_change(),
+    save_mutex(),
+    err{}
+{
+    load_values();
+
+    flusher = std::thread(&config_impl_ini::flush_work, this);
+}
+
+config_impl_ini::~config_impl_ini()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    flush_condition.notify_one();
+
+    if (flusher.joinable())
+    {
+        flusher.join();
+    }
+
+    flush();
+}
+
+int32_t config_impl_ini::get_int(std::string_view section, std::string_view entry, int32_t default_)
+{
+    return static_cast<int32_t>(get_int64(section, entry, default_));
+}
+
+void config_impl_ini::set_int(std::string_view section, std::string_view entry, int32_t value)
+{
+    set_int64(section, entry, value);
+}
+
+int64_t config_impl_ini::get_int64(std::string_view section, std::string_view entry, int64_t default_)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto s = values.find({ std::string(section), std::string(entry) });
+    if (s != values.end() && s->second.type == value_type::int64)
+    {
+        return s->second.int_val;
+    }
+    return default_;
+}
+
+void config_impl_ini::set_int64(std::string_view section, std::string_view entry, int64_t value)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        /// Only the existing value is compared, the new one is always written
+        auto s = values.find({ std::string(section), std::string(entry) });
+        if (s == values.end())
+        {
+            s = values.emplace(std::make_pair(std::string(section), std::string(entry)), config_impl_ini::value{}).first;
+        }
+        else if (s->second.type == value_type::int64 && s->second.int_val == value)
+        {
+            return;
+        }
+        s->second.type = value_type::int64;
+        s->second.int_val = value;
+        s->second.str_val = std::to_string(value);
+
+        mark_dirty();
+    }
+    flush_condition.notify_one();
+}
+
+std::string config_impl_ini::get_string(std::string_view section, std::string_view entry, std::string_view default_)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto s = values.find({ std::string(section), std::string(entry) });
+    if (s != values.end())
+    {
+        return s->second.str_val;
+    }
+    return std::string(default_);
+}
+
+void config_impl_ini::set_string(std::string_view section, std::string_view entry, std::string_view value)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto s = values.find({ std::string(section), std::string(entry) });
+        if (s == values.end())
+        {
+            s = values.emplace(std::make_pair(std::string(section), std::string(entry)), config_impl_ini::value{}).first;
+        }
+        else if (s->second.type == value_type::string && s->second.str_val == value)
+        {
+            return;
+        }
+        s->second.type = value_type::string;
+        s->second.str_val = value;
+
+        mark_dirty();
+    }
+    flush_condition.notify_one();
+}
+
+void config_impl_ini::delete_value(std::string_view section, std::string_view entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto s = values.find({ std::string(section), std::string(entry) });
+        if (s == values.end())
+        {
+            return;
+        }
+        values.erase(s);
+
+        mark_dirty();
+    }
+    flush_condition.notify_one();
+}
+
+void config_impl_ini::delete_key(std::string_view section)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto begin = values.lower_bound({ std::string(section), std::string() });
+        auto end = begin;
+        while (end != values.end() && end->first.first == section)
+        {
+            ++end;
+        }
+        if (begin == end)
+        {
+            return;
+        }
+        values.erase(begin, end);
+
+        mark_dirty();
+    }
+    flush_condition.notify_one();
+}
+
+void config_impl_ini::flush()
+{
+    save_values();
+}
+
+error config_impl_ini::get_error() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return err;
+}
+
+/// Must be called under the mutex
+void config_impl_ini::mark_dirty()
+{
+    last_change = std::chrono::steady_clock::now();
+    if (!dirty)
+    {
+        dirty = true;
+        first_change = last_change;
+    }
+}
+
+void config_impl_ini::flush_work()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (!stopping)
+    {
+        if (!dirty)
+        {
+            flush_condition.wait(lock, [this] { return dirty || stopping; });
+            continue;
+        }
+
+        auto deadline = std::min(last_change + flush_delay, first_change + max_flush_delay);
+        if (std::chrono::steady_clock::now() < deadline)
+        {
+            flush_condition.wait_until(lock, deadline);
+            continue;
+        }
+
+        lock.unlock();
+        save_values();
+        lock.lock();
+    }
+}
+
+bool config_impl_ini::load_values()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    err.reset();
+
+    std::ifstream f(std::filesystem::u8path(file_name), std::ios::in);
+    if (!f)
+    {
+        err.type = error_type::file_not_found;
+        err.component = "config_impl_ini::load_values()";
+        err.message = "Error opening config file: " + file_name;
+
+        return false;
+    }
+
+    std::string section;
+    for (std::string line; std::getline(f, line); )
+    {
+        auto comment_pos = line.find(";");
+        auto beg_bracket = line.find("["), end_bracket = line.find("]");
+        if (beg_bracket != std::string::npos && end_bracket != std::string::npos && beg_bracket < end_bracket &&
+            comment_pos > beg_bracket && comment_pos > end_bracket)
+        {
+            section = trim_copy(line.substr(beg_bracket + 1, end_bracket - beg_bracket - 1));
+            continue;
+        }
+
+        auto eq_pos = line.find("=");
+        if (eq_pos != std::string::npos && eq_pos < comment_pos)
+        {
+            std::string entry = trim_copy(line.substr(0, eq_pos));
+            std::string value = trim_copy(line.substr(eq_pos + 1, comment_pos - eq_pos - 1));
+
+            auto &v = values[{ section, entry }];
+            v.type = value_type::string;
+            v.str_val = value;
+
+            if (is_number(value))
+            {
+                try
+                {
+                    v.int_val = std::stoll(value);
+                    v.type = value_type::int64;
+                }
+                catch (std::out_of_range const& ex)
+                {
+                    err.type = error_type::invalid_value;
+                    err.component = "config_impl_ini::load_values()";
+                    err.message = "std::out_of_range::what(): " + std::string(ex.what()) + ", entry: " + entry;
+                }
+            }
+
+            if (comment_pos != std::string::npos)
+            {
+                v.comment = trim_copy(line.substr(comment_pos + 1, std::string::npos));
+            }
+        }
+        else if (comment_pos != std::string::npos)
+        {
+            auto &v = values[{ section, "" }];
+            v.type = value_type::only_comment;
+            v.comment = trim_copy(line.substr(comment_pos + 1, std::string::npos));
+        }
+    }
+
+    return true;
+}
+
+/// Takes the snapshot under the mutex and writes it without the mutex, so the setters are not blocked by the disk
+bool config_impl_ini::save_values()
+{
+    std::lock_guard<std::mutex> save_lock(save_mutex);
+
+    std::ostringstream out;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!dirty)
+        {
+            return true;
+        }
+        dirty = false;
+
+        std::string current_section;
+        bool first_section = true;
+
+        for (auto &v : values)
+        {
+            if (first_section || v.first.first != current_section)
+            {
+                if (!first_section)
+                {
+                    out << std::endl;
+                }
+                first_section = false;
+
+                current_section = v.first.first;
+                out << "[" << current_section << "]" << std::endl;
+            }
+
+            switch (v.second.type)
+            {
+                case value_type::string:
+                    out << v.first.second << " = " << v.second.str_val;
+                break;
+                case value_type::int64:
+                    out << v.first.second << " = " << v.second.int_val;
+                break;
+                default:
+                break;
+            }
+
+            if (!v.second.comment.empty())
+            {
+                out << (v.second.type == value_type::only_comment ? "; " : " ; ") << v.second.comment;
+            }
+
+            out << std::endl;
+        }
+    }
+
+    auto path = std::filesystem::u8path(file_name);
+    auto temp_path = std::filesystem::u8path(file_name + ".tmp");
+
+    std::error_code ec;
+    {
+        std::ofstream f(temp_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (f)
+        {
+            auto data = out.str();
+            f.write(data.data(), data.size());
+            f.close();
+        }
+        if (!f)
+        {
+            ec = std::make_error_code(std::errc::io_error);
+        }
+    }
+
+    if (!ec)
+    {
+        std::filesystem::rename(temp_path, path, ec);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (ec)
+    {
+        std::filesystem::remove(temp_path, ec);
+
+        err.type = error_type::file_not_found;
+        err.component = "config_impl_ini::save_values()";
+        err.message = "Error write to config file: " + file_name;
+
+        dirty = true; /// Retry after the flush delay
+        first_change = last_change = std::chrono::steady_clock::now();
+        return false;
+    }
+
+    err.reset();
+    return true;
+}
+
+}
+
+}
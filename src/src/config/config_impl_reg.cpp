@@ -167,6 +167,11 @@ void config_impl_reg::delete_key(std::string_view section)
 	key.Close();
 }
 
+/// The registry writes the values at once
+void config_impl_reg::flush()
+{
+}
+
 error config_impl_reg::get_error() const
 {
     return {};
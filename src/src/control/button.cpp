@@ -21,12 +21,13 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     tooltip_(std::make_shared<tooltip>(caption_, tooltip::tc, theme__)),
     click_callback(click_callback_),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
     my_subscriber_id(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
-    focusing_(theme_dimension(tcn, tv_focusing, theme_) != 0),
+    focusing_(theme_dimension(tcn_keys[tk_focusing], theme_) != 0),
     pushed(false),
     turned_(false),
     text_rect{ 0 },
@@ -39,10 +40,10 @@ std::shared_ptr<image> get_button_image(button_view button_view_, std::shared_pt
     switch (button_view_)
     {
         case button_view::switcher:
-            return std::make_shared<image>(theme_image(button::ti_switcher_on, theme_));
+            return std::make_shared<image>(button::ti_switcher_on, theme_);
         break;
         case button_view::radio:
-            return std::make_shared<image>(theme_image(button::ti_radio_on, theme_));
+            return std::make_shared<image>(button::ti_radio_on, theme_);
         break;
         default:
             return nullptr;
@@ -58,12 +59,13 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     tooltip_(std::make_shared<tooltip>(caption_, tooltip::tc, theme__)),
     click_callback(click_callback_),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
     my_subscriber_id(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
-    focusing_(theme_dimension(tcn, tv_focusing, theme_) != 0),
+    focusing_(theme_dimension(tcn_keys[tk_focusing], theme_) != 0),
     pushed(false),
     turned_(false),
     text_rect{ 0 },
@@ -81,11 +83,12 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     tooltip_(std::make_shared<tooltip>(caption_, tooltip::tc, theme__)),
     click_callback(click_callback_),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
-    focusing_(theme_dimension(tcn, tv_focusing, theme_) != 0),
+    focusing_(theme_dimension(tcn_keys[tk_focusing], theme_) != 0),
     pushed(false),
     turned_(false),
     text_rect{ 0 },
@@ -103,11 +106,12 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     tooltip_(std::make_shared<tooltip>(caption_, tooltip::tc, theme__)),
     click_callback(click_callback_),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
-    focusing_(theme_dimension(tcn, tv_focusing, theme_) != 0),
+    focusing_(theme_dimension(tcn_keys[tk_focusing], theme_) != 0),
     pushed(false),
     turned_(false),
     text_rect{ 0 },
@@ -124,12 +128,13 @@ button::button(std::string_view caption_, std::function<void(void)> click_callba
     tooltip_(std::make_shared<tooltip>(caption_, tooltip::tc, theme__)),
     click_callback(click_callback_),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
     my_subscriber_id(),
     showed_(true), enabled_(true), topmost_(false), active(false), focused_(false),
-    focusing_(theme_dimension(tcn, tv_focusing, theme_) != 0),
+    focusing_(theme_dimension(tcn_keys[tk_focusing], theme_) != 0),
     pushed(false),
     turned_(false),
     text_rect{ 0 },
@@ -154,7 +159,7 @@ void button::draw(graphic &gr, const rect &)
         return;
     }
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
 
     if (button_view_ != button_view::image && !caption.empty() && text_rect.width() == 0)
     {
@@ -278,11 +283,11 @@ void button::draw(graphic &gr, const rect &)
 
     if (button_view_ != button_view::anchor && button_view_ != button_view::switcher && button_view_ != button_view::radio && button_view_ != button_view::sheet)
     {
-        auto border_color = !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_);
+        auto border_color = !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_);
 
-        auto fill_color = enabled_ ? (active || turned_ ? theme_color(tcn, tv_active, theme_) : theme_color(tcn, tv_calm, theme_)) : theme_color(tcn, tv_disabled, theme_);
+        auto fill_color = enabled_ ? (active || turned_ ? theme_color(tcn_keys[tk_active], theme_) : theme_color(tcn_keys[tk_calm], theme_)) : theme_color(tcn_keys[tk_disabled], theme_);
 
-        gr.draw_rect(control_pos, border_color, fill_color, theme_dimension(tcn, tv_border_width, theme_), theme_dimension(tcn, tv_round, theme_));
+        gr.draw_rect(control_pos, border_color, fill_color, theme_dimension(tcn_keys[tk_border_width], theme_), theme_dimension(tcn_keys[tk_round], theme_));
     }
 	
     if (button_view_ != button_view::text && button_view_ != button_view::anchor && image_)
@@ -297,17 +302,17 @@ void button::draw(graphic &gr, const rect &)
 
     if (button_view_ != button_view::image)
     {
-        auto color_ = theme_color(tcn, tv_text, theme_);
+        auto color_ = theme_color(tcn_keys[tk_text], theme_);
 
         if (button_view_ == button_view::anchor)
         {
-            color_ = theme_color(tcn, tv_anchor, theme_);
+            color_ = theme_color(tcn_keys[tk_anchor], theme_);
             font_.decorations_ = decorations::underline;
         }
 
         if (!enabled_ && (button_view_ == button_view::anchor || button_view_ == button_view::sheet))
         {
-            color_ = theme_color(tcn, tv_disabled, theme_);
+            color_ = theme_color(tcn_keys[tk_disabled], theme_);
         }
 
         gr.draw_text({ text_left, text_top }, caption, 
@@ -317,7 +322,7 @@ void button::draw(graphic &gr, const rect &)
 
     if (button_view_ == button_view::sheet)
     {
-        gr.draw_rect({ control_pos.left, control_pos.bottom - 2, control_pos.right, control_pos.bottom }, turned_ ? theme_color(tcn, enabled_ ? tv_calm : tv_disabled, theme_) : theme_color(window::tc, window::tv_background, theme_));
+        gr.draw_rect({ control_pos.left, control_pos.bottom - 2, control_pos.right, control_pos.bottom }, turned_ ? theme_color(tcn_keys[enabled_ ? tk_calm : tk_disabled], theme_) : theme_color(window::tc, window::tv_background, theme_));
     }
 }
 
@@ -486,6 +491,7 @@ error button::get_error() const
 void button::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -501,12 +507,14 @@ void button::update_theme(std::shared_ptr<i_theme> theme__)
 
     if (button_view_ == button_view::switcher)
     {
-        image_->change_image(theme_image(turned_ ? ti_switcher_on : ti_switcher_off));
+        image_->update_theme(theme_);
+        image_->change_image(turned_ ? ti_switcher_on : ti_switcher_off);
         update_err("button::update_theme[switcher]", image_->get_error());
     }
     if (button_view_ == button_view::radio)
     {
-        image_->change_image(theme_image(turned_ ? ti_radio_on : ti_radio_off));
+        image_->update_theme(theme_);
+        image_->change_image(turned_ ? ti_radio_on : ti_radio_off);
         update_err("button::update_theme[radio]", image_->get_error());
     }
     else if (image_)
@@ -638,11 +646,11 @@ void button::turn(bool on)
     switch (button_view_)
     {
         case button_view::switcher:
-            image_->change_image(theme_image(turned_ ? ti_switcher_on : ti_switcher_off));
+            image_->change_image(turned_ ? ti_switcher_on : ti_switcher_off);
             update_err("button::turn", image_->get_error());
         break;
         case button_view::radio:
-            image_->change_image(theme_image(turned_ ? ti_radio_on : ti_radio_off));
+            image_->change_image(turned_ ? ti_radio_on : ti_radio_off);
             update_err("button::turn", image_->get_error());
         break;
         default:
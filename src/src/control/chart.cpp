@@ -0,0 +1,530 @@
+#include <wui/control/chart.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace wui
+{
+
+static const int32_t chart_indent = 4;
+static const int64_t chart_min_view = 2;
+static const double chart_zoom_step = 1.25;
+
+chart::chart(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : series(),
+    view_first_(0), view_count_(1000),
+    follow_tail_(true),
+    y_min(0), y_max(0),
+    points(),
+    tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
+    theme_(theme__),
+    position_(),
+    parent_(),
+    my_control_sid(),
+    showed_(true), enabled_(true), topmost_(false), focused_(false),
+    dragging(false),
+    drag_x(0),
+    drag_first(0)
+{
+}
+
+chart::~chart()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void chart::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.width() == 0 || position_.height() == 0)
+    {
+        return;
+    }
+
+    gr.draw_rect(position(),
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
+
+    auto area = plot_area();
+    if (area.width() <= 1 || area.height() <= 1)
+    {
+        return;
+    }
+
+    /// The range of the shown samples is taken from the pyramids too, so it costs a few steps per series
+    auto min = y_min, max = y_max;
+    if (min >= max)
+    {
+        auto found = false;
+        for (auto &series_ : series)
+        {
+            double series_min = 0, series_max = 0;
+            if (series_.samples.range(view_first_, view_first_ + view_count_ + 1, series_min, series_max))
+            {
+                min = found ? std::min(min, series_min) : series_min;
+                max = found ? std::max(max, series_max) : series_max;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            return;
+        }
+
+        if (min == max)
+        {
+            min -= 1;
+            max += 1;
+        }
+    }
+
+    /// Only the columns under the clip are taken, and one column more on each side to join the lines
+    auto clip_ = gr.clip().intersection(area);
+    if (clip_.width() == 0 || clip_.height() == 0)
+    {
+        return;
+    }
+    auto from_x = std::max(clip_.left - 1, area.left), to_x = std::min(clip_.right + 1, area.right);
+
+    gr.push_clip(area);
+
+    for (auto &series_ : series)
+    {
+        draw_series(gr, series_, area, from_x, to_x, min, max);
+    }
+
+    gr.pop_clip();
+}
+
+void chart::draw_series(graphic &gr, const series_data &series_, const rect &area, int32_t from_x, int32_t to_x, double min, double max)
+{
+    points.clear();
+
+    auto height = area.height() - 1;
+    auto y_of = [&area, height, min, max](double v) {
+        auto y = (v - min) / (max - min) * height;
+        return area.bottom - 1 - static_cast<int32_t>(std::lround(std::min(std::max(y, -1.0), height + 1.0)));
+    };
+
+    auto spp = samples_per_pixel();
+
+    if (spp > 1.0)
+    {
+        /// Each column is the vertical line from the min to the max of its samples,
+        /// the nearest end to the previous column goes first to not draw the false slopes
+        for (auto x = from_x; x < to_x; ++x)
+        {
+            auto first = view_first_ + static_cast<int64_t>((x - area.left) * spp),
+                last = view_first_ + static_cast<int64_t>((x - area.left + 1) * spp);
+
+            double column_min = 0, column_max = 0;
+            if (!series_.samples.range(first, last, column_min, column_max))
+            {
+                continue;
+            }
+
+            auto top = y_of(column_max), bottom = y_of(column_min);
+            if (!points.empty() && points.back().y > bottom)
+            {
+                std::swap(top, bottom);
+            }
+
+            points.push_back({ x, top });
+            if (top != bottom)
+            {
+                points.push_back({ x, bottom });
+            }
+        }
+    }
+    else
+    {
+        /// Zoomed in: the samples are the vertices
+        auto first = std::max(view_first_ + static_cast<int64_t>(std::floor((from_x - area.left) * spp)) - 1, static_cast<int64_t>(0)),
+            last = std::min(view_first_ + static_cast<int64_t>(std::ceil((to_x - area.left) * spp)) + 1, series_.samples.size());
+
+        for (auto n = first; n < last; ++n)
+        {
+            points.push_back({ area.left + static_cast<int32_t>(std::lround((n - view_first_) / spp)), y_of(series_.samples.value(n)) });
+        }
+    }
+
+    gr.draw_polyline(points, series_.color_, series_.width);
+}
+
+rect chart::plot_area() const
+{
+    auto control_pos = position();
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    return { control_pos.left + border_width + chart_indent,
+        control_pos.top + border_width + chart_indent,
+        std::max(control_pos.right - border_width - chart_indent, control_pos.left + border_width + chart_indent),
+        std::max(control_pos.bottom - border_width - chart_indent, control_pos.top + border_width + chart_indent) };
+}
+
+double chart::samples_per_pixel() const
+{
+    return static_cast<double>(view_count_) / std::max(plot_area().width(), 1);
+}
+
+void chart::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::left_down:
+                dragging = true;
+                drag_x = ev.mouse_event_.x;
+                drag_first = view_first_;
+            break;
+            case mouse_event_type::left_up: case mouse_event_type::leave:
+                dragging = false;
+            break;
+            case mouse_event_type::move:
+                if (dragging)
+                {
+                    set_view(drag_first - static_cast<int64_t>(std::lround((ev.mouse_event_.x - drag_x) * samples_per_pixel())), view_count_);
+                }
+            break;
+            case mouse_event_type::wheel:
+                zoom(ev.mouse_event_.wheel_delta > 0 ? 1.0 / chart_zoom_step : chart_zoom_step, ev.mouse_event_.x);
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        switch (ev.keyboard_event_.type)
+        {
+            case keyboard_event_type::down:
+            {
+                auto area = plot_area();
+                auto center = (area.left + area.right) / 2;
+
+                switch (ev.keyboard_event_.key[0])
+                {
+                    case vk_left: case vk_nleft:
+                        pan(-std::max(view_count_ / 8, static_cast<int64_t>(1)));
+                    break;
+                    case vk_right: case vk_nright:
+                        pan(std::max(view_count_ / 8, static_cast<int64_t>(1)));
+                    break;
+                    case vk_up: case vk_nup:
+                        zoom(1.0 / chart_zoom_step, center);
+                    break;
+                    case vk_down: case vk_ndown:
+                        zoom(chart_zoom_step, center);
+                    break;
+                    case vk_home: case vk_nhome:
+                        set_view(0, view_count_);
+                    break;
+                    case vk_end: case vk_nend:
+                        set_follow_tail(true);
+                    break;
+                    default: break;
+                }
+            }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                dragging = false;
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+void chart::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+}
+
+rect chart::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void chart::set_parent(std::shared_ptr<window> window_)
+{
+    parent_ = window_;
+    my_control_sid = window_->subscribe(std::bind(&chart::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+}
+
+std::weak_ptr<window> chart::parent() const
+{
+    return parent_;
+}
+
+void chart::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->unsubscribe(my_control_sid);
+    }
+    parent_.reset();
+}
+
+void chart::set_topmost(bool yes)
+{
+    topmost_ = yes;
+}
+
+bool chart::topmost() const
+{
+    return topmost_;
+}
+
+bool chart::focused() const
+{
+    return focused_;
+}
+
+bool chart::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error chart::get_error() const
+{
+    return {};
+}
+
+void chart::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    tcn_keys.reset();
+    update_theme(theme_);
+}
+
+void chart::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    redraw();
+}
+
+void chart::show()
+{
+    showed_ = true;
+    redraw();
+}
+
+void chart::hide()
+{
+    showed_ = false;
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->redraw(position(), true);
+    }
+}
+
+bool chart::showed() const
+{
+    return showed_;
+}
+
+void chart::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void chart::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool chart::enabled() const
+{
+    return enabled_;
+}
+
+int32_t chart::add_series(color color__, uint32_t width)
+{
+    series.push_back({ minmax_pyramid(), color__, width });
+
+    return static_cast<int32_t>(series.size()) - 1;
+}
+
+int32_t chart::series_count() const
+{
+    return static_cast<int32_t>(series.size());
+}
+
+void chart::clear()
+{
+    for (auto &series_ : series)
+    {
+        series_.samples.clear();
+    }
+
+    view_first_ = 0;
+    follow_tail_ = true;
+
+    redraw();
+}
+
+void chart::append(int32_t series_, double value)
+{
+    if (series_ < 0 || series_ >= series_count())
+    {
+        return;
+    }
+
+    series[series_].samples.append(value);
+
+    appended();
+}
+
+void chart::append(int32_t series_, const std::vector<double> &values)
+{
+    if (series_ < 0 || series_ >= series_count())
+    {
+        return;
+    }
+
+    for (auto v : values)
+    {
+        series[series_].samples.append(v);
+    }
+
+    appended();
+}
+
+void chart::appended()
+{
+    if (follow_tail_)
+    {
+        view_first_ = std::max(sample_count() - view_count_, static_cast<int64_t>(0));
+    }
+
+    redraw();
+}
+
+int64_t chart::sample_count() const
+{
+    int64_t count = 0;
+    for (auto &series_ : series)
+    {
+        count = std::max(count, series_.samples.size());
+    }
+    return count;
+}
+
+void chart::set_view(int64_t first, int64_t count)
+{
+    view_count_ = std::max(count, chart_min_view);
+    view_first_ = std::min(std::max(first, static_cast<int64_t>(0)), std::max(sample_count() - view_count_, static_cast<int64_t>(0)));
+
+    follow_tail_ = view_first_ + view_count_ >= sample_count();
+
+    redraw();
+}
+
+int64_t chart::view_first() const
+{
+    return view_first_;
+}
+
+int64_t chart::view_count() const
+{
+    return view_count_;
+}
+
+void chart::zoom(double factor, int32_t x)
+{
+    auto area = plot_area();
+    auto column = std::min(std::max(x - area.left, 0), area.width());
+
+    auto anchor = view_first_ + column * samples_per_pixel();
+
+    auto count = std::min(static_cast<int64_t>(std::llround(view_count_ * factor)), std::max(sample_count(), view_count_));
+    count = std::max(count, chart_min_view);
+
+    set_view(static_cast<int64_t>(std::llround(anchor - static_cast<double>(column) * count / std::max(area.width(), 1))), count);
+}
+
+void chart::pan(int64_t samples)
+{
+    set_view(view_first_ + samples, view_count_);
+}
+
+void chart::set_follow_tail(bool yes)
+{
+    follow_tail_ = yes;
+    if (follow_tail_)
+    {
+        view_first_ = std::max(sample_count() - view_count_, static_cast<int64_t>(0));
+        redraw();
+    }
+}
+
+bool chart::follow_tail() const
+{
+    return follow_tail_;
+}
+
+void chart::set_y_range(double min, double max)
+{
+    y_min = min;
+    y_max = max;
+
+    redraw();
+}
+
+void chart::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
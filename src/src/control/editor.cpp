@@ -0,0 +1,959 @@
+#include <wui/control/editor.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/system/clipboard_tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static const int32_t editor_horizontal_indent = 5;
+static const int32_t editor_vertical_indent = 2;
+static const int32_t editor_scrollbar_width = 14;
+
+static bool is_shift(const keyboard_event &ev)
+{
+    return ev.modifier == vk_lshift || ev.modifier == vk_rshift;
+}
+
+editor::editor(std::string_view text__, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : buffer(),
+    line_widths(),
+    line_height(0),
+    change_callback(),
+    tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
+    theme_(theme__),
+    position_(),
+    cursor_position(0), select_start_position(0), select_end_position(0),
+    preferred_x(-1),
+    parent_(),
+    my_control_sid(), my_plain_sid(),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&editor::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    timer_(std::bind(&editor::redraw_cursor, this)),
+    measure_context{ 0 },
+    measure_graphic(measure_context),
+    measure_graphic_ready(false),
+    showed_(true), enabled_(true), topmost_(false), readonly_(false),
+    focused_(false),
+    cursor_visible(false),
+    selecting(false),
+    mouse_on_slider(false),
+    left_shift(0)
+{
+    buffer.assign(std::string(text__));
+    line_widths.assign(buffer.line_count(), -1);
+}
+
+editor::~editor()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void editor::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.width() == 0 || position_.height() == 0)
+    {
+        return;
+    }
+
+    auto control_pos = position();
+
+    /// Draw the frame
+    gr.draw_rect(control_pos,
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
+
+    vert_scroll->draw(gr, {});
+
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
+
+    auto line_height_ = gr.measure_text("Qq", font_).height() + editor_vertical_indent;
+    if (line_height_ != line_height)
+    {
+        line_height = line_height_;
+        update_scroll_area();
+    }
+
+    auto area = text_area();
+    if (area.width() <= 0 || area.height() <= 0 || line_height <= 0)
+    {
+        return;
+    }
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    gr.push_clip(area);
+
+    /// Only the lines under the clip are drawn
+    auto clip_ = gr.clip();
+    auto first_line = std::max((clip_.top - area.top + scroll_pos) / line_height, 0),
+        last_line = std::min((clip_.bottom - area.top + scroll_pos) / line_height + 1, buffer.line_count());
+
+    auto select_from = std::min(select_start_position, select_end_position),
+        select_to = std::max(select_start_position, select_end_position);
+
+    auto text_color = theme_color(tcn_keys[tk_text], theme_);
+    auto selection_color = theme_color(tcn_keys[tk_selection], theme_);
+
+    for (auto line = first_line; line < last_line; ++line)
+    {
+        auto top = area.top + line * line_height - scroll_pos;
+        auto start = buffer.line_start(line), end = buffer.line_end(line);
+
+        if (select_from != select_to && select_from <= end && select_to > start)
+        {
+            auto left = select_from > start ? column_x(gr, line, select_from) : 0;
+            auto right = select_to <= end ? column_x(gr, line, select_to) : measure_line(gr, line) + editor_horizontal_indent; /// the line break is selected too
+
+            gr.draw_rect({ area.left - left_shift + left, top, area.left - left_shift + right, top + line_height }, selection_color);
+        }
+
+        gr.draw_text({ area.left - left_shift, top + editor_vertical_indent / 2 }, buffer.line(line), text_color, font_);
+    }
+
+    if (focused_ && cursor_visible)
+    {
+        auto line = buffer.line_of(cursor_position);
+        auto left = area.left - left_shift + column_x(gr, line, cursor_position);
+        auto top = area.top + line * line_height - scroll_pos;
+
+        gr.draw_line({ left, top, left, top + line_height }, theme_color(tcn_keys[tk_cursor], theme_));
+    }
+
+    gr.pop_clip();
+}
+
+rect editor::text_area() const
+{
+    auto control_pos = position();
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    return { control_pos.left + border_width + editor_horizontal_indent,
+        control_pos.top + border_width + editor_vertical_indent,
+        control_pos.right - border_width - editor_scrollbar_width,
+        control_pos.bottom - border_width - editor_vertical_indent };
+}
+
+graphic *editor::measurer()
+{
+    if (!measure_graphic_ready)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            measure_context = parent__->context();
+        }
+        measure_graphic_ready = measure_graphic.init({ 0, 0, 1, 1 }, 0);
+    }
+
+    return measure_graphic_ready ? &measure_graphic : nullptr;
+}
+
+int32_t editor::measure_line(graphic &gr, int32_t line)
+{
+    if (line < 0 || line >= static_cast<int32_t>(line_widths.size()))
+    {
+        return 0;
+    }
+
+    if (line_widths[line] < 0)
+    {
+        line_widths[line] = gr.measure_text(buffer.line(line), theme_font(tcn_keys[tk_font], theme_)).width();
+    }
+
+    return line_widths[line];
+}
+
+int32_t editor::column_x(graphic &gr, int32_t line, size_t position)
+{
+    auto start = buffer.line_start(line);
+    if (position <= start)
+    {
+        return 0;
+    }
+    if (position >= buffer.line_end(line))
+    {
+        return measure_line(gr, line);
+    }
+
+    return gr.measure_text(buffer.text(start, position - start), theme_font(tcn_keys[tk_font], theme_)).width();
+}
+
+/// Binary search on the codepoint boundaries of the line, so a long line takes a few measurings
+size_t editor::column_at(graphic &gr, int32_t line, int32_t x)
+{
+    auto start = buffer.line_start(line);
+    auto text_ = buffer.line(line);
+
+    std::vector<size_t> boundaries(1, 0);
+    for (size_t i = 0; i != text_.size(); ++i)
+    {
+        if (i + 1 == text_.size() || (static_cast<uint8_t>(text_[i + 1]) & 0xC0) != 0x80)
+        {
+            boundaries.emplace_back(i + 1);
+        }
+    }
+
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
+    auto width = [&](size_t n) { return n != 0 ? gr.measure_text(std::string_view(text_).substr(0, boundaries[n]), font_).width() : 0; };
+
+    size_t low = 0, high = boundaries.size() - 1;
+    while (low < high)
+    {
+        auto middle = (low + high) / 2;
+        if (width(middle) < x)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low != 0 && x - width(low - 1) < width(low) - x)
+    {
+        --low;
+    }
+
+    return start + boundaries[low];
+}
+
+size_t editor::position_at(int32_t x, int32_t y)
+{
+    auto gr = measurer();
+    if (!gr || line_height <= 0)
+    {
+        return cursor_position;
+    }
+
+    auto area = text_area();
+
+    auto line = std::min(std::max((y - area.top + vert_scroll->get_scroll_pos()) / line_height, 0), buffer.line_count() - 1);
+
+    return column_at(*gr, line, x - area.left + left_shift);
+}
+
+void editor::replace(size_t position, size_t length, std::string_view text_)
+{
+    auto first_line = buffer.line_of(position);
+    auto removed_lines = buffer.line_of(position + length) - first_line;
+    auto added_lines = static_cast<int32_t>(std::count(text_.begin(), text_.end(), '\n'));
+
+    buffer.erase(position, length);
+    buffer.insert(position, text_);
+
+    /// Only the edited lines will be measured again
+    line_widths.erase(line_widths.begin() + first_line + 1, line_widths.begin() + first_line + 1 + removed_lines);
+    line_widths.insert(line_widths.begin() + first_line + 1, added_lines, -1);
+    line_widths[first_line] = -1;
+}
+
+void editor::changed()
+{
+    update_scroll_area();
+    make_cursor_visible();
+    redraw();
+
+    if (change_callback)
+    {
+        change_callback();
+    }
+}
+
+void editor::move_cursor(size_t position, bool shift_pressed)
+{
+    if (shift_pressed)
+    {
+        if (select_start_position == select_end_position)
+        {
+            select_start_position = cursor_position;
+        }
+        select_end_position = position;
+    }
+    else
+    {
+        select_start_position = 0;
+        select_end_position = 0;
+    }
+
+    cursor_position = position;
+
+    make_cursor_visible();
+    redraw();
+}
+
+void editor::make_cursor_visible()
+{
+    auto area = text_area();
+    auto line = buffer.line_of(cursor_position);
+
+    if (line_height > 0)
+    {
+        auto top = line * line_height, scroll_pos = vert_scroll->get_scroll_pos();
+        if (top < scroll_pos)
+        {
+            vert_scroll->set_scroll_pos(top);
+        }
+        else if (top + line_height > scroll_pos + area.height())
+        {
+            vert_scroll->set_scroll_pos(top + line_height - area.height());
+        }
+    }
+
+    auto gr = measurer();
+    if (gr)
+    {
+        auto x = column_x(*gr, line, cursor_position);
+        if (x - left_shift > area.width() - editor_horizontal_indent)
+        {
+            left_shift = x - area.width() + editor_horizontal_indent * 4;
+        }
+        else if (x < left_shift)
+        {
+            left_shift = std::max(x - editor_horizontal_indent * 4, 0);
+        }
+    }
+}
+
+void editor::update_scroll_area()
+{
+    auto area = std::max(buffer.line_count() * line_height - text_area().height(), 0);
+    vert_scroll->set_area(area);
+}
+
+bool editor::clear_selected_text()
+{
+    if (select_start_position == select_end_position)
+    {
+        return false;
+    }
+
+    auto from = std::min(select_start_position, select_end_position),
+        to = std::max(select_start_position, select_end_position);
+
+    replace(from, to - from, "");
+    cursor_position = from;
+
+    select_start_position = 0;
+    select_end_position = 0;
+
+    return true;
+}
+
+std::string editor::selected_text() const
+{
+    auto from = std::min(select_start_position, select_end_position),
+        to = std::max(select_start_position, select_end_position);
+
+    return buffer.text(from, to - from);
+}
+
+void editor::select_all()
+{
+    select_start_position = 0;
+    select_end_position = buffer.size();
+    cursor_position = buffer.size();
+
+    redraw();
+}
+
+size_t editor::prev_position(size_t position) const
+{
+    if (position == 0)
+    {
+        return 0;
+    }
+
+    --position;
+    while (position != 0 && (static_cast<uint8_t>(buffer.at(position)) & 0xC0) == 0x80)
+    {
+        --position;
+    }
+    return position;
+}
+
+size_t editor::next_position(size_t position) const
+{
+    if (position >= buffer.size())
+    {
+        return buffer.size();
+    }
+
+    ++position;
+    while (position < buffer.size() && (static_cast<uint8_t>(buffer.at(position)) & 0xC0) == 0x80)
+    {
+        ++position;
+    }
+    return position;
+}
+
+void editor::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        /// The scrollbar is added to the window before the control, so the control takes its events and gives them to it
+        if (vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+        {
+            if (!mouse_on_slider)
+            {
+                mouse_on_slider = true;
+
+                event sev = ev;
+                sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+                return vert_scroll->receive_control_events(sev);
+            }
+
+            return vert_scroll->receive_control_events(ev);
+        }
+        else if (mouse_on_slider)
+        {
+            mouse_on_slider = false;
+
+            event sev = ev;
+            sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+            vert_scroll->receive_control_events(sev);
+        }
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::enter:
+            {
+                auto parent__ = parent_.lock();
+                if (parent__)
+                {
+                    set_cursor(parent__->context(), cursor::ibeam);
+                }
+            }
+            break;
+            case mouse_event_type::leave:
+            {
+                auto parent__ = parent_.lock();
+                if (parent__)
+                {
+                    set_cursor(parent__->context(), cursor::default_);
+                }
+            }
+            break;
+            case mouse_event_type::left_down:
+                preferred_x = -1;
+                move_cursor(position_at(ev.mouse_event_.x, ev.mouse_event_.y), false);
+
+                selecting = true;
+                select_start_position = cursor_position;
+                select_end_position = cursor_position;
+            break;
+            case mouse_event_type::left_up:
+                selecting = false;
+            break;
+            case mouse_event_type::move:
+                if (selecting)
+                {
+                    auto position = position_at(ev.mouse_event_.x, ev.mouse_event_.y);
+                    if (position != cursor_position)
+                    {
+                        cursor_position = position;
+                        select_end_position = position;
+
+                        make_cursor_visible();
+                        redraw();
+                    }
+                }
+            break;
+            case mouse_event_type::left_double:
+            {
+                /// Selects the word under the cursor
+                auto line = buffer.line_of(cursor_position);
+                auto start = buffer.line_start(line);
+                auto text_ = buffer.line(line);
+
+                auto from = cursor_position - start, to = from;
+                while (from != 0 && text_[from - 1] != ' ' && text_[from - 1] != '\t')
+                {
+                    --from;
+                }
+                while (to != text_.size() && text_[to] != ' ' && text_[to] != '\t')
+                {
+                    ++to;
+                }
+
+                select_start_position = start + from;
+                select_end_position = start + to;
+                cursor_position = select_end_position;
+
+                redraw();
+            }
+            break;
+            case mouse_event_type::wheel:
+                if (ev.mouse_event_.wheel_delta > 0)
+                {
+                    vert_scroll->scroll_up();
+                }
+                else
+                {
+                    vert_scroll->scroll_down();
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        switch (ev.keyboard_event_.type)
+        {
+            case keyboard_event_type::down:
+            {
+                timer_.stop();
+                cursor_visible = true;
+
+                auto shift_pressed = is_shift(ev.keyboard_event_);
+                auto line = buffer.line_of(cursor_position);
+                auto lines_on_page = line_height > 0 ? std::max(text_area().height() / line_height, 1) : 1;
+
+                /// Up and down keep the x of the cursor, other keys forget it
+                auto vertical_move = [this, shift_pressed](int32_t line_) {
+                    auto gr = measurer();
+                    if (!gr)
+                    {
+                        return;
+                    }
+
+                    if (preferred_x == -1)
+                    {
+                        preferred_x = column_x(*gr, buffer.line_of(cursor_position), cursor_position);
+                    }
+
+                    line_ = std::min(std::max(line_, 0), buffer.line_count() - 1);
+                    move_cursor(column_at(*gr, line_, preferred_x), shift_pressed);
+                };
+
+                switch (ev.keyboard_event_.key[0])
+                {
+                    case vk_left: case vk_nleft:
+                        preferred_x = -1;
+                        move_cursor(prev_position(cursor_position), shift_pressed);
+                    break;
+                    case vk_right: case vk_nright:
+                        preferred_x = -1;
+                        move_cursor(next_position(cursor_position), shift_pressed);
+                    break;
+                    case vk_up: case vk_nup:
+                        vertical_move(line - 1);
+                    break;
+                    case vk_down: case vk_ndown:
+                        vertical_move(line + 1);
+                    break;
+                    case vk_page_up: case vk_npage_up:
+                        vertical_move(line - lines_on_page);
+                    break;
+                    case vk_page_down: case vk_npage_down:
+                        vertical_move(line + lines_on_page);
+                    break;
+                    case vk_home: case vk_nhome:
+                        preferred_x = -1;
+                        move_cursor(buffer.line_start(line), shift_pressed);
+                    break;
+                    case vk_end: case vk_nend:
+                        preferred_x = -1;
+                        move_cursor(buffer.line_end(line), shift_pressed);
+                    break;
+                    case vk_back:
+                        if (!readonly_)
+                        {
+                            preferred_x = -1;
+                            if (!clear_selected_text() && cursor_position > 0)
+                            {
+                                auto prev = prev_position(cursor_position);
+                                replace(prev, cursor_position - prev, "");
+                                cursor_position = prev;
+                            }
+                            changed();
+                        }
+                    break;
+                    case vk_del:
+                        if (!readonly_)
+                        {
+                            preferred_x = -1;
+                            if (!clear_selected_text() && cursor_position < buffer.size())
+                            {
+                                replace(cursor_position, next_position(cursor_position) - cursor_position, "");
+                            }
+                            changed();
+                        }
+                    break;
+                    case vk_return: case vk_rreturn:
+                        if (!readonly_)
+                        {
+                            preferred_x = -1;
+                            clear_selected_text();
+                            replace(cursor_position, 0, "\n");
+                            ++cursor_position;
+                            changed();
+                        }
+                    break;
+                }
+            }
+            break;
+            case keyboard_event_type::up:
+                timer_.start(500);
+            break;
+            case keyboard_event_type::key:
+                if (ev.keyboard_event_.key[0] == 0x3)       // ctrl + c
+                {
+                    return buffer_copy();
+                }
+                else if (ev.keyboard_event_.key[0] == 0x18) // ctrl + x
+                {
+                    return buffer_cut();
+                }
+                else if (ev.keyboard_event_.key[0] == 0x16) // ctrl + v
+                {
+                    return buffer_paste();
+                }
+                else if (ev.keyboard_event_.key[0] == 0x1)  // ctrl + a
+                {
+                    return select_all();
+                }
+
+                if (readonly_ || (static_cast<uint8_t>(ev.keyboard_event_.key[0]) < 0x20 && ev.keyboard_event_.key[0] != vk_tab) ||
+                    ev.keyboard_event_.key[0] == 0x7f)
+                {
+                    return;
+                }
+
+                preferred_x = -1;
+                clear_selected_text();
+
+                {
+                    auto text_ = ev.keyboard_event_.key[0] != vk_tab ? std::string(ev.keyboard_event_.key, ev.keyboard_event_.key_size) : std::string("    ");
+                    replace(cursor_position, 0, text_);
+                    cursor_position += text_.size();
+                }
+
+                changed();
+            break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                cursor_visible = true;
+
+                redraw();
+
+                timer_.start(500);
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                cursor_visible = false;
+
+                timer_.stop();
+
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+void editor::receive_plain_events(const event &ev)
+{
+    if (ev.type == event_type::mouse && ev.mouse_event_.type == mouse_event_type::left_up)
+    {
+        selecting = false;
+    }
+}
+
+void editor::on_scroll(scroll_state, int32_t)
+{
+    redraw();
+}
+
+void editor::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    vert_scroll->set_position({ position_.right - editor_scrollbar_width - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width });
+
+    update_scroll_area();
+}
+
+rect editor::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void editor::set_parent(std::shared_ptr<window> window_)
+{
+    parent_ = window_;
+    my_control_sid = window_->subscribe(std::bind(&editor::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+    my_plain_sid = window_->subscribe(std::bind(&editor::receive_plain_events, this, std::placeholders::_1), event_type::mouse);
+
+    window_->add_control(vert_scroll, { 0 });
+}
+
+std::weak_ptr<window> editor::parent() const
+{
+    return parent_;
+}
+
+void editor::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+
+        parent__->unsubscribe(my_control_sid);
+        parent__->unsubscribe(my_plain_sid);
+    }
+    parent_.reset();
+
+    measure_graphic.release();
+    measure_graphic_ready = false;
+}
+
+void editor::set_topmost(bool yes)
+{
+    topmost_ = yes;
+}
+
+bool editor::topmost() const
+{
+    return topmost_;
+}
+
+bool editor::focused() const
+{
+    return focused_;
+}
+
+bool editor::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error editor::get_error() const
+{
+    return {};
+}
+
+void editor::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    tcn_keys.reset();
+    update_theme(theme_);
+}
+
+void editor::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    vert_scroll->update_theme(theme_);
+
+    /// The font can be other
+    std::fill(line_widths.begin(), line_widths.end(), -1);
+
+    redraw();
+}
+
+void editor::show()
+{
+    showed_ = true;
+    vert_scroll->show();
+    redraw();
+}
+
+void editor::hide()
+{
+    showed_ = false;
+    vert_scroll->hide();
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->redraw(position(), true);
+    }
+}
+
+bool editor::showed() const
+{
+    return showed_;
+}
+
+void editor::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void editor::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool editor::enabled() const
+{
+    return enabled_;
+}
+
+void editor::set_text(std::string text__)
+{
+    buffer.assign(std::move(text__));
+    line_widths.assign(buffer.line_count(), -1);
+
+    cursor_position = 0;
+    select_start_position = 0;
+    select_end_position = 0;
+    left_shift = 0;
+
+    vert_scroll->set_scroll_pos(0);
+
+    changed();
+}
+
+std::string editor::text() const
+{
+    return buffer.text();
+}
+
+void editor::set_readonly(bool yes)
+{
+    readonly_ = yes;
+}
+
+bool editor::readonly() const
+{
+    return readonly_;
+}
+
+int32_t editor::line_count() const
+{
+    return buffer.line_count();
+}
+
+void editor::go_to_line(int32_t line)
+{
+    preferred_x = -1;
+    move_cursor(buffer.line_start(std::min(std::max(line, 0), buffer.line_count() - 1)), false);
+}
+
+void editor::set_change_callback(std::function<void()> change_callback_)
+{
+    change_callback = change_callback_;
+}
+
+void editor::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+/// Only the cursor column is damaged, the window clips the drawing of the control to it
+void editor::redraw_cursor()
+{
+    cursor_visible = !cursor_visible;
+
+    auto parent__ = parent_.lock();
+    auto gr = measurer();
+    if (!showed_ || !parent__ || !gr || line_height <= 0)
+    {
+        return;
+    }
+
+    auto area = text_area();
+    auto line = buffer.line_of(cursor_position);
+
+    auto left = area.left - left_shift + column_x(*gr, line, cursor_position);
+    auto top = area.top + line * line_height - vert_scroll->get_scroll_pos();
+
+    parent__->redraw({ left - 1, std::max(top, area.top), left + 2, std::min(top + line_height, area.bottom) });
+}
+
+void editor::buffer_copy()
+{
+    if (!parent_.lock() || select_start_position == select_end_position)
+    {
+        return;
+    }
+
+    clipboard_put(selected_text(), parent_.lock()->context());
+}
+
+void editor::buffer_cut()
+{
+    if (select_start_position == select_end_position || readonly_)
+    {
+        return;
+    }
+
+    buffer_copy();
+
+    clear_selected_text();
+
+    changed();
+}
+
+void editor::buffer_paste()
+{
+    if (!parent_.lock() || readonly_ || !is_text_in_clipboard(parent_.lock()->context()))
+    {
+        return;
+    }
+
+    clear_selected_text();
+
+    auto paste_string = clipboard_get_text(parent_.lock()->context());
+    paste_string.erase(std::remove(paste_string.begin(), paste_string.end(), '\r'), paste_string.end());
+
+    replace(cursor_position, 0, paste_string);
+    cursor_position += paste_string.size();
+
+    changed();
+}
+
+}
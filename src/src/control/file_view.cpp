@@ -0,0 +1,681 @@
+#include <wui/control/file_view.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/framework/framework.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace wui
+{
+
+static const int32_t file_view_horizontal_indent = 5;
+static const int32_t file_view_vertical_indent = 2;
+static const int32_t file_view_scrollbar_width = 14;
+static const int32_t file_view_wheel_lines = 3;
+static const size_t file_view_max_shown_line = 1024; /// the rest of the longer line is not drawn
+static const uint64_t file_view_index_part = 16 * 1024 * 1024; /// the bytes indexed between the posts to the UI thread
+
+/// Cuts the line to draw on the codepoint boundary
+static std::string_view shown_part(std::string_view line_)
+{
+    if (line_.size() > file_view_max_shown_line)
+    {
+        auto size = file_view_max_shown_line;
+        while (size != 0 && (static_cast<uint8_t>(line_[size]) & 0xC0) == 0x80)
+        {
+            --size;
+        }
+        line_ = line_.substr(0, size);
+    }
+    return line_;
+}
+
+file_view::file_view(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : file(),
+    line_starts(),
+    lines(0),
+    indexed_size(0),
+    indexed_(false),
+    marked_line(-1), pending_line(-1),
+    pending_offset(UINT64_MAX),
+    index_callback(),
+    tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
+    theme_(theme__),
+    position_(),
+    parent_(),
+    my_control_sid(),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&file_view::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    line_height(0),
+    showed_(true), enabled_(true), topmost_(false), focused_(false),
+    mouse_on_slider(false),
+    worker(),
+    stopping(false),
+    generation(0),
+    alive(std::make_shared<file_view*>(this)),
+    err{}
+{
+}
+
+file_view::~file_view()
+{
+    *alive = nullptr;
+
+    close();
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void file_view::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.width() == 0 || position_.height() == 0)
+    {
+        return;
+    }
+
+    auto control_pos = position();
+
+    gr.draw_rect(control_pos,
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
+
+    vert_scroll->draw(gr, {});
+
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
+
+    auto line_height_ = gr.measure_text("Qq", font_).height() + file_view_vertical_indent;
+    if (line_height_ != line_height)
+    {
+        line_height = line_height_;
+        update_scroll_area();
+    }
+
+    auto area = text_area();
+    if (area.width() <= 0 || area.height() <= 0 || line_height <= 0 || lines == 0)
+    {
+        return;
+    }
+
+    gr.push_clip(area);
+
+    /// Only the lines under the clip are found in the file and drawn, the next line starts after the previous one
+    auto clip_ = gr.clip();
+    auto first_row = std::max((clip_.top - area.top) / line_height, 0),
+        last_row = (clip_.bottom - area.top) / line_height + 1;
+
+    auto first = static_cast<int64_t>(vert_scroll->get_scroll_pos()) + first_row,
+        last = std::min(static_cast<int64_t>(vert_scroll->get_scroll_pos()) + last_row, lines);
+
+    auto text_color = theme_color(tcn_keys[tk_title_text], theme_);
+
+    if (first < last)
+    {
+        auto start = line_start(first);
+        for (auto n = first; n < last; ++n)
+        {
+            auto end = line_end(start);
+            auto top = area.top + static_cast<int32_t>(n - first + first_row) * line_height;
+
+            if (n == marked_line)
+            {
+                gr.draw_rect({ area.left - file_view_horizontal_indent, top, area.right, top + line_height }, theme_color(tcn_keys[tk_active_item], theme_));
+            }
+
+            auto line_ = std::string_view(file.data() + start, static_cast<size_t>(end - start));
+            if (!line_.empty() && line_.back() == '\r')
+            {
+                line_.remove_suffix(1);
+            }
+
+            gr.draw_text({ area.left, top + file_view_vertical_indent / 2 }, std::string(shown_part(line_)), text_color, font_);
+
+            start = end + 1;
+        }
+    }
+
+    gr.pop_clip();
+}
+
+rect file_view::text_area() const
+{
+    auto control_pos = position();
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    return { control_pos.left + border_width + file_view_horizontal_indent,
+        control_pos.top + border_width + file_view_vertical_indent,
+        control_pos.right - border_width - file_view_scrollbar_width,
+        control_pos.bottom - border_width - file_view_vertical_indent };
+}
+
+int32_t file_view::lines_on_page() const
+{
+    return line_height > 0 ? std::max(text_area().height() / line_height, 1) : 1;
+}
+
+void file_view::update_scroll_area()
+{
+    vert_scroll->set_area(static_cast<int32_t>(std::min(std::max(lines - lines_on_page(), static_cast<int64_t>(0)), static_cast<int64_t>(INT32_MAX))));
+}
+
+void file_view::scroll_to(int64_t line_)
+{
+    marked_line = line_;
+    vert_scroll->set_scroll_pos(static_cast<int32_t>(std::min(line_, static_cast<int64_t>(INT32_MAX))));
+    redraw();
+}
+
+/// Goes from the nearest indexed line, so it scans index_step lines at most
+uint64_t file_view::line_start(int64_t n) const
+{
+    auto start = line_starts[static_cast<size_t>(n / index_step)];
+    for (auto i = n % index_step; i != 0; --i)
+    {
+        start = line_end(start) + 1;
+    }
+    return start;
+}
+
+uint64_t file_view::line_end(uint64_t start) const
+{
+    if (start >= file.size())
+    {
+        return file.size();
+    }
+
+    auto end = static_cast<const char*>(memchr(file.data() + start, '\n', static_cast<size_t>(file.size() - start)));
+
+    return end ? static_cast<uint64_t>(end - file.data()) : file.size();
+}
+
+/// memchr is vectorized by the C runtimes, so the worker scans the file at the memory speed
+void file_view::work(uint64_t generation_)
+{
+    auto data = file.data();
+    auto size = file.size();
+
+    uint64_t scanned = 0;
+    int64_t newlines = 0;
+
+    while (scanned < size && !stopping.load(std::memory_order_relaxed))
+    {
+        auto end = std::min(scanned + file_view_index_part, size);
+
+        std::vector<uint64_t> starts;
+
+        auto p = data + scanned;
+        while (auto found = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(data + end - p))))
+        {
+            p = found + 1;
+            if (++newlines % index_step == 0)
+            {
+                starts.emplace_back(static_cast<uint64_t>(p - data));
+            }
+        }
+        scanned = end;
+
+        auto done = scanned == size;
+        auto lines_ = newlines + (done && data[size - 1] != '\n' ? 1 : 0); /// the last line is counted when it is known to be full
+
+        auto owner = alive;
+        auto starts_ = std::make_shared<std::vector<uint64_t>>(std::move(starts));
+        framework::post([owner, generation_, starts_, lines_, scanned, done]() {
+            if (*owner)
+            {
+                (*owner)->indexed_part(generation_, std::move(*starts_), lines_, scanned, done);
+            }
+        });
+    }
+}
+
+void file_view::indexed_part(uint64_t generation_, std::vector<uint64_t> &&starts, int64_t lines_, uint64_t scanned, bool done)
+{
+    if (generation_ != generation)
+    {
+        return;
+    }
+
+    auto was_shown = lines < static_cast<int64_t>(vert_scroll->get_scroll_pos()) + lines_on_page();
+
+    line_starts.insert(line_starts.end(), starts.begin(), starts.end());
+    lines = lines_;
+    indexed_size = scanned;
+    indexed_ = done;
+
+    update_scroll_area();
+    apply_pending();
+
+    /// The scrollbar redraws itself, the lines are redrawn only if the new ones get on the page
+    if (was_shown)
+    {
+        redraw();
+    }
+
+    if (index_callback)
+    {
+        index_callback(lines, indexed_);
+    }
+}
+
+void file_view::apply_pending()
+{
+    if (pending_offset != UINT64_MAX && (pending_offset < indexed_size || indexed_))
+    {
+        auto offset = pending_offset;
+        pending_offset = UINT64_MAX;
+        go_to_offset(offset);
+    }
+
+    if (pending_line != -1 && (pending_line < lines || indexed_))
+    {
+        auto line_ = pending_line;
+        pending_line = -1;
+        go_to_line(line_);
+    }
+}
+
+void file_view::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    if (ev.type == event_type::mouse)
+    {
+        /// The scrollbar is added to the window before the control, so the control takes its events and gives them to it
+        if (vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+        {
+            if (!mouse_on_slider)
+            {
+                mouse_on_slider = true;
+
+                event sev = ev;
+                sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+                return vert_scroll->receive_control_events(sev);
+            }
+
+            return vert_scroll->receive_control_events(ev);
+        }
+        else if (mouse_on_slider)
+        {
+            mouse_on_slider = false;
+
+            event sev = ev;
+            sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+            vert_scroll->receive_control_events(sev);
+        }
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::wheel:
+                vert_scroll->set_scroll_pos(ev.mouse_event_.wheel_delta > 0 ? scroll_pos - file_view_wheel_lines : scroll_pos + file_view_wheel_lines);
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        switch (ev.keyboard_event_.type)
+        {
+            case keyboard_event_type::down:
+                switch (ev.keyboard_event_.key[0])
+                {
+                    case vk_up: case vk_nup:
+                        vert_scroll->set_scroll_pos(scroll_pos - 1);
+                    break;
+                    case vk_down: case vk_ndown:
+                        vert_scroll->set_scroll_pos(scroll_pos + 1);
+                    break;
+                    case vk_page_up: case vk_npage_up:
+                        vert_scroll->set_scroll_pos(scroll_pos - lines_on_page());
+                    break;
+                    case vk_page_down: case vk_npage_down:
+                        vert_scroll->set_scroll_pos(scroll_pos + lines_on_page());
+                    break;
+                    case vk_home: case vk_nhome:
+                        vert_scroll->set_scroll_pos(0);
+                    break;
+                    case vk_end: case vk_nend:
+                        vert_scroll->set_scroll_pos(INT32_MAX);
+                    break;
+                    default: break;
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+void file_view::on_scroll(scroll_state, int32_t)
+{
+    redraw();
+}
+
+void file_view::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    vert_scroll->set_position({ position_.right - file_view_scrollbar_width - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width });
+
+    update_scroll_area();
+}
+
+rect file_view::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void file_view::set_parent(std::shared_ptr<window> window_)
+{
+    parent_ = window_;
+    my_control_sid = window_->subscribe(std::bind(&file_view::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+
+    window_->add_control(vert_scroll, { 0 });
+}
+
+std::weak_ptr<window> file_view::parent() const
+{
+    return parent_;
+}
+
+void file_view::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->unsubscribe(my_control_sid);
+    }
+    parent_.reset();
+}
+
+void file_view::set_topmost(bool yes)
+{
+    topmost_ = yes;
+}
+
+bool file_view::topmost() const
+{
+    return topmost_;
+}
+
+bool file_view::focused() const
+{
+    return focused_;
+}
+
+bool file_view::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error file_view::get_error() const
+{
+    return err;
+}
+
+void file_view::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    tcn_keys.reset();
+    update_theme(theme_);
+}
+
+void file_view::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    vert_scroll->update_theme(theme_);
+
+    redraw();
+}
+
+void file_view::show()
+{
+    showed_ = true;
+    vert_scroll->show();
+    redraw();
+}
+
+void file_view::hide()
+{
+    showed_ = false;
+    vert_scroll->hide();
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->redraw(position(), true);
+    }
+}
+
+bool file_view::showed() const
+{
+    return showed_;
+}
+
+void file_view::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void file_view::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool file_view::enabled() const
+{
+    return enabled_;
+}
+
+bool file_view::open(std::string_view file_name)
+{
+    close();
+    err.reset();
+
+    if (!file.open(file_name, true))
+    {
+        err = file.get_error();
+        return false;
+    }
+
+    line_starts.assign(1, 0);
+
+    if (file.size() == 0)
+    {
+        indexed_ = true;
+    }
+    else
+    {
+        worker = std::thread(&file_view::work, this, generation);
+    }
+
+    redraw();
+
+    return true;
+}
+
+void file_view::close()
+{
+    stopping = true;
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    stopping = false;
+
+    ++generation;
+
+    file.close();
+
+    line_starts.clear();
+    lines = 0;
+    indexed_size = 0;
+    indexed_ = false;
+
+    marked_line = -1;
+    pending_line = -1;
+    pending_offset = UINT64_MAX;
+
+    vert_scroll->set_scroll_pos(0);
+    update_scroll_area();
+
+    redraw();
+}
+
+int64_t file_view::line_count() const
+{
+    return lines;
+}
+
+bool file_view::indexed() const
+{
+    return indexed_;
+}
+
+void file_view::go_to_line(int64_t line_)
+{
+    if (line_ >= lines && !indexed_)
+    {
+        pending_line = line_;
+        pending_offset = UINT64_MAX;
+        return;
+    }
+
+    if (lines != 0)
+    {
+        scroll_to(std::min(std::max(line_, static_cast<int64_t>(0)), lines - 1));
+    }
+}
+
+void file_view::go_to_offset(uint64_t offset)
+{
+    auto line_ = line_of(offset);
+    if (line_ == -1)
+    {
+        if (!indexed_)
+        {
+            pending_offset = offset;
+            pending_line = -1;
+        }
+        return;
+    }
+
+    scroll_to(line_);
+}
+
+std::string_view file_view::line(int64_t n) const
+{
+    if (n < 0 || n >= lines)
+    {
+        return {};
+    }
+
+    auto start = line_start(n);
+    auto line_ = std::string_view(file.data() + start, static_cast<size_t>(line_end(start) - start));
+    if (!line_.empty() && line_.back() == '\r')
+    {
+        line_.remove_suffix(1);
+    }
+    return line_;
+}
+
+/// Finds the nearest indexed line before the offset and counts the line breaks from it
+int64_t file_view::line_of(uint64_t offset) const
+{
+    if (file.size() == 0)
+    {
+        return -1;
+    }
+
+    offset = std::min(offset, file.size() - 1);
+    if (offset >= indexed_size && !indexed_)
+    {
+        return -1;
+    }
+
+    auto block = std::upper_bound(line_starts.begin(), line_starts.end(), offset) - line_starts.begin() - 1;
+    auto n = static_cast<int64_t>(block) * index_step;
+
+    auto p = file.data() + line_starts[block], end = file.data() + offset;
+    while (auto found = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p))))
+    {
+        p = found + 1;
+        ++n;
+    }
+
+    if (n >= lines && !indexed_)
+    {
+        return -1; /// the line is not full yet
+    }
+
+    return std::min(n, lines - 1);
+}
+
+void file_view::set_index_callback(std::function<void(int64_t, bool)> index_callback_)
+{
+    index_callback = index_callback_;
+}
+
+void file_view::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
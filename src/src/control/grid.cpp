@@ -0,0 +1,744 @@
+#include <wui/control/grid.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static const int32_t grid_scrollbar_width = 14;
+
+grid::grid(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
+    theme_(theme__),
+    position_(),
+    parent_(),
+    my_control_sid(),
+    rows(), columns(),
+    default_row_height(24), default_column_width(100),
+    frozen_rows(0), frozen_columns(0),
+    selected_row(-1), selected_column(-1),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&grid::on_vert_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    hor_scroll(std::make_shared<scroll>(0, 0, orientation::horizontal, std::bind(&grid::on_hor_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    mouse_on_scroll(),
+    showed_(true), enabled_(true), topmost_(false), focused_(false),
+    draw_callback(),
+    cell_click_callback(),
+    cell_change_callback()
+{
+}
+
+grid::~grid()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(hor_scroll);
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void grid::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.width() == 0 || position_.height() == 0)
+    {
+        return;
+    }
+
+    gr.draw_rect(position(),
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
+
+    vert_scroll->draw(gr, {});
+    hor_scroll->draw(gr, {});
+
+    draw_region(gr, false, false);
+    draw_region(gr, false, true);
+    draw_region(gr, true, false);
+    draw_region(gr, true, true);
+}
+
+rect grid::cells_area() const
+{
+    auto control_pos = position();
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    return { control_pos.left + border_width,
+        control_pos.top + border_width,
+        std::max(control_pos.right - border_width - grid_scrollbar_width, control_pos.left + border_width),
+        std::max(control_pos.bottom - border_width - grid_scrollbar_width, control_pos.top + border_width) };
+}
+
+int32_t grid::frozen_height() const
+{
+    return rows.top(frozen_rows);
+}
+
+int32_t grid::frozen_width() const
+{
+    return columns.top(frozen_columns);
+}
+
+rect grid::region(bool scrolled_rows, bool scrolled_columns) const
+{
+    auto area = cells_area();
+    auto fh = std::min(frozen_height(), area.height()), fw = std::min(frozen_width(), area.width());
+
+    return { scrolled_columns ? area.left + fw : area.left,
+        scrolled_rows ? area.top + fh : area.top,
+        scrolled_columns ? area.right : area.left + fw,
+        scrolled_rows ? area.bottom : area.top + fh };
+}
+
+rect grid::cell_rect(int32_t row, int32_t column) const
+{
+    auto area = cells_area();
+
+    auto left = area.left + columns.top(column) - (column >= frozen_columns ? hor_scroll->get_scroll_pos() : 0);
+    auto top = area.top + rows.top(row) - (row >= frozen_rows ? vert_scroll->get_scroll_pos() : 0);
+
+    return { left, top, left + columns.height(column), top + rows.height(row) };
+}
+
+int32_t grid::row_at(int32_t y) const
+{
+    auto area = cells_area();
+
+    auto y_ = y - area.top;
+    if (y_ < 0 || y_ >= area.height())
+    {
+        return -1;
+    }
+
+    auto row = y_ < frozen_height() ? rows.item_at(y_) : rows.item_at(y_ + vert_scroll->get_scroll_pos());
+
+    return row < rows.count() ? row : -1;
+}
+
+int32_t grid::column_at(int32_t x) const
+{
+    auto area = cells_area();
+
+    auto x_ = x - area.left;
+    if (x_ < 0 || x_ >= area.width())
+    {
+        return -1;
+    }
+
+    auto column = x_ < frozen_width() ? columns.item_at(x_) : columns.item_at(x_ + hor_scroll->get_scroll_pos());
+
+    return column < columns.count() ? column : -1;
+}
+
+/// The first and the last cells under the clip are found on the prefix sums, so the cost depends on the shown cells only
+void grid::draw_region(graphic &gr, bool scrolled_rows, bool scrolled_columns)
+{
+    auto region_ = region(scrolled_rows, scrolled_columns).intersection(gr.clip());
+    if (region_.width() == 0 || region_.height() == 0)
+    {
+        return;
+    }
+
+    auto area = cells_area();
+    auto scroll_y = scrolled_rows ? vert_scroll->get_scroll_pos() : 0,
+        scroll_x = scrolled_columns ? hor_scroll->get_scroll_pos() : 0;
+
+    auto first_row = std::max(rows.item_at(region_.top - area.top + scroll_y), scrolled_rows ? frozen_rows : 0),
+        last_row = std::min({ rows.item_at(region_.bottom - 1 - area.top + scroll_y), rows.count() - 1, scrolled_rows ? rows.count() - 1 : frozen_rows - 1 });
+    auto first_column = std::max(columns.item_at(region_.left - area.left + scroll_x), scrolled_columns ? frozen_columns : 0),
+        last_column = std::min({ columns.item_at(region_.right - 1 - area.left + scroll_x), columns.count() - 1, scrolled_columns ? columns.count() - 1 : frozen_columns - 1 });
+
+    if (first_row > last_row || first_column > last_column)
+    {
+        return;
+    }
+
+    gr.push_clip(region_);
+
+    auto frozen = !scrolled_rows || !scrolled_columns;
+
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        for (auto column = first_column; column <= last_column; ++column)
+        {
+            auto cell = cell_rect(row, column);
+
+            auto state = frozen ? cell_state::frozen : (row == selected_row && column == selected_column ? cell_state::selected : cell_state::normal);
+            if (state == cell_state::frozen)
+            {
+                gr.draw_rect(cell, theme_color(tcn_keys[tk_title], theme_));
+            }
+            else if (state == cell_state::selected)
+            {
+                gr.draw_rect(cell, theme_color(tcn_keys[tk_selected_item], theme_));
+            }
+
+            if (draw_callback)
+            {
+                draw_callback(gr, row, column, cell, state);
+            }
+        }
+    }
+
+    /// The grid lines are on the last pixels of the cells, so the repaint of a cell repaints its lines too
+    auto line_color = theme_color(tcn_keys[tk_border], theme_);
+    for (auto row = first_row; row <= last_row; ++row)
+    {
+        auto y = cell_rect(row, first_column).bottom - 1;
+        gr.draw_line({ region_.left, y, region_.right, y }, line_color);
+    }
+    for (auto column = first_column; column <= last_column; ++column)
+    {
+        auto x = cell_rect(first_row, column).right - 1;
+        gr.draw_line({ x, region_.top, x, region_.bottom }, line_color);
+    }
+
+    gr.pop_clip();
+}
+
+void grid::redraw_region_cells(int32_t first_row, int32_t first_column, int32_t last_row, int32_t last_column)
+{
+    auto parent__ = parent_.lock();
+    if (!showed_ || !parent__ || first_row > last_row || first_column > last_column)
+    {
+        return;
+    }
+
+    auto first = cell_rect(first_row, first_column), last = cell_rect(last_row, last_column);
+
+    auto damaged = rect{ first.left, first.top, last.right, last.bottom }.intersection(region(first_row >= frozen_rows, first_column >= frozen_columns));
+    if (damaged.width() != 0 && damaged.height() != 0)
+    {
+        parent__->redraw(damaged);
+    }
+}
+
+void grid::update_scroll_areas()
+{
+    auto area = cells_area();
+
+    vert_scroll->set_area(std::max(rows.total() - area.height(), 0));
+    hor_scroll->set_area(std::max(columns.total() - area.width(), 0));
+}
+
+void grid::move_selection(int32_t row, int32_t column)
+{
+    if (rows.count() <= frozen_rows || columns.count() <= frozen_columns)
+    {
+        return;
+    }
+
+    row = std::min(std::max(row, frozen_rows), rows.count() - 1);
+    column = std::min(std::max(column, frozen_columns), columns.count() - 1);
+
+    if (row == selected_row && column == selected_column)
+    {
+        return;
+    }
+
+    auto old_row = selected_row, old_column = selected_column;
+    selected_row = row;
+    selected_column = column;
+
+    update_cell(old_row, old_column);
+    update_cell(selected_row, selected_column);
+
+    scroll_to_cell(selected_row, selected_column);
+
+    if (cell_change_callback)
+    {
+        cell_change_callback(selected_row, selected_column);
+    }
+}
+
+void grid::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        /// The scrollbars are added to the window before the control, so the control takes their events and passes them on
+        auto on_scroll = vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y) ? vert_scroll :
+            (hor_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y) ? hor_scroll : nullptr);
+
+        if (on_scroll != mouse_on_scroll)
+        {
+            event sev = ev;
+            if (mouse_on_scroll)
+            {
+                sev.mouse_event_.type = wui::mouse_event_type::leave;
+                mouse_on_scroll->receive_control_events(sev);
+            }
+            mouse_on_scroll = on_scroll;
+            if (mouse_on_scroll)
+            {
+                sev.mouse_event_.type = wui::mouse_event_type::enter;
+                return mouse_on_scroll->receive_control_events(sev);
+            }
+        }
+
+        if (mouse_on_scroll)
+        {
+            return mouse_on_scroll->receive_control_events(ev);
+        }
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::left_down:
+            {
+                auto row = row_at(ev.mouse_event_.y), column = column_at(ev.mouse_event_.x);
+                if (row != -1 && column != -1)
+                {
+                    if (row >= frozen_rows && column >= frozen_columns)
+                    {
+                        move_selection(row, column);
+                    }
+
+                    if (cell_click_callback)
+                    {
+                        cell_click_callback(row, column);
+                    }
+                }
+            }
+            break;
+            case mouse_event_type::wheel:
+                if (ev.mouse_event_.wheel_delta > 0)
+                {
+                    vert_scroll->scroll_up();
+                }
+                else
+                {
+                    vert_scroll->scroll_down();
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        switch (ev.keyboard_event_.type)
+        {
+            case keyboard_event_type::down:
+            {
+                auto page = std::max(region(true, true).height() / std::max(default_row_height, 1), 1);
+
+                switch (ev.keyboard_event_.key[0])
+                {
+                    case vk_left: case vk_nleft:
+                        move_selection(selected_row, selected_column - 1);
+                    break;
+                    case vk_right: case vk_nright:
+                        move_selection(selected_row, selected_column + 1);
+                    break;
+                    case vk_up: case vk_nup:
+                        move_selection(selected_row - 1, selected_column);
+                    break;
+                    case vk_down: case vk_ndown:
+                        move_selection(selected_row + 1, selected_column);
+                    break;
+                    case vk_page_up: case vk_npage_up:
+                        move_selection(selected_row - page, selected_column);
+                    break;
+                    case vk_page_down: case vk_npage_down:
+                        move_selection(selected_row + page, selected_column);
+                    break;
+                    case vk_home: case vk_nhome:
+                        move_selection(frozen_rows, selected_column);
+                    break;
+                    case vk_end: case vk_nend:
+                        move_selection(rows.count() - 1, selected_column);
+                    break;
+                    default: break;
+                }
+            }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+/// The frozen rows are not moved by the vertical scroll and the frozen columns by the horizontal one, so they are not repainted
+void grid::on_vert_scroll(scroll_state, int32_t)
+{
+    auto parent__ = parent_.lock();
+    if (showed_ && parent__)
+    {
+        auto area = region(true, false);
+        area.right = cells_area().right;
+        parent__->redraw(area);
+    }
+}
+
+void grid::on_hor_scroll(scroll_state, int32_t)
+{
+    auto parent__ = parent_.lock();
+    if (showed_ && parent__)
+    {
+        auto area = region(false, true);
+        area.bottom = cells_area().bottom;
+        parent__->redraw(area);
+    }
+}
+
+void grid::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    vert_scroll->set_position({ position_.right - grid_scrollbar_width - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - grid_scrollbar_width - border_width });
+
+    hor_scroll->set_position({ position_.left + border_width,
+        position_.bottom - grid_scrollbar_width - border_width,
+        position_.right - grid_scrollbar_width - border_width,
+        position_.bottom - border_width });
+
+    update_scroll_areas();
+}
+
+rect grid::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void grid::set_parent(std::shared_ptr<window> window_)
+{
+    parent_ = window_;
+    my_control_sid = window_->subscribe(std::bind(&grid::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+
+    window_->add_control(vert_scroll, { 0 });
+    window_->add_control(hor_scroll, { 0 });
+}
+
+std::weak_ptr<window> grid::parent() const
+{
+    return parent_;
+}
+
+void grid::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(hor_scroll);
+        parent__->unsubscribe(my_control_sid);
+    }
+    parent_.reset();
+}
+
+void grid::set_topmost(bool yes)
+{
+    topmost_ = yes;
+}
+
+bool grid::topmost() const
+{
+    return topmost_;
+}
+
+bool grid::focused() const
+{
+    return focused_;
+}
+
+bool grid::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error grid::get_error() const
+{
+    return {};
+}
+
+void grid::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    tcn_keys.reset();
+    update_theme(theme_);
+}
+
+void grid::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    vert_scroll->update_theme(theme_);
+    hor_scroll->update_theme(theme_);
+
+    redraw();
+}
+
+void grid::show()
+{
+    showed_ = true;
+    vert_scroll->show();
+    hor_scroll->show();
+    redraw();
+}
+
+void grid::hide()
+{
+    showed_ = false;
+    vert_scroll->hide();
+    hor_scroll->hide();
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->redraw(position(), true);
+    }
+}
+
+bool grid::showed() const
+{
+    return showed_;
+}
+
+void grid::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void grid::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool grid::enabled() const
+{
+    return enabled_;
+}
+
+void grid::set_size(int32_t rows_, int32_t columns_)
+{
+    rows_ = std::max(rows_, 0);
+    columns_ = std::max(columns_, 0);
+
+    if (rows_ > rows.count())
+    {
+        rows.insert(rows.count(), std::vector<int32_t>(rows_ - rows.count(), default_row_height));
+    }
+    else
+    {
+        rows.erase(rows_, rows.count() - rows_);
+    }
+
+    if (columns_ > columns.count())
+    {
+        columns.insert(columns.count(), std::vector<int32_t>(columns_ - columns.count(), default_column_width));
+    }
+    else
+    {
+        columns.erase(columns_, columns.count() - columns_);
+    }
+
+    if (selected_row >= rows_ || selected_column >= columns_)
+    {
+        selected_row = -1;
+        selected_column = -1;
+    }
+
+    update_scroll_areas();
+    redraw();
+}
+
+int32_t grid::row_count() const
+{
+    return rows.count();
+}
+
+int32_t grid::column_count() const
+{
+    return columns.count();
+}
+
+void grid::set_default_row_height(int32_t height)
+{
+    default_row_height = std::max(height, 1);
+    rows.reset(rows.count(), default_row_height);
+
+    update_scroll_areas();
+    redraw();
+}
+
+void grid::set_default_column_width(int32_t width)
+{
+    default_column_width = std::max(width, 1);
+    columns.reset(columns.count(), default_column_width);
+
+    update_scroll_areas();
+    redraw();
+}
+
+void grid::set_row_height(int32_t row, int32_t height)
+{
+    rows.set(row, height);
+
+    update_scroll_areas();
+    redraw();
+}
+
+void grid::set_column_width(int32_t column, int32_t width)
+{
+    columns.set(column, width);
+
+    update_scroll_areas();
+    redraw();
+}
+
+int32_t grid::row_height(int32_t row) const
+{
+    return rows.height(row);
+}
+
+int32_t grid::column_width(int32_t column) const
+{
+    return columns.height(column);
+}
+
+void grid::set_frozen(int32_t rows_, int32_t columns_)
+{
+    frozen_rows = std::max(rows_, 0);
+    frozen_columns = std::max(columns_, 0);
+
+    redraw();
+}
+
+void grid::select_cell(int32_t row, int32_t column)
+{
+    move_selection(row, column);
+}
+
+void grid::selected_cell(int32_t &row, int32_t &column) const
+{
+    row = selected_row;
+    column = selected_column;
+}
+
+void grid::scroll_to_cell(int32_t row, int32_t column)
+{
+    auto area = cells_area();
+
+    if (row >= frozen_rows && row < rows.count())
+    {
+        auto top = rows.top(row), scroll_pos = vert_scroll->get_scroll_pos();
+        if (top - scroll_pos < frozen_height())
+        {
+            vert_scroll->set_scroll_pos(top - frozen_height());
+        }
+        else if (top + rows.height(row) - scroll_pos > area.height())
+        {
+            vert_scroll->set_scroll_pos(top + rows.height(row) - area.height());
+        }
+    }
+
+    if (column >= frozen_columns && column < columns.count())
+    {
+        auto left = columns.top(column), scroll_pos = hor_scroll->get_scroll_pos();
+        if (left - scroll_pos < frozen_width())
+        {
+            hor_scroll->set_scroll_pos(left - frozen_width());
+        }
+        else if (left + columns.height(column) - scroll_pos > area.width())
+        {
+            hor_scroll->set_scroll_pos(left + columns.height(column) - area.width());
+        }
+    }
+}
+
+void grid::update_cell(int32_t row, int32_t column)
+{
+    if (row < 0 || row >= rows.count() || column < 0 || column >= columns.count())
+    {
+        return;
+    }
+
+    redraw_region_cells(row, column, row, column);
+}
+
+/// The range is split on the frozen and the scrolled parts, each part is repainted in its region
+void grid::update_cells(int32_t first_row, int32_t first_column, int32_t last_row, int32_t last_column)
+{
+    first_row = std::max(first_row, 0);
+    first_column = std::max(first_column, 0);
+    last_row = std::min(last_row, rows.count() - 1);
+    last_column = std::min(last_column, columns.count() - 1);
+
+    auto split_row = std::min(std::max(frozen_rows, first_row), last_row + 1),
+        split_column = std::min(std::max(frozen_columns, first_column), last_column + 1);
+
+    redraw_region_cells(first_row, first_column, split_row - 1, split_column - 1);
+    redraw_region_cells(first_row, split_column, split_row - 1, last_column);
+    redraw_region_cells(split_row, first_column, last_row, split_column - 1);
+    redraw_region_cells(split_row, split_column, last_row, last_column);
+}
+
+void grid::set_draw_callback(std::function<void(graphic&, int32_t, int32_t, const rect&, cell_state)> draw_callback_)
+{
+    draw_callback = draw_callback_;
+}
+
+void grid::set_cell_click_callback(std::function<void(int32_t, int32_t)> cell_click_callback_)
+{
+    cell_click_callback = cell_click_callback_;
+}
+
+void grid::set_cell_change_callback(std::function<void(int32_t, int32_t)> cell_change_callback_)
+{
+    cell_change_callback = cell_change_callback_;
+}
+
+void grid::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
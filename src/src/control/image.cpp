@@ -5,77 +5,32 @@
 
 #include <wui/theme/theme.hpp>
 
+#include <wui/framework/framework.hpp>
+
 #include <wui/system/tools.hpp>
 #include <wui/system/path_tools.hpp>
 
-#include <boost/nowide/convert.hpp>
-
-#include <cstring>
-
-void load_image_from_data(const std::vector<uint8_t> &data, Gdiplus::Image **img)
+namespace wui
 {
-    HGLOBAL h_buffer = ::GlobalAlloc(GMEM_MOVEABLE, data.size());
-    if (h_buffer)
-    {
-        void* p_buffer = ::GlobalLock(h_buffer);
-        if (p_buffer)
-        {
-            CopyMemory(p_buffer, data.data(), data.size());
 
-            IStream* p_stream = NULL;
-            if (::CreateStreamOnHGlobal(h_buffer, FALSE, &p_stream) == S_OK)
-            {
-                *img = Gdiplus::Image::FromStream(p_stream);
-                p_stream->Release();
-            }
-
-            ::GlobalUnlock(p_buffer);
-        }
-        ::GlobalFree(h_buffer);
-    }
-}
+static bool async_decoding = false;
 
-void load_image_from_resource(WORD image_id, const std::wstring &resource_section, Gdiplus::Image **img)
+/// The images compiled into the theme bundle are taken from it instead of the disk
+static image_source file_source(std::string_view file_name, std::shared_ptr<i_theme> theme_)
 {
-    HINSTANCE h_inst = GetModuleHandle(NULL);
-    HRSRC h_resource = FindResource(h_inst, MAKEINTRESOURCE(image_id), resource_section.c_str());
-    if (!h_resource)
+    auto data = theme_image_view(file_name, theme_);
+    if (!data.empty())
     {
-        return;
+        return image_source::from_data(reinterpret_cast<const uint8_t*>(data.data()), data.size());
     }
 
-    DWORD image_size = ::SizeofResource(h_inst, h_resource);
-    if (!image_size)
-    {
-        return;
-    }
-
-    const void* resource_data = ::LockResource(::LoadResource(h_inst, h_resource));
-    if (!resource_data)
-    {
-        return;
-    }
-
-    load_image_from_data(std::vector<uint8_t>(static_cast<const uint8_t*>(resource_data), static_cast<const uint8_t*>(resource_data) + image_size), img);
-}
-
-void load_image_from_file(std::string_view file_name, std::string_view images_path, Gdiplus::Image **img, wui::error &err)
-{
-    *img = Gdiplus::Image::FromFile(std::wstring(boost::nowide::widen(images_path) + L"\\" + boost::nowide::widen(file_name)).c_str());
-}
-
-void free_image(Gdiplus::Image **img)
-{
-    if (*img)
-    {
-        delete *img;
-        *img = nullptr;
-    }
+#ifdef _WIN32
+    return image_source::from_file(theme_string(image::tc, image::tv_path, theme_) + "\\" + std::string(file_name));
+#elif __linux__
+    return image_source::from_file(theme_string(image::tc, image::tv_path, theme_) + "/" + std::string(file_name));
+#endif
 }
 
-namespace wui
-{
-
 #ifdef _WIN32
 image::image(int32_t resource_index_, std::shared_ptr<i_theme> theme__)
     : theme_(theme__),
@@ -84,10 +39,13 @@ image::image(int32_t resource_index_, std::shared_ptr<i_theme> theme__)
     showed_(true), topmost_(false),
     file_name(),
     resource_index(resource_index_),
-    img(nullptr),
+    source(),
+    img(),
+    pending(),
+    pending_size(-1, -1),
     err{}
 {
-    load_image_from_resource(resource_index, boost::nowide::widen(theme_string(tc, tv_resource, theme_)), &img);
+    load(image_source::from_resource(resource_index, theme_string(tc, tv_resource, theme_)));
 }
 #endif
 
@@ -100,10 +58,13 @@ image::image(std::string_view file_name_, std::shared_ptr<i_theme> theme__)
 #ifdef _WIN32
     resource_index(0),
 #endif
-    img(nullptr),
+    source(),
+    img(),
+    pending(),
+    pending_size(-1, -1),
     err{}
 {
-    load_image_from_file(file_name_, theme_string(tc, tv_path, theme_), &img, err);
+    load(file_source(file_name, theme_));
 }
 
 image::image(const std::vector<uint8_t> &data)
@@ -115,14 +76,18 @@ image::image(const std::vector<uint8_t> &data)
 #ifdef _WIN32
     resource_index(0),
 #endif
-    img(nullptr)
+    source(),
+    img(),
+    pending(),
+    pending_size(-1, -1),
+    err{}
 {
-    load_image_from_data(data, &img);
+    load(image_source::from_data(data));
 }
 
 image::~image()
 {
-    free_image(&img);
+    cancel_pending();
 
     auto parent__ = parent_.lock();
     if (parent__)
@@ -131,26 +96,31 @@ image::~image()
     }
 }
 
-void image::draw(graphic &gr_, const rect &)
+void image::draw(graphic &gr, const rect &)
 {
-    if (!showed_)
+    if (!showed_ || !img)
     {
         return;
     }
 
-    if (img)
+    auto control_pos = position();
+    if (control_pos.width() > 0 && control_pos.height() > 0 &&
+        (img->width() != control_pos.width() || img->height() != control_pos.height()))
     {
-        Gdiplus::Graphics gr(gr_.drawable());
-
-        auto control_pos = position();
-
-        gr.DrawImage(
-            img,
-            Gdiplus::Rect(control_pos.left, control_pos.top, control_pos.width(), control_pos.height()),
-            0, 0, img->GetWidth(), img->GetHeight(),
-            Gdiplus::UnitPixel,
-            nullptr);
+        auto scaled = async_decoding ?
+            get_image_cache().find(source, control_pos.width(), control_pos.height()) :
+            get_image_cache().get(source, control_pos.width(), control_pos.height());
+        if (scaled)
+        {
+            img = scaled;
+        }
+        else if (async_decoding)
+        {
+            request(control_pos.width(), control_pos.height()); /// Meanwhile the image is stretched
+        }
     }
+
+    gr.draw_image(control_pos, *img);
 }
 
 void image::set_position(const rect &position__, bool redraw)
@@ -266,9 +236,8 @@ void image::change_image(int32_t resource_index_)
 {
     resource_index = resource_index_;
 
-    free_image(&img);
-    load_image_from_resource(resource_index, boost::nowide::widen(theme_string(tc, tv_resource, theme_)), &img);
-    
+    load(image_source::from_resource(resource_index, theme_string(tc, tv_resource, theme_)));
+
     redraw();
 }
 
@@ -276,44 +245,110 @@ void image::change_image(std::string_view file_name_)
 {
     file_name = file_name_;
 
-    free_image(&img);
-    load_image_from_file(file_name, theme_string(tc, tv_path, theme_), &img, err);
+    load(file_source(file_name, theme_));
 
     redraw();
 }
 
 void image::change_image(const std::vector<uint8_t> &data)
 {
-    free_image(&img);
-    load_image_from_data(data, &img);
+    load(image_source::from_data(data));
 
     redraw();
 }
 
 int32_t image::width() const
 {
-    if (img)
+    return img ? img->source_width() : 0;
+}
+
+int32_t image::height() const
+{
+    return img ? img->source_height() : 0;
+}
+
+void image::load(image_source &&source_)
+{
+    cancel_pending();
+
+    source = std::move(source_);
+    err.reset();
+
+    if (async_decoding)
     {
-#ifdef _WIN32
-        return img->GetWidth();
-#elif __linux__
-        return cairo_image_surface_get_width(img);
-#endif
+        img = get_image_cache().find(source);
+        if (!img)
+        {
+            request(0, 0);
+        }
+        return;
     }
-    return 0;
+
+    img = get_image_cache().get(source);
+    loaded(img, 0, 0);
 }
 
-int32_t image::height() const
+void image::request(int32_t width_, int32_t height_)
 {
-    if (img)
+    if (pending_size == std::make_pair(width_, height_))
     {
-#ifdef _WIN32
-        return img->GetHeight();
-#elif __linux__
-        return cairo_image_surface_get_height(img);
-#endif
+        return;
+    }
+    pending_size = { width_, height_ };
+
+    if (!pending)
+    {
+        pending = std::make_shared<image*>(this);
     }
-    return 0;
+
+    auto owner = pending;
+    get_image_cache().get_async(source, width_, height_, [owner, width_, height_](std::shared_ptr<cached_image> img_) {
+        framework::post([owner, img_, width_, height_]() {
+            if (*owner)
+            {
+                (*owner)->loaded(img_, width_, height_);
+            }
+        });
+    });
+}
+
+/// Called on the UI thread
+void image::loaded(std::shared_ptr<cached_image> img_, int32_t width_, int32_t height_)
+{
+    if (pending_size == std::make_pair(width_, height_))
+    {
+        pending_size = { -1, -1 };
+    }
+
+    if (width_ == 0 && height_ == 0)
+    {
+        img = img_;
+        if (!img)
+        {
+            err.type = error_type::file_not_found;
+            err.component = "image::load()";
+            err.message = "Unable to decode the image: " + (source.kind_ == image_source::kind::data ? std::string("from data") : source.path);
+        }
+    }
+    else if (img_)
+    {
+        img = img_;
+    }
+
+    if (pending) /// The synchronous load() callers redraw by themselves
+    {
+        redraw();
+    }
+}
+
+void image::cancel_pending()
+{
+    if (pending)
+    {
+        *pending = nullptr;
+        pending.reset();
+    }
+    pending_size = { -1, -1 };
 }
 
 void image::redraw()
@@ -328,4 +363,19 @@ void image::redraw()
     }
 }
 
+void set_async_image_decoding(bool yes)
+{
+    async_decoding = yes;
+}
+
+void prefetch_images(const std::vector<std::string> &names, std::shared_ptr<i_theme> theme_)
+{
+    std::vector<image_source> sources;
+    for (auto &name : names)
+    {
+        sources.emplace_back(file_source(name, theme_));
+    }
+    get_image_cache().prefetch(sources);
+}
+
 }
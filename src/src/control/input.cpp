@@ -24,8 +24,10 @@ static const int32_t input_horizontal_indent = 5;
 input::input(std::string_view text__, input_view input_view__, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
     : input_view_(input_view__),
     text_(text__),
+    text_widths(),
     change_callback(),
     tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     cursor_position(0), select_start_position(0), select_end_position(0),
@@ -33,6 +35,9 @@ input::input(std::string_view text__, input_view input_view__, std::string_view
     my_control_sid(), my_plain_sid(),
     timer_(std::bind(&input::redraw_cursor, this)),
     menu_(std::make_shared<menu>(menu::tc, theme_)),
+    measure_context{ 0 },
+    measure_graphic(measure_context),
+    measure_graphic_ready(false),
     showed_(true), enabled_(true), topmost_(false),
     focused_(false),
     cursor_visible(false),
@@ -55,14 +60,6 @@ input::~input()
     }
 }
 
-int32_t get_text_width(graphic &gr, std::string text, size_t text_length, const font &font_)
-{
-    text.resize(text_length);
-    auto text_rect = gr.measure_text(text, font_);
-
-    return text_rect.right;
-}
-
 void input::draw(graphic &gr, const rect &)
 {
     if (!showed_ || position_.width() == 0 || position_.height() == 0 || position_.width() <= input_horizontal_indent * 2)
@@ -74,47 +71,39 @@ void input::draw(graphic &gr, const rect &)
 
     /// Draw the frame
     gr.draw_rect(control_pos,
-        !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_),
-        theme_color(tcn, tv_background, theme_),
-        theme_dimension(tcn, tv_border_width, theme_),
-        theme_dimension(tcn, tv_round, theme_));
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
     if (input_view_ == input_view::password)
     {
         font_.name = "Courier New";
     }
 
-    /// Create memory dc for text and selection bar
-    auto full_text_width = get_text_width(gr, text_, text_.size(), font_) + 2;
+    text_widths.update(gr, text_, font_);
+
+    /// Take the pooled memory dc for text and selection bar
+    auto full_text_width = text_widths.width(text_.size()) + 2;
     auto text_height = font_.size;
 
-    system_context ctx = { 0 };
-    auto parent__ = parent_.lock();
-    if (parent__)
-    {
-#ifdef _WIN32
-        ctx = parent__->context();
-#elif __linux__
-        ctx = { parent__->context().display, parent__->context().connection, parent__->context().screen, gr.drawable() };
-#endif
-}
-    graphic mem_gr(ctx);
-    mem_gr.init({ 0, 0, full_text_width, text_height }, theme_color(tcn, tv_background, theme_));
+    auto mem_gr_ = gr.offscreen({ 0, 0, full_text_width, text_height }, theme_color(tcn_keys[tk_background], theme_));
+    auto &mem_gr = *mem_gr_;
 
     /// Draw the selection bar
     if (select_start_position != select_end_position)
     {
-        auto start_coordinate = get_text_width(mem_gr, text_, select_start_position, font_);
-        auto end_coordinate = get_text_width(mem_gr, text_, select_end_position, font_);
+        auto start_coordinate = text_widths.width(select_start_position);
+        auto end_coordinate = text_widths.width(select_end_position);
 
-        mem_gr.draw_rect({ start_coordinate, 0, end_coordinate, text_height }, theme_color(tcn, tv_selection, theme_));
+        mem_gr.draw_rect({ start_coordinate, 0, end_coordinate, text_height }, theme_color(tcn_keys[tk_selection], theme_));
     }
 
     /// Draw the text
     if (input_view_ != input_view::password)
     {
-        mem_gr.draw_text({ 0 }, text_, theme_color(tcn, tv_text, theme_), font_);
+        mem_gr.draw_text({ 0 }, text_, theme_color(tcn_keys[tk_text], theme_), font_);
     }
     else
     {
@@ -126,14 +115,14 @@ void input::draw(graphic &gr, const rect &)
                 text__.append("●");
             }
         }
-        mem_gr.draw_text({ 0 }, text__, theme_color(tcn, tv_text, theme_), font_);
+        mem_gr.draw_text({ 0 }, text__, theme_color(tcn_keys[tk_text], theme_), font_);
     }
             
     /// Draw the cursor
     if (cursor_visible)
     {
-        auto cursor_coordinate = get_text_width(mem_gr, text_, cursor_position, font_);
-        mem_gr.draw_line({ cursor_coordinate, 0, cursor_coordinate, text_height }, theme_color(tcn, tv_cursor, theme_));
+        auto cursor_coordinate = text_widths.width(cursor_position);
+        mem_gr.draw_line({ cursor_coordinate, 0, cursor_coordinate, text_height }, theme_color(tcn_keys[tk_cursor], theme_));
 
         while (cursor_coordinate - left_shift >= position_.width() - input_horizontal_indent * 2)
         {
@@ -164,34 +153,25 @@ size_t input::calculate_mouse_cursor_position(int32_t x)
 
     x -= position().left + input_horizontal_indent - left_shift;
 
-    system_context ctx = { 0 };
-    auto parent__ = parent_.lock();
-    if (parent__)
+    if (!measure_graphic_ready)
     {
-        ctx = parent__->context();
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            measure_context = parent__->context();
+        }
+        measure_graphic_ready = measure_graphic.init({ 0, 0, 1, 1 }, 0);
     }
-    graphic mem_gr(ctx);
-    mem_gr.init(position_, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
     if (input_view_ == input_view::password)
     {
         font_.name = "Courier New";
     }
 
-    int32_t text_width = 0;
-    size_t count = 0;
-    while (x > text_width && count != text_.size())
-    {
-        ++count;
+    text_widths.update(measure_graphic, text_, font_);
 
-        if (check_count_valid(count))
-        {
-            text_width = get_text_width(mem_gr, text_, count, font_);
-        }
-    }
-
-    return count;
+    return text_widths.position(x);
 }
 
 void input::update_select_positions(bool shift_pressed, size_t start_position, size_t end_position)
@@ -237,6 +217,7 @@ bool input::clear_selected_text()
         cursor_position = start;
 
         text_.erase(start, end - start);
+        text_widths.erase(start, end - start);
 
         selecting = false;
         select_start_position = 0;
@@ -473,6 +454,7 @@ void input::receive_control_events(const event &ev)
                                 move_cursor_left();
 
                                 text_.erase(cursor_position, prev_position - cursor_position);
+                                text_widths.erase(cursor_position, prev_position - cursor_position);
                             }
                             
                             redraw();
@@ -499,6 +481,7 @@ void input::receive_control_events(const event &ev)
                                     ++char_count;
                                 }
                                 text_.erase(cursor_position, char_count);
+                                text_widths.erase(cursor_position, char_count);
                             }
                             
                             redraw();
@@ -561,7 +544,9 @@ void input::receive_control_events(const event &ev)
                 
                 clear_selected_text();
 
+                auto prev_size = text_.size();
                 text_.insert(cursor_position, ev.keyboard_event_.key);
+                text_widths.insert(text_, cursor_position, text_.size() - prev_size);
                 
                 cursor_position += ev.keyboard_event_.key_size;
 
@@ -646,6 +631,9 @@ void input::clear_parent()
         parent__->unsubscribe(my_plain_sid);
     }
     parent_.reset();
+
+    measure_graphic.release();
+    measure_graphic_ready = false;
 }
 
 void input::set_topmost(bool yes)
@@ -676,6 +664,7 @@ error input::get_error() const
 void input::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -732,6 +721,7 @@ bool input::enabled() const
 void input::set_text(std::string_view text__)
 {
     text_ = text__;
+    text_widths.reset();
     cursor_position = 0;
 
     redraw();
@@ -777,7 +767,26 @@ void input::redraw()
 void input::redraw_cursor()
 {
     cursor_visible = !cursor_visible;
-    redraw();
+
+    /// Only the cursor column is damaged, the window clips the drawing of the control to it
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            auto control_pos = position();
+
+            auto text_height = theme_font(tcn_keys[tk_font], theme_).size;
+            int32_t input_vertical_indent = position_.height() > text_height ? (position_.height() - text_height) / 2 : 0;
+
+            auto cursor_left = control_pos.left + input_horizontal_indent + text_widths.width(cursor_position) - left_shift;
+
+            parent__->redraw({ cursor_left - 1,
+                control_pos.top + input_vertical_indent,
+                cursor_left + 2,
+                control_pos.top + input_vertical_indent + text_height });
+        }
+    }
 }
 
 void input::buffer_copy()
@@ -834,6 +843,7 @@ void input::buffer_paste()
     auto paste_string = clipboard_get_text(parent_.lock()->context());
     
     text_.insert(cursor_position, paste_string);
+    text_widths.insert(text_, cursor_position, paste_string.size());
 
     cursor_position += paste_string.size();
 
@@ -10,12 +10,14 @@
 #include <wui/common/flag_helpers.hpp>
 
 #include <algorithm>
+#include <cstdlib>
 
 namespace wui
 {
 
 list::list(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -24,9 +26,14 @@ list::list(std::string_view theme_control_name_, std::shared_ptr<i_theme> theme_
     columns_(),
     mode(list_mode::simple),
     item_count(0), selected_item_(0), active_item_(-1),
+    item_heights(), item_heights_valid(false), uniform_item_height(0),
     title_height(-1),
     scroll_area(0),
     vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&list::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    content(),
+    content_size(),
+    content_scroll_pos(0),
+    content_valid(false), scrolled(false), rows_damaged(false),
     draw_callback(),
     item_height_callback(),
     item_change_callback(),
@@ -55,30 +62,15 @@ void list::draw(graphic &gr, const rect &)
 
     auto control_pos = position();
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
-    /// Create memory dc for inner content   
-    system_context ctx = { 0 };
-    auto parent__ = parent_.lock();
-    if (parent__)
-    {
-        ctx = parent__->context();
-    }
-
-    graphic mem_gr(ctx);
-    mem_gr.init({ 0, 0, position_.width() - border_width * 2, position_.height() - border_width * 2 }, theme_color(tcn, tv_background, theme_));
-
-    calc_title_height(mem_gr);
-
-    draw_items(mem_gr);
-
-    draw_titles(mem_gr);
+    draw_content(gr, { 0, 0, position_.width() - border_width * 2, position_.height() - border_width * 2 });
 
     gr.draw_graphic({control_pos.left + border_width,
             control_pos.top + border_width,
             control_pos.width() - border_width,
             control_pos.height() - border_width },
-        mem_gr, 0, 0);
+        *content, 0, 0);
 
     if ((mouse_on_control || focused_) && has_scrollbar())
     {
@@ -86,10 +78,10 @@ void list::draw(graphic &gr, const rect &)
     }
 
     gr.draw_rect(control_pos,
-        !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_),
-        make_color(0, 0, 0, 255), //{ theme_color(tcn, tv_background, theme_), 0 },
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        make_color(0, 0, 0, 255), //{ theme_color(tcn_keys[tk_background], theme_), 0 },
         border_width,
-        theme_dimension(tcn, tv_round, theme_));
+        theme_dimension(tcn_keys[tk_round], theme_));
 }
 
 void list::receive_control_events(const event &ev)
@@ -400,7 +392,7 @@ void list::set_position(const rect &position__, bool redraw)
 {
     update_control_position(position_, position__, showed_ && redraw, parent_);
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     vert_scroll->set_position({ position_.right - 14 - border_width,
         position_.top + border_width,
@@ -439,10 +431,13 @@ void list::clear_parent()
         parent__->remove_control(vert_scroll);
 
         parent__->unsubscribe(my_control_sid);
-        my_control_sid.clear();
+        my_control_sid = 0;
     }
 
     parent_.reset();
+
+    content.reset();
+    content_valid = false;
 }
 
 void list::set_topmost(bool yes)
@@ -473,6 +468,7 @@ error list::get_error() const
 void list::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -584,6 +580,11 @@ void list::set_column_width(int32_t n_column, int32_t width)
 
 int32_t list::get_item_height(int32_t n_item) const
 {
+    if (uniform_item_height > 0)
+    {
+        return uniform_item_height;
+    }
+
     int32_t height = -1;
     if (item_height_callback)
     {
@@ -600,6 +601,7 @@ void list::set_item_count(int32_t count)
     }
 
     item_count = count;
+    item_heights_valid = false;
 
     update_scroll_area();
 
@@ -611,6 +613,112 @@ int32_t list::get_item_count() const
     return item_count;
 }
 
+void list::insert_items(int32_t first, int32_t count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    first = std::min(std::max(first, 0), static_cast<int32_t>(item_count));
+
+    if (item_heights_valid)
+    {
+        std::vector<int32_t> heights(count, uniform_item_height);
+        if (uniform_item_height == 0 && item_height_callback)
+        {
+            for (int32_t i = 0; i != count; ++i)
+            {
+                heights[i] = 0;
+                item_height_callback(first + i, heights[i]);
+            }
+        }
+        item_heights.insert(first, heights);
+    }
+
+    item_count += count;
+
+    if (selected_item_ >= first)
+    {
+        selected_item_ += count;
+    }
+    if (active_item_ >= first)
+    {
+        active_item_ += count;
+    }
+
+    update_scroll_area();
+
+    redraw_items(first, -1);
+}
+
+void list::remove_items(int32_t first, int32_t count)
+{
+    first = std::min(std::max(first, 0), static_cast<int32_t>(item_count));
+    count = std::min(std::max(count, 0), item_count - first);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (item_heights_valid)
+    {
+        item_heights.erase(first, count);
+    }
+
+    item_count -= count;
+
+    if (selected_item_ >= first + count)
+    {
+        selected_item_ -= count;
+    }
+    else if (selected_item_ >= first)
+    {
+        selected_item_ = first < item_count ? first : item_count - 1;
+    }
+    if (active_item_ >= first)
+    {
+        active_item_ = -1;
+    }
+
+    update_scroll_area();
+
+    redraw_items(first, -1);
+}
+
+void list::update_items(int32_t first, int32_t count)
+{
+    first = std::min(std::max(first, 0), static_cast<int32_t>(item_count));
+    count = std::min(std::max(count, 0), item_count - first);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    bool heights_changed = false;
+    if (item_heights_valid && uniform_item_height == 0 && item_height_callback)
+    {
+        for (auto i = first; i != first + count; ++i)
+        {
+            auto height = get_item_height(i);
+            if (height != item_heights.height(i))
+            {
+                item_heights.set(i, height);
+                heights_changed = true;
+            }
+        }
+    }
+
+    if (heights_changed)
+    {
+        update_scroll_area();
+    }
+
+    redraw_items(first, heights_changed ? -1 : first + count);
+}
+
 void list::scroll_to_start()
 {
     vert_scroll->set_scroll_pos(0);
@@ -623,22 +731,59 @@ void list::scroll_to_end()
     redraw();
 }
 
-int32_t list::get_item_top(int32_t n_item) const
+void list::set_item_height(int32_t height)
 {
-    if (n_item < 0)
+    uniform_item_height = height;
+    item_heights_valid = false;
+
+    update_scroll_area();
+
+    redraw();
+}
+
+void list::update_item_height(int32_t n_item)
+{
+    if (!item_heights_valid || uniform_item_height > 0)
     {
-        return 0;
+        return;
     }
 
-    int32_t top = 0;
+    item_heights.set(n_item, get_item_height(n_item));
+
+    update_scroll_area();
+
+    redraw();
+}
+
+int32_t list::get_item_top(int32_t n_item) const
+{
+    update_item_heights();
+
+    return item_heights.top(n_item);
+}
+
+void list::update_item_heights() const
+{
+    if (item_heights_valid && item_heights.count() == item_count)
+    {
+        return;
+    }
 
-    for (int32_t i = 0; i != n_item; ++i)
+    if (uniform_item_height > 0 || !item_height_callback)
+    {
+        item_heights.reset(item_count, uniform_item_height);
+    }
+    else
     {
-        auto height = get_item_height(i);
-        top += height != -1 ? height : 0;
+        std::vector<int32_t> heights(item_count);
+        for (int32_t i = 0; i != item_count; ++i)
+        {
+            heights[i] = get_item_height(i);
+        }
+        item_heights.assign(heights);
     }
 
-    return top;
+    item_heights_valid = true;
 }
 
 void list::set_draw_callback(std::function<void(graphic&, int32_t, const rect&, item_state state)> draw_callback_)
@@ -649,6 +794,7 @@ void list::set_draw_callback(std::function<void(graphic&, int32_t, const rect&,
 void list::set_item_height_callback(std::function<void(int32_t, int32_t&)> item_height_callback_)
 {
     item_height_callback = item_height_callback_;
+    item_heights_valid = false;
 }
 
 void list::set_item_click_callback(std::function<void(click_button, int32_t, int32_t, int32_t)> item_click_callback_)
@@ -678,7 +824,17 @@ void list::set_scroll_callback(std::function<void(scroll_state, int32_t)> scroll
 
 void list::on_scroll(scroll_state ss, int32_t v)
 {
-    redraw();
+    /// Not redraw(), the content stays valid and the next paint only moves it
+    scrolled = true;
+
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
 
     if (scroll_callback)
     {
@@ -688,6 +844,8 @@ void list::on_scroll(scroll_state ss, int32_t v)
 
 void list::redraw()
 {
+    content_valid = false;
+
     if (showed_)
     {
         auto parent__ = parent_.lock();
@@ -700,6 +858,9 @@ void list::redraw()
 
 void list::redraw_item(int32_t item)
 {
+    /// The content stays valid, the next paint draws again the rows under the damaged rect
+    rows_damaged = true;
+
     if (showed_)
     {
         auto control_pos = position();
@@ -720,9 +881,41 @@ void list::redraw_item(int32_t item)
     }
 }
 
+/// Damages the rows from first to last (exclusive, -1 is up to the bottom) visible now
+void list::redraw_items(int32_t first, int32_t last)
+{
+    rows_damaged = true;
+
+    if (!showed_)
+    {
+        return;
+    }
+
+    auto parent__ = parent_.lock();
+    if (!parent__)
+    {
+        return;
+    }
+
+    auto control_pos = position();
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    auto items_top = control_pos.top + border_width * 2 + title_height - scroll_pos;
+
+    auto top = std::max(items_top + get_item_top(first), control_pos.top + border_width + title_height);
+    auto bottom = last != -1 ? std::min(items_top + get_item_top(last), control_pos.bottom) : control_pos.bottom;
+
+    if (bottom > top)
+    {
+        parent__->redraw({ control_pos.left, top, control_pos.right, bottom });
+    }
+}
+
 void list::calc_title_height(graphic &gr_)
 {
-    auto font = theme_font(tcn, tv_font, theme_);
+    auto font = theme_font(tcn_keys[tk_font], theme_);
     auto text_indent = 5;
 
     if (title_height == -1)
@@ -741,12 +934,12 @@ void list::calc_title_height(graphic &gr_)
 
 void list::draw_titles(graphic &gr_)
 {
-    auto font = theme_font(tcn, tv_font, theme_);
+    auto font = theme_font(tcn_keys[tk_font], theme_);
     auto text_indent = 5;
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
-    auto title_color = theme_color(tcn, tv_title, theme_);
-    auto title_text_color = theme_color(tcn, tv_title_text, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+    auto title_color = theme_color(tcn_keys[tk_title], theme_);
+    auto title_text_color = theme_color(tcn_keys[tk_title_text], theme_);
     
     int32_t left = 0;
 
@@ -761,28 +954,90 @@ void list::draw_titles(graphic &gr_)
     }
 }
 
-void list::draw_items(graphic &gr_)
+void list::draw_content(graphic &gr, const rect &size)
 {
-    if (!draw_callback || position_.height() == 0)
+    auto background_color = theme_color(tcn_keys[tk_background], theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+    auto delta = scroll_pos - content_scroll_pos;
+
+    auto same_size = content && content->get_error().type == error_type::ok &&
+        size.width() == content_size.width() && size.height() == content_size.height();
+
+    /// The part of the content under the clip of the window graphic
+    auto control_pos = position();
+    auto band = gr.clip();
+    band.move(-control_pos.left - border_width, -control_pos.top - border_width);
+    band = band.intersection(size);
+
+    if (content_valid && same_size && scrolled && !rows_damaged && std::abs(delta) < size.height() - title_height)
     {
-        return;
+        /// Only the rows coming into view are drawn, the rest are moved from the previous paint.
+        /// The titles strip is out of the moved area
+        content->scroll({ 0, title_height, size.width(), size.height() }, -delta);
+
+        band = delta > 0 ? rect{ 0, size.height() - delta, size.width(), size.height() } :
+            rect{ 0, title_height, size.width(), title_height - delta };
     }
+    else if (!content_valid || !same_size || scrolled)
+    {
+        if (!same_size)
+        {
+            content = gr.make_offscreen(size, background_color);
+            content_size = size;
+        }
+        else
+        {
+            content->set_background_color(background_color);
+        }
 
-    int32_t first_item = -1, item_bottom = 0;
-    auto scroll_pos = vert_scroll->get_scroll_pos();
-    while (scroll_pos >= item_bottom && first_item < item_count)
+        calc_title_height(*content);
+
+        band = size;
+    }
+
+    if (band.width() > 0 && band.height() > 0)
     {
-        ++first_item;
-        item_bottom = get_item_top(first_item) + get_item_height(first_item);
+        content->push_clip(band);
+        content->clear(band);
+
+        draw_items(*content);
+
+        draw_titles(*content);
+
+        content->pop_clip();
     }
 
-    int32_t last_item = -1, item_top = 0;
-    while (position_.height() > item_top && last_item < item_count)
+    content_scroll_pos = scroll_pos;
+    content_valid = true;
+    scrolled = false;
+    rows_damaged = false;
+}
+
+void list::draw_items(graphic &gr_)
+{
+    if (!draw_callback || position_.height() == 0)
     {
-        ++last_item;
-        item_top = get_item_top(last_item) - scroll_pos;
+        return;
     }
 
+    update_item_heights();
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    int32_t top_ = border_width + title_height - scroll_pos,
+        left = border_width,
+        right = position_.width() - border_width;
+
+    /// Only the rows under the clip are drawn
+    auto clip_ = gr_.clip();
+
+    int32_t first_item = item_heights.item_at(std::max(clip_.top - top_, 0)),
+        last_item = item_heights.item_at(std::max(clip_.bottom - top_ - 1, 0)) + 1;
+
     if (last_item < first_item || last_item == first_item)
     {
         return;
@@ -793,16 +1048,10 @@ void list::draw_items(graphic &gr_)
         last_item = item_count;
     }
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
-
-    int32_t top_ = border_width + title_height - scroll_pos,
-        left = border_width,
-        right = position_.width() - border_width;
-
     for (auto item = first_item; item != last_item; ++item)
     {
-        auto item_height = get_item_height(item);
-        auto top = get_item_top(item) + top_;
+        auto item_height = item_heights.height(item);
+        auto top = item_heights.top(item) + top_;
 
         rect item_rect = { left, top, right, top + item_height - border_width };
 
@@ -828,27 +1077,18 @@ bool list::has_scrollbar()
 
 void list::update_selected_item(int32_t y)
 {
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     auto scroll_pos = vert_scroll->get_scroll_pos();
 
     auto pos = (y - position().top - title_height - border_width) + scroll_pos;
 
-    int32_t item = -1, item_start = 0, item_end = 0;
-    while (item != item_count)
+    update_item_heights();
+
+    auto item = item_heights.item_at(pos);
+    if (item < 0)
     {
-        if (item_start <= pos && item_end > pos)
-        {
-            break;
-        }
-        else
-        {
-            ++item;
-        }
-        item_start = get_item_top(item);
-        
-        auto height = get_item_height(item);
-        item_end = height != -1 ? item_start + height : 0;
+        item = item_count;
     }
 
     if (item != selected_item_)
@@ -871,30 +1111,16 @@ void list::update_active_item(int32_t y)
 {
     int32_t prev_active_item_ = active_item_;
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     auto scroll_pos = vert_scroll->get_scroll_pos();
 
     auto pos = (y - position().top - title_height - border_width) + scroll_pos;
 
-    active_item_ = -1;
-
-    int32_t item_start = 0, item_end = 0;
-    while (active_item_ != item_count)
-    {
-        if (item_start <= pos && item_end > pos)
-        {
-            break;
-        }
-        else
-        {
-            ++active_item_;
-        }
-        item_start = get_item_top(active_item_);
+    update_item_heights();
 
-        auto height = get_item_height(active_item_);
-        item_end = height != -1 ? item_start + height : 0;
-    }
+    auto item = item_heights.item_at(pos);
+    active_item_ = item >= 0 ? item : static_cast<int32_t>(item_count);
    
     if (prev_active_item_ != active_item_)
     {
@@ -937,7 +1163,9 @@ void list::update_scroll_area()
         scrolled_down = true;
     }
 
-    scroll_area = title_height + get_item_top(item_count - 1) + get_item_height(item_count - 1) - position_.height();
+    update_item_heights();
+
+    scroll_area = title_height + item_heights.total() - position_.height();
     if (scroll_area < 0)
     {
         scroll_area = 0;
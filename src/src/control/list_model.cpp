@@ -0,0 +1,372 @@
+#include <wui/control/list_model.hpp>
+
+#include <wui/framework/framework.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+list_model::list_model(std::shared_ptr<i_list_data_source> source_, int32_t page_size_, size_t max_pages_, int32_t prefetch_pages_)
+    : source(source_),
+    page_size(page_size_ > 0 ? page_size_ : 1),
+    prefetch_pages(prefetch_pages_ > 0 ? prefetch_pages_ : 0),
+    max_pages(max_pages_ > 0 ? max_pages_ : 1),
+    list_(),
+    draw_callback(),
+    count_(0),
+    pages(),
+    use_counter(0),
+    last_scroll_pos(0), scroll_direction(0),
+    mutex(),
+    cv(),
+    requests(),
+    in_flight(),
+    generation(0),
+    stopping(false),
+    worker(),
+    alive(std::make_shared<list_model*>(this))
+{
+}
+
+list_model::~list_model()
+{
+    *alive = nullptr;
+
+    detach();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+void list_model::attach(std::shared_ptr<list> list__)
+{
+    detach();
+
+    list_ = list__;
+
+    auto owner = alive;
+    list__->set_draw_callback([owner](graphic &gr, int32_t n, const rect &position, list::item_state state) {
+        if (*owner)
+        {
+            (*owner)->draw_row(gr, n, position, state);
+        }
+    });
+    list__->set_scroll_callback([owner](scroll_state, int32_t scroll_pos) {
+        if (*owner)
+        {
+            (*owner)->on_scroll(scroll_pos);
+        }
+    });
+
+    list__->set_item_count(count_);
+}
+
+void list_model::detach()
+{
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->set_draw_callback(nullptr);
+        list__->set_scroll_callback(nullptr);
+    }
+    list_.reset();
+}
+
+void list_model::set_draw_callback(std::function<void(graphic&, int32_t, const list_row*, const rect&, list::item_state)> draw_callback_)
+{
+    draw_callback = draw_callback_;
+}
+
+std::shared_ptr<const list_row> list_model::row(int32_t n)
+{
+    if (n < 0 || n >= count_)
+    {
+        return nullptr;
+    }
+
+    auto page_no = n / page_size;
+
+    auto it = pages.find(page_no);
+    if (it == pages.end())
+    {
+        request_page(page_no, false);
+        prefetch(page_no);
+        return nullptr;
+    }
+
+    it->second->last_use = ++use_counter;
+
+    auto index = static_cast<size_t>(n % page_size);
+    if (index >= it->second->rows.size())
+    {
+        return nullptr; /// the source has returned less rows than the count
+    }
+
+    prefetch(page_no);
+
+    /// Shares the ownership of the page, so the row survives the eviction while it is used
+    return std::shared_ptr<const list_row>(it->second, &it->second->rows[index]);
+}
+
+void list_model::reset(int32_t count)
+{
+    count_ = count > 0 ? count : 0;
+
+    drop_pages(0, -1);
+
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->set_item_count(count_);
+    }
+}
+
+void list_model::inserted(int32_t first, int32_t count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    first = std::min(std::max(first, 0), count_);
+    count_ += count;
+
+    drop_pages(first / page_size, -1);
+
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->insert_items(first, count);
+    }
+}
+
+void list_model::removed(int32_t first, int32_t count)
+{
+    first = std::min(std::max(first, 0), count_);
+    count = std::min(std::max(count, 0), count_ - first);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    count_ -= count;
+
+    drop_pages(first / page_size, -1);
+
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->remove_items(first, count);
+    }
+}
+
+void list_model::changed(int32_t first, int32_t count)
+{
+    first = std::min(std::max(first, 0), count_);
+    count = std::min(std::max(count, 0), count_ - first);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    drop_pages(first / page_size, (first + count - 1) / page_size);
+
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->update_items(first, count);
+    }
+}
+
+int32_t list_model::count() const
+{
+    return count_;
+}
+
+void list_model::draw_row(graphic &gr, int32_t n, const rect &position, list::item_state state)
+{
+    auto row_ = row(n);
+
+    if (draw_callback)
+    {
+        draw_callback(gr, n, row_.get(), position, state);
+    }
+}
+
+void list_model::on_scroll(int32_t scroll_pos)
+{
+    if (scroll_pos != last_scroll_pos)
+    {
+        scroll_direction = scroll_pos > last_scroll_pos ? 1 : -1;
+        last_scroll_pos = scroll_pos;
+    }
+}
+
+void list_model::request_page(int32_t page_no, bool prefetch_)
+{
+    if (page_no < 0 || page_no * page_size >= count_ || pages.find(page_no) != pages.end())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (!in_flight.emplace(page_no, generation).second)
+        {
+            return;
+        }
+
+        /// The shown pages go before the prefetched ones
+        if (prefetch_)
+        {
+            requests.push_back({ page_no, generation });
+        }
+        else
+        {
+            requests.push_front({ page_no, generation });
+        }
+
+        if (!worker.joinable())
+        {
+            worker = std::thread(&list_model::work, this);
+        }
+    }
+
+    cv.notify_one();
+}
+
+void list_model::prefetch(int32_t page_no)
+{
+    if (scroll_direction == 0)
+    {
+        return;
+    }
+
+    for (int32_t i = 1; i <= prefetch_pages; ++i)
+    {
+        request_page(page_no + i * scroll_direction, true);
+    }
+}
+
+/// Called on the UI thread
+void list_model::arrived(int32_t page_no, uint64_t generation_, std::vector<list_row> &&rows)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto flight = in_flight.find(page_no);
+        if (flight == in_flight.end() || flight->second != generation_)
+        {
+            return;
+        }
+        in_flight.erase(flight);
+    }
+
+    drop_unused();
+
+    auto page_ = std::make_shared<page>();
+    page_->rows = std::move(rows);
+    page_->last_use = ++use_counter;
+    pages[page_no] = page_;
+
+    /// Only the rows drawn as placeholders are repainted
+    auto list__ = list_.lock();
+    if (list__)
+    {
+        list__->update_items(page_no * page_size, page_size);
+    }
+}
+
+/// Drops the pages from from_page to to_page (-1 is up to the end) and the results of their requests sent before
+void list_model::drop_pages(int32_t from_page, int32_t to_page)
+{
+    auto in_range = [from_page, to_page](int32_t page_no) {
+        return page_no >= from_page && (to_page == -1 || page_no <= to_page);
+    };
+
+    for (auto it = pages.begin(); it != pages.end();)
+    {
+        if (in_range(it->first))
+        {
+            it = pages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    ++generation;
+
+    requests.erase(std::remove_if(requests.begin(), requests.end(), [&in_range](const request &r) { return in_range(r.page_no); }), requests.end());
+
+    for (auto it = in_flight.begin(); it != in_flight.end();)
+    {
+        if (in_range(it->first))
+        {
+            it = in_flight.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void list_model::drop_unused()
+{
+    while (pages.size() >= max_pages)
+    {
+        auto lru = std::min_element(pages.begin(), pages.end(), [](const std::pair<const int32_t, std::shared_ptr<page>> &a, const std::pair<const int32_t, std::shared_ptr<page>> &b) {
+            return a.second->last_use < b.second->last_use;
+        });
+        pages.erase(lru);
+    }
+}
+
+void list_model::work()
+{
+    while (true)
+    {
+        request r;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !requests.empty(); });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            r = requests.front();
+            requests.pop_front();
+        }
+
+        auto rows = source->fetch(r.page_no * page_size, page_size);
+
+        auto owner = alive;
+        auto rows_ = std::make_shared<std::vector<list_row>>(std::move(rows));
+        framework::post([owner, r, rows_]() {
+            if (*owner)
+            {
+                (*owner)->arrived(r.page_no, r.generation, std::move(*rows_));
+            }
+        });
+    }
+}
+
+}
@@ -0,0 +1,573 @@
+#include <wui/control/log_view.hpp>
+
+#include <wui/window/window.hpp>
+
+#include <wui/framework/framework.hpp>
+
+#include <wui/theme/theme.hpp>
+
+#include <wui/system/tools.hpp>
+
+#include <wui/common/flag_helpers.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace wui
+{
+
+static const int32_t log_view_horizontal_indent = 5;
+static const int32_t log_view_vertical_indent = 2;
+static const int32_t log_view_scrollbar_width = 14;
+
+log_view::log_view(size_t max_lines_, size_t arena_size_, std::string_view theme_control_name_, std::shared_ptr<i_theme> theme__)
+    : max_lines(max_lines_ > 0 ? max_lines_ : 1),
+    arena_size(arena_size_ > 0 ? arena_size_ : 1),
+    arena(arena_size),
+    slots(new slot[max_lines]),
+    reserved_lines(0), reserved_bytes(0),
+    appended(false),
+    committed_lines(0), first_line(0),
+    tcn(theme_control_name_),
+    tcn_keys(tcn, theme_values),
+    theme_(theme__),
+    position_(),
+    parent_(),
+    my_control_sid(),
+    vert_scroll(std::make_shared<scroll>(0, 0, orientation::vertical, std::bind(&log_view::on_scroll, this, std::placeholders::_1, std::placeholders::_2), scroll::tc, theme__)),
+    alive(std::make_shared<log_view*>(this)),
+    line_height(0),
+    showed_(true), enabled_(true), topmost_(false), focused_(false),
+    follow_tail_(true),
+    mouse_on_slider(false)
+{
+    for (size_t i = 0; i != max_lines; ++i)
+    {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+        slots[i].offset.store(0, std::memory_order_relaxed);
+        slots[i].length.store(0, std::memory_order_relaxed);
+    }
+}
+
+log_view::~log_view()
+{
+    *alive = nullptr;
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->remove_control(shared_from_this());
+    }
+}
+
+void log_view::draw(graphic &gr, const rect &)
+{
+    if (!showed_ || position_.width() == 0 || position_.height() == 0)
+    {
+        return;
+    }
+
+    auto control_pos = position();
+
+    gr.draw_rect(control_pos,
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
+
+    vert_scroll->draw(gr, {});
+
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
+
+    auto line_height_ = gr.measure_text("Qq", font_).height() + log_view_vertical_indent;
+    if (line_height_ != line_height)
+    {
+        line_height = line_height_;
+        update_scroll_area();
+    }
+
+    auto area = text_area();
+    if (area.width() <= 0 || area.height() <= 0 || line_height <= 0)
+    {
+        return;
+    }
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    gr.push_clip(area);
+
+    /// Only the lines under the clip are read from the ring and drawn
+    auto clip_ = gr.clip();
+    auto first_row = std::max((clip_.top - area.top + scroll_pos) / line_height, 0),
+        last_row = std::min((clip_.bottom - area.top + scroll_pos) / line_height + 1, line_count());
+
+    auto text_color = theme_color(tcn_keys[tk_title_text], theme_);
+
+    std::string text_;
+    for (auto row = first_row; row < last_row; ++row)
+    {
+        if (read_line(first_line + row, text_))
+        {
+            gr.draw_text({ area.left, area.top + row * line_height - scroll_pos + log_view_vertical_indent / 2 }, text_, text_color, font_);
+        }
+    }
+
+    gr.pop_clip();
+}
+
+rect log_view::text_area() const
+{
+    auto control_pos = position();
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    return { control_pos.left + border_width + log_view_horizontal_indent,
+        control_pos.top + border_width + log_view_vertical_indent,
+        control_pos.right - border_width - log_view_scrollbar_width,
+        control_pos.bottom - border_width - log_view_vertical_indent };
+}
+
+void log_view::append(std::string_view text_)
+{
+    /// The line longer than the quarter of the arena is cut, so the arena holds several lines anyway
+    auto max_length = std::min(arena_size / 4 + 1, static_cast<size_t>(UINT32_MAX));
+
+    if (!text_.empty() && text_.back() == '\n')
+    {
+        text_.remove_suffix(1);
+    }
+
+    size_t start = 0;
+    while (start <= text_.size())
+    {
+        auto end = text_.find('\n', start);
+        if (end == std::string_view::npos)
+        {
+            end = text_.size();
+        }
+
+        auto line_ = text_.substr(start, end - start);
+        if (!line_.empty() && line_.back() == '\r')
+        {
+            line_.remove_suffix(1);
+        }
+        line_ = line_.substr(0, max_length);
+
+        /// Each writer reserves its line number and its bytes, so the writers don't wait each other
+        auto n = reserved_lines.fetch_add(1, std::memory_order_relaxed);
+        auto offset = reserved_bytes.fetch_add(line_.size(), std::memory_order_relaxed);
+
+        /// The slot is marked as being written before anything of it or of the arena is touched,
+        /// so the reader of the lapped line sees the changed sequence after its copy
+        auto &slot_ = slots[n % max_lines];
+        slot_.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto pos = static_cast<size_t>(offset % arena_size);
+        auto head = std::min(line_.size(), arena_size - pos);
+        memcpy(arena.data() + pos, line_.data(), head);
+        memcpy(arena.data(), line_.data() + head, line_.size() - head);
+
+        slot_.offset.store(offset, std::memory_order_relaxed);
+        slot_.length.store(static_cast<uint32_t>(line_.size()), std::memory_order_relaxed);
+        slot_.sequence.store(n + 1, std::memory_order_release);
+
+        start = end + 1;
+    }
+
+    /// Only the first append after the update posts the next one, so nothing is polled while the log is idle
+    if (!appended.exchange(true, std::memory_order_acq_rel))
+    {
+        auto owner = alive;
+        framework::post([owner]() {
+            if (*owner)
+            {
+                (*owner)->update();
+            }
+        });
+    }
+}
+
+/// The line is copied and checked after it like the seqlock: if the slot or the bytes were taken by the newer line while copying, the copy is dropped
+bool log_view::read_line(uint64_t n, std::string &out) const
+{
+    auto &slot_ = slots[n % max_lines];
+
+    if (slot_.sequence.load(std::memory_order_acquire) != n + 1)
+    {
+        return false;
+    }
+
+    auto offset = slot_.offset.load(std::memory_order_relaxed);
+    auto length = slot_.length.load(std::memory_order_relaxed);
+
+    auto pos = static_cast<size_t>(offset % arena_size);
+    auto head = std::min(static_cast<size_t>(length), arena_size - pos);
+
+    out.resize(length);
+    memcpy(&out[0], arena.data() + pos, head);
+    memcpy(&out[0] + head, arena.data(), length - head);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return slot_.sequence.load(std::memory_order_relaxed) == n + 1 &&
+        reserved_bytes.load(std::memory_order_relaxed) <= offset + arena_size;
+}
+
+void log_view::update()
+{
+    if (!appended.exchange(false, std::memory_order_acquire))
+    {
+        return;
+    }
+
+    auto old_count = line_count();
+    auto old_first = first_line;
+
+    /// The lines are shown in their order, the line being written holds the next ones till its append posts the next update.
+    /// The writer lapped by max_lines lines is skipped
+    auto reserved = reserved_lines.load(std::memory_order_relaxed);
+    if (reserved - committed_lines > max_lines)
+    {
+        committed_lines = reserved - max_lines;
+    }
+    while (committed_lines != reserved && slots[committed_lines % max_lines].sequence.load(std::memory_order_acquire) > committed_lines)
+    {
+        ++committed_lines;
+    }
+
+    /// The oldest lines go out of the view when their slot or their bytes are taken by the new lines
+    first_line = std::max(first_line, committed_lines > max_lines ? committed_lines - max_lines : 0);
+    auto bytes_end = reserved_bytes.load(std::memory_order_relaxed);
+    while (first_line != committed_lines)
+    {
+        auto &slot_ = slots[first_line % max_lines];
+        if (slot_.sequence.load(std::memory_order_acquire) == first_line + 1 && slot_.offset.load(std::memory_order_relaxed) + arena_size >= bytes_end)
+        {
+            break;
+        }
+        ++first_line;
+    }
+
+    if (line_count() == old_count && first_line == old_first)
+    {
+        return;
+    }
+
+    auto scroll_pos = vert_scroll->get_scroll_pos();
+
+    update_scroll_area();
+
+    if (follow_tail_)
+    {
+        vert_scroll->set_scroll_pos(std::max(line_count() * line_height - text_area().height(), 0));
+    }
+    else
+    {
+        /// Keeps the shown lines on their place while they are in the ring
+        vert_scroll->set_scroll_pos(std::max(scroll_pos - static_cast<int32_t>(first_line - old_first) * line_height, 0));
+    }
+
+    redraw();
+}
+
+void log_view::update_scroll_area()
+{
+    vert_scroll->set_area(std::max(line_count() * line_height - text_area().height(), 0));
+}
+
+void log_view::receive_control_events(const event &ev)
+{
+    if (!showed_ || !enabled_)
+    {
+        return;
+    }
+
+    if (ev.type == event_type::mouse)
+    {
+        /// The scrollbar is added to the window before the control, so the control takes its events and gives them to it
+        if (vert_scroll->position().in(ev.mouse_event_.x, ev.mouse_event_.y))
+        {
+            if (!mouse_on_slider)
+            {
+                mouse_on_slider = true;
+
+                event sev = ev;
+                sev.mouse_event_.type = wui::mouse_event_type::enter;
+
+                return vert_scroll->receive_control_events(sev);
+            }
+
+            return vert_scroll->receive_control_events(ev);
+        }
+        else if (mouse_on_slider)
+        {
+            mouse_on_slider = false;
+
+            event sev = ev;
+            sev.mouse_event_.type = wui::mouse_event_type::leave;
+
+            vert_scroll->receive_control_events(sev);
+        }
+
+        switch (ev.mouse_event_.type)
+        {
+            case mouse_event_type::wheel:
+                if (ev.mouse_event_.wheel_delta > 0)
+                {
+                    vert_scroll->scroll_up();
+                }
+                else
+                {
+                    vert_scroll->scroll_down();
+                }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::keyboard)
+    {
+        switch (ev.keyboard_event_.type)
+        {
+            case keyboard_event_type::down:
+            {
+                auto page = std::max(text_area().height() - line_height, line_height);
+
+                switch (ev.keyboard_event_.key[0])
+                {
+                    case vk_up: case vk_nup:
+                        vert_scroll->scroll_up();
+                    break;
+                    case vk_down: case vk_ndown:
+                        vert_scroll->scroll_down();
+                    break;
+                    case vk_page_up: case vk_npage_up:
+                        vert_scroll->set_scroll_pos(vert_scroll->get_scroll_pos() - page);
+                    break;
+                    case vk_page_down: case vk_npage_down:
+                        vert_scroll->set_scroll_pos(vert_scroll->get_scroll_pos() + page);
+                    break;
+                    case vk_home: case vk_nhome:
+                        vert_scroll->set_scroll_pos(0);
+                    break;
+                    case vk_end: case vk_nend:
+                        set_follow_tail(true);
+                    break;
+                    default: break;
+                }
+            }
+            break;
+            default: break;
+        }
+    }
+    else if (ev.type == event_type::internal)
+    {
+        switch (ev.internal_event_.type)
+        {
+            case internal_event_type::set_focus:
+                focused_ = true;
+                redraw();
+            break;
+            case internal_event_type::remove_focus:
+                focused_ = false;
+                redraw();
+            break;
+            default: break;
+        }
+    }
+}
+
+/// Scrolling to the end follows the tail again, scrolling up stops it
+void log_view::on_scroll(scroll_state, int32_t scroll_pos)
+{
+    follow_tail_ = scroll_pos >= line_count() * line_height - text_area().height();
+
+    redraw();
+}
+
+void log_view::set_position(const rect &position__, bool redraw)
+{
+    update_control_position(position_, position__, showed_ && redraw, parent_);
+
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
+
+    vert_scroll->set_position({ position_.right - log_view_scrollbar_width - border_width,
+        position_.top + border_width,
+        position_.right - border_width,
+        position_.bottom - border_width });
+
+    update_scroll_area();
+}
+
+rect log_view::position() const
+{
+    return get_control_position(position_, parent_);
+}
+
+void log_view::set_parent(std::shared_ptr<window> window_)
+{
+    parent_ = window_;
+    my_control_sid = window_->subscribe(std::bind(&log_view::receive_control_events, this, std::placeholders::_1),
+        wui::flags_map<wui::event_type>(3, wui::event_type::internal, wui::event_type::mouse, wui::event_type::keyboard),
+        shared_from_this());
+
+    window_->add_control(vert_scroll, { 0 });
+}
+
+std::weak_ptr<window> log_view::parent() const
+{
+    return parent_;
+}
+
+void log_view::clear_parent()
+{
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->remove_control(vert_scroll);
+        parent__->unsubscribe(my_control_sid);
+    }
+    parent_.reset();
+}
+
+void log_view::set_topmost(bool yes)
+{
+    topmost_ = yes;
+}
+
+bool log_view::topmost() const
+{
+    return topmost_;
+}
+
+bool log_view::focused() const
+{
+    return focused_;
+}
+
+bool log_view::focusing() const
+{
+    return enabled_ && showed_;
+}
+
+error log_view::get_error() const
+{
+    return {};
+}
+
+void log_view::update_theme_control_name(std::string_view theme_control_name)
+{
+    tcn = theme_control_name;
+    tcn_keys.reset();
+    update_theme(theme_);
+}
+
+void log_view::update_theme(std::shared_ptr<i_theme> theme__)
+{
+    if (theme_ && !theme__)
+    {
+        return;
+    }
+    theme_ = theme__;
+
+    vert_scroll->update_theme(theme_);
+
+    redraw();
+}
+
+void log_view::show()
+{
+    showed_ = true;
+    vert_scroll->show();
+    redraw();
+}
+
+void log_view::hide()
+{
+    showed_ = false;
+    vert_scroll->hide();
+
+    auto parent__ = parent_.lock();
+    if (parent__)
+    {
+        parent__->redraw(position(), true);
+    }
+}
+
+bool log_view::showed() const
+{
+    return showed_;
+}
+
+void log_view::enable()
+{
+    enabled_ = true;
+    redraw();
+}
+
+void log_view::disable()
+{
+    enabled_ = false;
+    redraw();
+}
+
+bool log_view::enabled() const
+{
+    return enabled_;
+}
+
+void log_view::clear()
+{
+    committed_lines = reserved_lines.load(std::memory_order_relaxed);
+    first_line = committed_lines;
+
+    update_scroll_area();
+    vert_scroll->set_scroll_pos(0);
+    follow_tail_ = true;
+
+    redraw();
+}
+
+int32_t log_view::line_count() const
+{
+    return static_cast<int32_t>(committed_lines - first_line);
+}
+
+std::string log_view::line(int32_t n) const
+{
+    std::string text_;
+    if (n < 0 || n >= line_count() || !read_line(first_line + n, text_))
+    {
+        return "";
+    }
+    return text_;
+}
+
+void log_view::set_follow_tail(bool yes)
+{
+    follow_tail_ = yes;
+    if (follow_tail_)
+    {
+        vert_scroll->set_scroll_pos(std::max(line_count() * line_height - text_area().height(), 0));
+        redraw();
+    }
+}
+
+bool log_view::follow_tail() const
+{
+    return follow_tail_;
+}
+
+void log_view::redraw()
+{
+    if (showed_)
+    {
+        auto parent__ = parent_.lock();
+        if (parent__)
+        {
+            parent__->redraw(position());
+        }
+    }
+}
+
+}
@@ -16,54 +16,26 @@
 namespace wui
 {
 
-int32_t calc_items_count(const menu_items_t &items)
+/// Appends the shown rows of the items, the children of the expanded item follow it
+static void flatten(menu_items_t &items, int32_t level, std::vector<menu_item*> &rows)
 {
-    int32_t count = 0;
     for (auto &item : items)
     {
-        ++count;
-        if (!item.children.empty() && item.state == menu_item_state::expanded)
-        {
-            count += calc_items_count(item.children);
-        }
-    }
-    return count;
-}
-
-menu_item *get_item(menu_items_t &items, int32_t n_item, int32_t pos = 0, int32_t level = 0)
-{
-    int32_t count = pos;
-    for (auto &item : items)
-    {
-        if (count == n_item)
-        {
-            item.level = level;
-            return &item;
-        }
+        item.level = level;
+        rows.emplace_back(&item);
 
         if (!item.children.empty() && item.state == menu_item_state::expanded)
         {
-            auto children_count = calc_items_count(item.children);
-            if (n_item <= count + children_count)
-            {
-                return get_item(item.children, n_item - 1, count, level + 1);
-            }
-            else
-            {
-                count += children_count;
-            }
+            flatten(item.children, level + 1, rows);
         }
-
-        ++count;
     }
-
-    return nullptr;
 }
 
 menu::menu(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : list_theme(make_custom_theme()),
     list_(std::make_shared<list>(list::tc, list_theme)),
     tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -71,6 +43,8 @@ menu::menu(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__
     activation_control(),
     indent(0), x(-1), y(-1),
     items(),
+    rows(),
+    ids(),
     max_text_width(0), max_hotkey_width(0),
     item_height_(32),
     showed_(false),
@@ -143,14 +117,14 @@ void menu::update_list_theme()
 {
     list_theme->load_theme(theme_ ? *theme_ : *get_default_theme());
 
-    list_theme->set_color(list::tc, list::tv_background, theme_color(tcn, tv_background, theme_));
-    list_theme->set_color(list::tc, list::tv_border, theme_color(tcn, tv_border, theme_));
-    list_theme->set_color(list::tc, list::tv_focused_border, theme_color(tcn, tv_border, theme_));
-    list_theme->set_dimension(list::tc, list::tv_border_width, theme_dimension(tcn, tv_border_width, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_background, theme_color(tcn, tv_scrollbar, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_slider, theme_color(tcn, tv_scrollbar_slider, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_slider_acive, theme_color(tcn, tv_scrollbar_slider_acive, theme_));
-    list_theme->set_dimension(list::tc, list::tv_round, theme_dimension(tcn, tv_round, theme_));
+    list_theme->set_color(list::tc, list::tv_background, theme_color(tcn_keys[tk_background], theme_));
+    list_theme->set_color(list::tc, list::tv_border, theme_color(tcn_keys[tk_border], theme_));
+    list_theme->set_color(list::tc, list::tv_focused_border, theme_color(tcn_keys[tk_border], theme_));
+    list_theme->set_dimension(list::tc, list::tv_border_width, theme_dimension(tcn_keys[tk_border_width], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_background, theme_color(tcn_keys[tk_scrollbar], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider, theme_color(tcn_keys[tk_scrollbar_slider], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider_acive, theme_color(tcn_keys[tk_scrollbar_slider_acive], theme_));
+    list_theme->set_dimension(list::tc, list::tv_round, theme_dimension(tcn_keys[tk_round], theme_));
 }
 
 void menu::receive_event(const event &ev)
@@ -210,6 +184,7 @@ error menu::get_error() const
 void menu::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -266,43 +241,68 @@ bool menu::enabled() const
 void menu::set_items(const menu_items_t &items_)
 {
     items = items_;
-    list_->set_item_count(calc_items_count(items));
+    rebuild_index();
     size_updated = false;
 }
 
 void menu::update_item(const menu_item &mi)
 {
-    auto it = std::find(items.begin(), items.end(), mi.id);
-    if (it != items.end())
+    auto it = ids.find(mi.id);
+    if (it == ids.end())
+    {
+        return;
+    }
+    auto item = &(*it->second.siblings)[it->second.index];
+
+    /// Only the rows of the item and its children are replaced
+    auto n_item = it->second.row;
+    auto old_children = n_item != -1 ? shown_children(n_item) : 0;
+    auto level = item->level;
+
+    forget_items(item->children);
+    *item = mi;
+    item->level = level;
+    index_items(item->children);
+
+    if (n_item != -1)
     {
-        *it = mi;
+        std::vector<menu_item*> children;
+        if (item->state == menu_item_state::expanded)
+        {
+            flatten(item->children, level + 1, children);
+        }
+
+        erase_rows(n_item + 1, old_children, true);
+        insert_rows(n_item + 1, children);
+
+        list_->remove_items(n_item + 1, old_children);
+        list_->insert_items(n_item + 1, static_cast<int32_t>(children.size()));
+        list_->update_items(n_item, 1);
     }
-    list_->set_item_count(calc_items_count(items));
+
+    size_updated = false;
 }
 
 void menu::swap_items(int32_t first_item_id, int32_t second_item_id)
 {
-    auto first_it = std::find(items.begin(), items.end(), first_item_id);
-    if (first_it != items.end())
+    auto first_item = find_item(first_item_id), second_item = find_item(second_item_id);
+    if (first_item && second_item)
     {
-        auto second_it = std::find(items.begin(), items.end(), second_item_id);
-        if (second_it != items.end())
-        {
-            std::swap(*first_it, *second_it);
-        }
+        std::swap(*first_item, *second_item);
+        rebuild_index();
     }
-    list_->set_item_count(calc_items_count(items));
 }
 
 void menu::delete_item(int32_t id)
 {
-    auto it = std::find(items.begin(), items.end(), id);
-    if (it != items.end())
+    auto it = ids.find(id);
+    if (it != ids.end())
     {
-        items.erase(it);
+        auto &siblings = *it->second.siblings;
+        siblings.erase(siblings.begin() + it->second.index);
+        rebuild_index();
         size_updated = false;
     }
-    list_->set_item_count(calc_items_count(items));
 }
 
 void menu::set_item_height(int32_t item_height__)
@@ -311,6 +311,99 @@ void menu::set_item_height(int32_t item_height__)
     size_updated = false;
 }
 
+/// The moving of the items in the tree changes their addresses, so the index is built again by one walk
+void menu::rebuild_index()
+{
+    ids.clear();
+    index_items(items);
+
+    rows.clear();
+    flatten(items, 0, rows);
+    update_rows_index(0);
+
+    list_->set_item_count(static_cast<int32_t>(rows.size()));
+}
+
+void menu::index_items(menu_items_t &items_)
+{
+    for (size_t i = 0; i != items_.size(); ++i)
+    {
+        ids.emplace(items_[i].id, item_place{ &items_, i, -1 });
+        index_items(items_[i].children);
+    }
+}
+
+void menu::forget_items(const menu_items_t &items_)
+{
+    for (auto &item : items_)
+    {
+        ids.erase(item.id);
+        forget_items(item.children);
+    }
+}
+
+void menu::insert_rows(int32_t first, const std::vector<menu_item*> &rows_)
+{
+    rows.insert(rows.begin() + first, rows_.begin(), rows_.end());
+    update_rows_index(first);
+}
+
+/// The forgotten rows are already out of the index and may point to the replaced items, so they are not read
+void menu::erase_rows(int32_t first, int32_t count, bool forgotten)
+{
+    if (!forgotten)
+    {
+        for (auto i = first; i != first + count; ++i)
+        {
+            auto it = ids.find(rows[i]->id);
+            if (it != ids.end() && it->second.row == i)
+            {
+                it->second.row = -1;
+            }
+        }
+    }
+
+    rows.erase(rows.begin() + first, rows.begin() + first + count);
+    update_rows_index(first);
+}
+
+/// The rows from the first are shifted by the insertion or erasure, so their numbers are written again
+void menu::update_rows_index(int32_t first)
+{
+    for (auto i = static_cast<size_t>(first); i < rows.size(); ++i)
+    {
+        auto it = ids.find(rows[i]->id);
+        if (it != ids.end() && &(*it->second.siblings)[it->second.index] == rows[i])
+        {
+            it->second.row = static_cast<int32_t>(i);
+        }
+    }
+}
+
+menu_item *menu::find_item(int32_t id)
+{
+    auto it = ids.find(id);
+    return it != ids.end() ? &(*it->second.siblings)[it->second.index] : nullptr;
+}
+
+menu_item *menu::row_item(int32_t n_item)
+{
+    return n_item >= 0 && n_item < static_cast<int32_t>(rows.size()) ? rows[n_item] : nullptr;
+}
+
+/// The count of the rows of the shown children, grandchildren and so on
+int32_t menu::shown_children(int32_t n_item) const
+{
+    auto level = rows[n_item]->level;
+
+    int32_t count = 0;
+    for (auto i = static_cast<size_t>(n_item) + 1; i < rows.size() && rows[i]->level > level; ++i)
+    {
+        ++count;
+    }
+    return count;
+}
+
 void menu::update_size()
 {
     if (size_updated || items.empty())
@@ -333,19 +426,13 @@ void menu::update_size()
     graphic mem_gr(ctx);
     mem_gr.init({ 0, 0, 1920, 1080 }, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
 
     max_text_width = 0, max_hotkey_width = 0;
 
-    auto items_count = calc_items_count(items);
-    for (int i = 0; i != items_count; ++i)
+    auto items_count = static_cast<int32_t>(rows.size());
+    for (auto *item : rows)
     {
-        auto *item = get_item(items, i);
-        if (!item)
-        {
-            continue;
-        }
-
         auto text_width = mem_gr.measure_text(item->text, font_).right;
         auto hotkey_width = mem_gr.measure_text(item->hotkey, font_).right;
         if (hotkey_width != 0)
@@ -418,7 +505,7 @@ void menu::show_on_point(int32_t x_, int32_t y_)
 
 void menu::draw_arrow_down(graphic &gr, rect pos, bool expanded)
 {
-    auto color = theme_color(tcn, !expanded ? tv_text : tv_scrollbar_slider_acive, theme_);
+    auto color = theme_color(tcn_keys[!expanded ? tk_text : tk_scrollbar_slider_acive], theme_);
 
     int w = 8, h = 4;
 
@@ -434,17 +521,17 @@ void menu::draw_arrow_down(graphic &gr, rect pos, bool expanded)
 
 void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, list::item_state state)
 {
-    auto item = get_item(items, n_item);
+    auto item = row_item(n_item);
     if (!item)
     {
         return;
     }
 
-    auto border_width = theme_dimension(tcn, tv_border_width);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width]);
 
     if (state == list::item_state::selected)
     {
-        gr.draw_rect({ item_rect.left, item_rect.top, item_rect.right, item_rect.bottom }, theme_color(tcn, tv_selected_item));
+        gr.draw_rect({ item_rect.left, item_rect.top, item_rect.right, item_rect.bottom }, theme_color(tcn_keys[tk_selected_item]));
     }
     
     if (item->image_)
@@ -462,8 +549,8 @@ void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, li
         item->image_->draw(gr, { 0 });
     }
 
-    auto text_color = item->state != menu_item_state::disabled ? theme_color(tcn, tv_text) : theme_color(tcn, tv_disabled_text);
-    auto font = theme_font(tcn, tv_font);
+    auto text_color = item->state != menu_item_state::disabled ? theme_color(tcn_keys[tk_text]) : theme_color(tcn_keys[tk_disabled_text]);
+    auto font = theme_font(tcn_keys[tk_font]);
 
     auto text_height = gr.measure_text("Qq", font).height();
     
@@ -492,7 +579,7 @@ void menu::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, li
 
 void menu::activate_list_item(int32_t n_item)
 {
-    auto item = get_item(items, n_item);
+    auto item = row_item(n_item);
     if (!item)
     {
         return;
@@ -504,13 +591,24 @@ void menu::activate_list_item(int32_t n_item)
         {
             item->prev_state = item->state;
             item->state = menu_item_state::expanded;
+
+            std::vector<menu_item*> children;
+            flatten(item->children, item->level + 1, children);
+
+            insert_rows(n_item + 1, children);
+            list_->insert_items(n_item + 1, static_cast<int32_t>(children.size()));
         }
         else
         {
             item->state = item->prev_state;
+
+            auto children_count = shown_children(n_item);
+
+            erase_rows(n_item + 1, children_count, false);
+            list_->remove_items(n_item + 1, children_count);
         }
+        list_->update_items(n_item, 1);
         size_updated = false;
-        list_->set_item_count(calc_items_count(items));
         show_on_control(activation_control, indent, x, y);
     }
     
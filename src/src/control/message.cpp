@@ -19,7 +19,7 @@ message::message(std::shared_ptr<wui::window> transient_window__,
     transient_window_(transient_window__), docked_(docked__),
     theme_(theme__),
 	window_(std::make_shared<window>(window::tc, theme_)),
-    icon(std::make_shared<image>(theme_image("message_info", theme_))),
+    icon(std::make_shared<image>("message_info", theme_)),
     text_(std::make_shared<text>("", hori_alignment::left, vert_alignment::top, text::tc, theme_)),
     button0(std::make_shared<button>("", std::bind(&message::button0_click, this), button::tc, theme_)),
     button1(std::make_shared<button>("", std::bind(&message::button1_click, this), button::tc, theme_)),
@@ -55,16 +55,16 @@ void message::show(std::string_view message_,
     switch (icon_)
     {
         case message_icon::alert:
-            icon->change_image(theme_image("message_alert", theme_));
+            icon->change_image("message_alert");
         break;
         case message_icon::information:
-            icon->change_image(theme_image("message_info", theme_));
+            icon->change_image("message_info");
         break;
         case message_icon::question:
-            icon->change_image(theme_image("message_question", theme_));
+            icon->change_image("message_question");
         break;
         case message_icon::stop:
-            icon->change_image(theme_image("message_stop", theme_));
+            icon->change_image("message_stop");
         break;
     }
 
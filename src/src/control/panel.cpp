@@ -12,6 +12,7 @@ namespace wui
 
 panel::panel(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -22,6 +23,7 @@ panel::panel(std::string_view theme_control_name, std::shared_ptr<i_theme> theme
 
 panel::panel(std::function<void(graphic&)> draw_callback_, std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -46,7 +48,7 @@ void panel::draw(graphic &gr, const rect &)
         return;
     }
 
-    gr.draw_rect(position(), theme_color(tcn, tv_background, theme_));
+    gr.draw_rect(position(), theme_color(tcn_keys[tk_background], theme_));
 
     if (draw_callback)
     {
@@ -107,6 +109,7 @@ error panel::get_error() const
 void panel::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -15,6 +15,7 @@ namespace wui
 
 progress::progress(int32_t from_, int32_t to_, int32_t value_, orientation orientation__, std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -44,11 +45,11 @@ void progress::draw(graphic &gr, const rect &)
 
     auto control_pos = position();
 
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     gr.draw_rect(control_pos,
-        theme_color(tcn, tv_border, theme_),
-        theme_color(tcn, tv_background, theme_),
+        theme_color(tcn_keys[tk_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
         border_width,
         0);
 
@@ -127,6 +128,7 @@ error progress::get_error() const
 void progress::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -18,6 +18,7 @@ scroll::scroll(int32_t area_, int32_t scroll_pos_,
     std::function<void(scroll_state, int32_t)> callback_,
     std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -29,7 +30,7 @@ scroll::scroll(int32_t area_, int32_t scroll_pos_,
     orientation_(orientation__),
     callback(callback_),
     worker_action_(worker_action::undefined),
-    worker(),
+    worker(std::bind(&scroll::work, this)),
     worker_runned(false),
     progress(0),
     scrollbar_state_(scrollbar_state::tiny),
@@ -62,9 +63,9 @@ void scroll::draw(graphic &gr, const rect &)
         return;
     }
 
-    gr.draw_rect(bar_rect, theme_color(tcn, tv_background, theme_));
+    gr.draw_rect(bar_rect, theme_color(tcn_keys[tk_background], theme_));
 
-    gr.draw_rect(up_button_rect, theme_color(tcn, tv_slider, theme_));
+    gr.draw_rect(up_button_rect, theme_color(tcn_keys[tk_slider], theme_));
     if (scrollbar_state_ == scrollbar_state::full)
     {
         if (orientation_ == orientation::vertical)
@@ -73,7 +74,7 @@ void scroll::draw(graphic &gr, const rect &)
             draw_arrow_left(gr, up_button_rect);
     }
 
-    gr.draw_rect(down_button_rect, theme_color(tcn, tv_slider, theme_));
+    gr.draw_rect(down_button_rect, theme_color(tcn_keys[tk_slider], theme_));
     if (scrollbar_state_ == scrollbar_state::full)
     {
         if (orientation_ == orientation::vertical)
@@ -82,7 +83,7 @@ void scroll::draw(graphic &gr, const rect &)
             draw_arrow_right(gr, down_button_rect);
     }
 
-    gr.draw_rect(slider_rect, theme_color(tcn, scrollbar_state_ == scrollbar_state::full ? tv_slider_acive : tv_slider, theme_));
+    gr.draw_rect(slider_rect, theme_color(tcn_keys[scrollbar_state_ == scrollbar_state::full ? tk_slider_acive : tk_slider], theme_));
 }
 
 void scroll::set_position(const rect &position__, bool redraw)
@@ -121,10 +122,10 @@ void scroll::clear_parent()
     if (parent__)
     {
         parent__->unsubscribe(my_control_sid);
-        my_control_sid.clear();
+        my_control_sid = 0;
 
         parent__->unsubscribe(my_plain_sid);
-        my_plain_sid.clear();
+        my_plain_sid = 0;
     }
     parent_.reset();
 }
@@ -157,6 +158,7 @@ error scroll::get_error() const
 void scroll::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -397,7 +399,7 @@ void scroll::redraw(bool clear)
 
 void scroll::draw_arrow_up(graphic& gr, rect button_pos)
 {
-    auto color = theme_color(tcn, tv_slider_acive, theme_);
+    auto color = theme_color(tcn_keys[tk_slider_acive], theme_);
 
     int w = 8, h = 4;
 
@@ -413,7 +415,7 @@ void scroll::draw_arrow_up(graphic& gr, rect button_pos)
 
 void scroll::draw_arrow_left(graphic& gr, rect button_pos)
 {
-    auto color = theme_color(tcn, tv_slider_acive, theme_);
+    auto color = theme_color(tcn_keys[tk_slider_acive], theme_);
 
     int w = 4, h = 8;
 
@@ -429,7 +431,7 @@ void scroll::draw_arrow_left(graphic& gr, rect button_pos)
 
 void scroll::draw_arrow_down(graphic& gr, rect button_pos)
 {
-    auto color = theme_color(tcn, tv_slider_acive, theme_);
+    auto color = theme_color(tcn_keys[tk_slider_acive], theme_);
 
     int w = 8, h = 4;
 
@@ -445,7 +447,7 @@ void scroll::draw_arrow_down(graphic& gr, rect button_pos)
 
 void scroll::draw_arrow_right(graphic& gr, rect button_pos)
 {
-    auto color = theme_color(tcn, tv_slider_acive, theme_);
+    auto color = theme_color(tcn_keys[tk_slider_acive], theme_);
 
     int w = 4, h = 8;
 
@@ -723,56 +725,59 @@ void scroll::start_work(worker_action action)
     if (!worker_runned)
     {
         worker_runned = true;
-        if (worker.joinable()) worker.join();
-        worker = std::thread(std::bind(&scroll::work, this));
+
+        work();
+
+        if (worker_runned)
+        {
+            worker.start(20);
+        }
     }
 }
 
 void scroll::work()
 {
-    while (worker_runned)
+    switch (worker_action_)
     {
-        switch (worker_action_)
+    case worker_action::scroll_up:
+        scroll_up();
+    break;
+    case worker_action::scroll_down:
+        scroll_down();
+    break;
+    case worker_action::scrollbar_show:
+        if (progress < full_scrollbar_size)
         {
-        case worker_action::scroll_up:
-            scroll_up();
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-        break;
-        case worker_action::scroll_down:
-            scroll_down();
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-        break;
-        case worker_action::scrollbar_show:
-            if (progress < full_scrollbar_size)
-            {
-                progress += 4;
+            progress += 4;
 
-                auto parent__ = parent_.lock();
-                if (parent__)
-                {
-                    auto control_pos = position();
-                    if (orientation_ == orientation::vertical)
-                        parent__->redraw({ control_pos.right - progress, control_pos.top, control_pos.right, control_pos.bottom });
-                    else
-                        parent__->redraw({ control_pos.left, control_pos.bottom - progress, control_pos.right, control_pos.bottom });
-                }
-            }
-            else
+            auto parent__ = parent_.lock();
+            if (parent__)
             {
-                worker_runned = false;
+                auto control_pos = position();
+                if (orientation_ == orientation::vertical)
+                    parent__->redraw({ control_pos.right - progress, control_pos.top, control_pos.right, control_pos.bottom });
+                else
+                    parent__->redraw({ control_pos.left, control_pos.bottom - progress, control_pos.right, control_pos.bottom });
             }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
-        break;
-        default: break;
         }
+        else
+        {
+            worker_runned = false;
+        }
+    break;
+    default: break;
+    }
+
+    if (!worker_runned)
+    {
+        worker.stop();
     }
 }
 
 void scroll::end_work()
 {
     worker_runned = false;
-    if (worker.joinable()) worker.join();
+    worker.stop();
 }
 
 }
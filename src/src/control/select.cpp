@@ -6,6 +6,8 @@
 
 #include <wui/theme/theme.hpp>
 
+#include <wui/framework/framework.hpp>
+
 #include <wui/system/tools.hpp>
 
 #include <wui/common/flag_helpers.hpp>
@@ -20,10 +22,15 @@ namespace wui
 
 static const int32_t select_horizontal_indent = 5;
 
+static const size_t search_chunk_size = 256;
+
 select::select(std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
-    : items_(),
+    : items_(std::make_shared<select_items_t>()),
+    items_version(0),
+    ids(),
     change_callback(),
     tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -34,7 +41,22 @@ select::select(std::string_view theme_control_name, std::shared_ptr<i_theme> the
     focused_(false),
     focusing_(true),
     left_shift(0),
-    item_height_(32)
+    item_height_(32),
+    filter(),
+    shown(),
+    filter_selected(-1),
+    quiet_selection(false),
+    search_mutex(),
+    search_cv(),
+    search_items(),
+    search_query(),
+    search_items_version(0),
+    search_generation(0),
+    search_pending(false), search_stopping(false),
+    search_worker(),
+    search_index(),
+    indexed_version(0),
+    alive(std::make_shared<select*>(this))
 {
     update_list_theme();
 
@@ -48,6 +70,19 @@ select::select(std::string_view theme_control_name, std::shared_ptr<i_theme> the
 
 select::~select()
 {
+    *alive = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(search_mutex);
+        search_stopping = true;
+    }
+    search_cv.notify_all();
+
+    if (search_worker.joinable())
+    {
+        search_worker.join();
+    }
+
     auto parent__ = parent_.lock();
     if (parent__)
     {
@@ -63,14 +98,14 @@ void select::draw(graphic &gr, const rect &)
     }
 
     auto control_pos = position();
-    auto border_width = theme_dimension(tcn, tv_border_width, theme_);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     /// Draw the frame
     gr.draw_rect(control_pos,
-        !focused_ ? theme_color(tcn, tv_border, theme_) : theme_color(tcn, tv_focused_border, theme_),
-        theme_color(tcn, tv_background, theme_),
+        !focused_ ? theme_color(tcn_keys[tk_border], theme_) : theme_color(tcn_keys[tk_focused_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
         border_width,
-        theme_dimension(tcn, tv_round, theme_));
+        theme_dimension(tcn_keys[tk_round], theme_));
 
     if (control_pos.width() < control_pos.height())
     {
@@ -81,14 +116,17 @@ void select::draw(graphic &gr, const rect &)
     draw_arrow_down(gr, { control_pos.right - static_cast<int32_t>(control_pos.height() / 1.5),
             control_pos.top + static_cast<int32_t>(control_pos.height() / 2.1)});
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
+
+    /// The typed filter is shown instead of the selected item while the dropdown is filtered
+    auto selected = filter.empty() ? list_->selected_item() : -1;
 
-    if (static_cast<int32_t>(items_.size()) <= list_->selected_item())
+    if (filter.empty() && (selected < 0 || static_cast<int32_t>(items_->size()) <= selected))
     {
         return;
     }
 
-    auto text = items_[list_->selected_item()].text;
+    auto text = filter.empty() ? (*items_)[selected].text : filter;
 
     auto text_size = gr.measure_text(text, font_);
 
@@ -97,13 +135,13 @@ void select::draw(graphic &gr, const rect &)
     gr.draw_text({ control_pos.left + border_width + select_horizontal_indent,
         control_pos.top + (control_pos.height() - text_size.height()) / 2 },
         text,
-        theme_color(tcn, tv_text, theme_),
+        theme_color(tcn_keys[tk_text], theme_),
         font_);
 }
 
 void select::draw_arrow_down(graphic &gr, rect pos)
 {
-    auto color = theme_color(tcn, !active ? tv_border : tv_focused_border, theme_);
+    auto color = theme_color(tcn_keys[!active ? tk_border : tk_focused_border], theme_);
 
     int w = 8, h = 4;
 
@@ -119,7 +157,7 @@ void select::draw_arrow_down(graphic &gr, rect pos)
 
 void select::select_up()
 {
-    if (!items_.empty() && list_->selected_item() > 0)
+    if (row_count() != 0 && list_->selected_item() > 0)
     {
         list_->select_item(list_->selected_item() - 1);
         redraw();
@@ -128,7 +166,7 @@ void select::select_up()
 
 void select::select_down()
 {
-    if (!items_.empty() && list_->selected_item() < static_cast<int32_t>(items_.size()) - 1)
+    if (list_->selected_item() < row_count() - 1)
     {
         list_->select_item(list_->selected_item() + 1);
         redraw();
@@ -137,7 +175,7 @@ void select::select_down()
 
 void select::show_list()
 {
-    list_->set_position({ position_.left, position_.top, position_.right, position_.top + item_height_ * static_cast<int32_t>(items_.size()) });
+    list_->set_position({ position_.left, position_.top, position_.right, position_.top + item_height_ * static_cast<int32_t>(items_->size()) });
     auto pos = get_popup_position(parent_, position(), list_->position(), 0);
 
     list_->set_position(pos, true);
@@ -150,6 +188,16 @@ void select::show_list()
     }
 }
 
+void select::hide_list()
+{
+    list_->hide();
+
+    if (!filter.empty())
+    {
+        update_filter("");
+    }
+}
+
 void select::receive_control_events(const event &ev)
 {
     if (!showed_ || !enabled_)
@@ -187,7 +235,7 @@ void select::receive_control_events(const event &ev)
                 }
                 else
                 {
-                    list_->hide();
+                    hide_list();
                 }
             break;
         }
@@ -206,16 +254,16 @@ void select::receive_control_events(const event &ev)
                         select_down();
                     break;
                     case vk_home: case vk_page_up:
-                        if (!items_.empty())
+                        if (row_count() != 0)
                         {
                             list_->select_item(0);
                             redraw();
                         }
                     break;
                     case vk_end: case vk_nend: case vk_page_down: case vk_npage_down:
-                        if (!items_.empty())
+                        if (row_count() != 0)
                         {
-                            list_->select_item(static_cast<int32_t>(items_.size() - 1));
+                            list_->select_item(row_count() - 1);
                             redraw();
                         }
                     break;
@@ -257,7 +305,7 @@ void select::receive_plain_events(const event &ev)
             !list_->position().in({ ev.mouse_event_.x, ev.mouse_event_.y, ev.mouse_event_.x, ev.mouse_event_.y }) &&
             !position().in({ ev.mouse_event_.x, ev.mouse_event_.y, ev.mouse_event_.x, ev.mouse_event_.y }))
         {
-            list_->hide();
+            hide_list();
         }
         break;
     case event_type::keyboard:
@@ -265,7 +313,30 @@ void select::receive_plain_events(const event &ev)
         {
             if (ev.keyboard_event_.key[0] == vk_esc)
             {
-                list_->hide();
+                hide_list();
+            }
+        }
+        else if (ev.keyboard_event_.type == keyboard_event_type::down)
+        {
+            if (ev.keyboard_event_.key[0] == vk_back && !filter.empty())
+            {
+                auto filter_ = filter;
+                uint8_t removed = 0;
+                do
+                {
+                    removed = static_cast<uint8_t>(filter_.back());
+                    filter_.pop_back();
+                }
+                while (!filter_.empty() && (removed & 0xC0) == 0x80); /// the whole utf-8 codepoint, the lead byte too
+
+                update_filter(filter_);
+            }
+        }
+        else if (ev.keyboard_event_.type == keyboard_event_type::key)
+        {
+            if (static_cast<uint8_t>(ev.keyboard_event_.key[0]) >= 0x20 && ev.keyboard_event_.key[0] != 0x7f)
+            {
+                update_filter(filter + std::string(ev.keyboard_event_.key, ev.keyboard_event_.key_size));
             }
         }
         break;
@@ -276,14 +347,14 @@ void select::update_list_theme()
 {
     list_theme->load_theme(theme_ ? *theme_ : *get_default_theme());
 
-    list_theme->set_color(list::tc, list::tv_background, theme_color(tcn, tv_background, theme_));
-    list_theme->set_color(list::tc, list::tv_border, theme_color(tcn, tv_border, theme_));
-    list_theme->set_color(list::tc, list::tv_focused_border, theme_color(tcn, tv_border, theme_));
-    list_theme->set_dimension(list::tc, list::tv_border_width, theme_dimension(tcn, tv_border_width, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_background, theme_color(tcn, tv_scrollbar, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_slider, theme_color(tcn, tv_scrollbar_slider, theme_));
-    list_theme->set_color(scroll::tc, scroll::tv_slider_acive, theme_color(tcn, tv_scrollbar_slider_acive, theme_));
-    list_theme->set_dimension(list::tc, list::tv_round, theme_dimension(tcn, tv_round, theme_));
+    list_theme->set_color(list::tc, list::tv_background, theme_color(tcn_keys[tk_background], theme_));
+    list_theme->set_color(list::tc, list::tv_border, theme_color(tcn_keys[tk_border], theme_));
+    list_theme->set_color(list::tc, list::tv_focused_border, theme_color(tcn_keys[tk_border], theme_));
+    list_theme->set_dimension(list::tc, list::tv_border_width, theme_dimension(tcn_keys[tk_border_width], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_background, theme_color(tcn_keys[tk_scrollbar], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider, theme_color(tcn_keys[tk_scrollbar_slider], theme_));
+    list_theme->set_color(scroll::tc, scroll::tv_slider_acive, theme_color(tcn_keys[tk_scrollbar_slider_acive], theme_));
+    list_theme->set_dimension(list::tc, list::tv_round, theme_dimension(tcn_keys[tk_round], theme_));
 }
 
 void select::set_position(const rect &position__, bool redraw)
@@ -327,10 +398,10 @@ void select::clear_parent()
         parent__->remove_control(list_);
         
         parent__->unsubscribe(my_control_sid);
-        my_control_sid.clear();
+        my_control_sid = 0;
 
         parent__->unsubscribe(my_plain_sid);
-        my_plain_sid.clear();
+        my_plain_sid = 0;
     }
     parent_.reset();
 }
@@ -363,6 +434,7 @@ error select::get_error() const
 void select::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -417,42 +489,76 @@ bool select::enabled() const
 
 void select::set_items(const select_items_t &items__)
 {
-    items_ = items__;
-    list_->set_item_count(static_cast<int32_t>(items_.size()));
+    items_ = std::make_shared<select_items_t>(items__);
+    items_changed();
+}
+
+void select::set_items(select_items_t &&items__)
+{
+    items_ = std::make_shared<select_items_t>(std::move(items__));
+    items_changed();
 }
 
 void select::update_item(const select_item &si)
 {
-    auto it = std::find(items_.begin(), items_.end(), si.id);
-    if (it != items_.end())
+    auto it = ids.find(si.id);
+    if (it == ids.end())
+    {
+        return;
+    }
+
+    auto n = it->second;
+    own_items()[n] = si;
+    ++items_version;
+
+    if (!filter.empty())
     {
-        *it = si;
+        return update_filter(filter);
     }
-    list_->set_item_count(static_cast<int32_t>(items_.size()));
+    list_->update_items(n, 1);
 }
 
 void select::swap_items(int64_t first_item_id, int64_t second_item_id)
 {
-    auto first_it = std::find(items_.begin(), items_.end(), first_item_id);
-    if (first_it != items_.end())
+    auto first_it = ids.find(first_item_id), second_it = ids.find(second_item_id);
+    if (first_it == ids.end() || second_it == ids.end())
     {
-        auto second_it = std::find(items_.begin(), items_.end(), second_item_id);
-        if (second_it != items_.end())
-        {
-            std::swap(*first_it, *second_it);
-        }
+        return;
     }
-    list_->set_item_count(static_cast<int32_t>(items_.size()));
+
+    auto &items__ = own_items();
+    std::swap(items__[first_it->second], items__[second_it->second]);
+    std::swap(first_it->second, second_it->second);
+    ++items_version;
+
+    if (!filter.empty())
+    {
+        return update_filter(filter);
+    }
+    list_->update_items(first_it->second, 1);
+    list_->update_items(second_it->second, 1);
 }
 
 void select::delete_item(int64_t id)
 {
-    auto it = std::find(items_.begin(), items_.end(), id);
-    if (it != items_.end())
+    auto it = ids.find(id);
+    if (it == ids.end())
+    {
+        return;
+    }
+
+    auto n = it->second;
+    auto &items__ = own_items();
+    items__.erase(items__.begin() + n);
+    ids.erase(it);
+    index_ids(n);
+    ++items_version;
+
+    if (!filter.empty())
     {
-        items_.erase(it);
+        return update_filter(filter);
     }
-    list_->set_item_count(static_cast<int32_t>(items_.size()));
+    list_->remove_items(n, 1);
 }
 
 void select::set_item_height(int32_t item_height__)
@@ -468,13 +574,10 @@ void select::select_item_number(int32_t index)
 
 void select::select_item_id(int64_t id)
 {
-    for (int32_t i = 0; i != static_cast<int32_t>(items_.size()); ++i)
+    auto it = ids.find(id);
+    if (it != ids.end())
     {
-        if (items_[i].id == id)
-        {
-            select_item_number(i);
-            break;
-        }
+        select_item_number(it->second);
     }
 }
 
@@ -485,9 +588,9 @@ select_item select::selected_item() const
     select_item result;
     result.id = -1;
 
-    if (item_number != -1 && item_number < static_cast<int32_t>(items_.size()))
+    if (filter.empty() && item_number != -1 && item_number < static_cast<int32_t>(items_->size()))
     {
-        result = items_[item_number];
+        result = (*items_)[item_number];
     }
 
     return result;
@@ -495,7 +598,7 @@ select_item select::selected_item() const
 
 const select_items_t &select::items() const
 {
-    return items_;
+    return *items_;
 }
 
 void select::set_change_callback(std::function<void(int32_t, int64_t)> change_callback_)
@@ -515,30 +618,29 @@ void select::redraw()
     }
 }
 
-void select::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect, list::item_state state)
+void select::draw_list_item(graphic &gr, int32_t n_row, const rect &item_rect, list::item_state state)
 {
-    if (static_cast<int32_t>(items_.size()) <= n_item)
+    auto n_item = item_number(n_row);
+    if (n_item < 0 || static_cast<int32_t>(items_->size()) <= n_item)
     {
         return;
     }
 
-    auto item = items_[n_item];
-    
-    auto border_width = theme_dimension(tcn, tv_border_width);
+    auto border_width = theme_dimension(tcn_keys[tk_border_width]);
 
     if (state == wui::list::item_state::active)
     {
-        gr.draw_rect(item_rect, wui::theme_color(tcn, tv_active_item));
+        gr.draw_rect(item_rect, wui::theme_color(tcn_keys[tk_active_item]));
     }
     else if (state == wui::list::item_state::selected)
     {
-        gr.draw_rect(item_rect, wui::theme_color(tcn, tv_selected_item));
+        gr.draw_rect(item_rect, wui::theme_color(tcn_keys[tk_selected_item]));
     }
 
-    auto text_color = theme_color(tcn, tv_text);
-    auto font = theme_font(tcn, tv_font);
+    auto text_color = theme_color(tcn_keys[tk_text]);
+    auto font = theme_font(tcn_keys[tk_font]);
 
-    auto text = items_[n_item].text;
+    auto text = (*items_)[n_item].text;
 
     auto text_size = gr.measure_text(text, font);
 
@@ -548,17 +650,233 @@ void select::draw_list_item(graphic &gr, int32_t n_item, const rect &item_rect,
     gr.draw_text({ item_rect.left + select_horizontal_indent, item_rect.top + (item_rect.height() - text_height) / 2 }, text, text_color, font);
 }
 
-void select::activate_list_item(int32_t n_item)
+void select::activate_list_item(int32_t n_row)
 {
     list_->hide();
+
+    if (!filter.empty())
+    {
+        auto n_item = item_number(n_row);
+
+        update_filter("");
+        if (n_item != -1)
+        {
+            list_->select_item(n_item);
+        }
+    }
+
     redraw();
 }
 
-void select::change_list_item(int32_t n_item)
+void select::change_list_item(int32_t n_row)
 {
+    if (quiet_selection)
+    {
+        return;
+    }
+
+    auto n_item = item_number(n_row);
+
     if (change_callback)
     {
-        change_callback(n_item, n_item < static_cast<int32_t>(items_.size()) ? items_[n_item].id : -1);
+        change_callback(n_item, n_item >= 0 && n_item < static_cast<int32_t>(items_->size()) ? (*items_)[n_item].id : -1);
+    }
+}
+
+/// The search thread can hold the items, then they are copied before the change
+select_items_t &select::own_items()
+{
+    if (items_.use_count() > 1)
+    {
+        items_ = std::make_shared<select_items_t>(*items_);
+    }
+    return *items_;
+}
+
+void select::items_changed()
+{
+    ++items_version;
+
+    ids.clear();
+    ids.reserve(items_->size());
+    index_ids(0);
+
+    if (!filter.empty())
+    {
+        return update_filter(filter);
+    }
+    list_->set_item_count(static_cast<int32_t>(items_->size()));
+}
+
+void select::index_ids(int32_t from)
+{
+    for (auto i = from; i < static_cast<int32_t>(items_->size()); ++i)
+    {
+        ids[(*items_)[i].id] = i;
+    }
+}
+
+int32_t select::row_count() const
+{
+    return static_cast<int32_t>(filter.empty() ? items_->size() : shown.size());
+}
+
+int32_t select::item_number(int32_t n_row) const
+{
+    if (filter.empty())
+    {
+        return n_row;
+    }
+    return n_row >= 0 && n_row < static_cast<int32_t>(shown.size()) ? shown[n_row] : -1;
+}
+
+void select::update_filter(const std::string &filter_)
+{
+    if (filter.empty() && !filter_.empty())
+    {
+        filter_selected = list_->selected_item();
+    }
+
+    filter = filter_;
+    ++search_generation;
+
+    if (filter.empty())
+    {
+        shown.clear();
+        list_->set_item_count(static_cast<int32_t>(items_->size()));
+
+        quiet_selection = true;
+        list_->select_item(filter_selected);
+        quiet_selection = false;
+
+        return redraw();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(search_mutex);
+
+        search_items = items_;
+        search_query = filter;
+        search_items_version = items_version;
+        search_pending = true;
+
+        if (!search_worker.joinable())
+        {
+            search_worker = std::thread(&select::search_work, this);
+        }
+    }
+    search_cv.notify_one();
+
+    redraw();
+}
+
+/// Called on the UI thread, the first chunk replaces the rows of the previous filter
+void select::filtered(uint64_t generation, const std::vector<int32_t> &numbers, bool first)
+{
+    if (generation != search_generation)
+    {
+        return;
+    }
+
+    if (first)
+    {
+        shown = numbers;
+        list_->set_item_count(static_cast<int32_t>(shown.size()));
+
+        quiet_selection = true;
+        list_->select_item(shown.empty() ? -1 : 0);
+        quiet_selection = false;
+    }
+    else
+    {
+        auto from = static_cast<int32_t>(shown.size());
+        shown.insert(shown.end(), numbers.begin(), numbers.end());
+        list_->insert_items(from, static_cast<int32_t>(numbers.size()));
+    }
+}
+
+void select::search_work()
+{
+    while (true)
+    {
+        std::shared_ptr<const select_items_t> items__;
+        std::string query;
+        uint64_t generation = 0, version = 0;
+        {
+            std::unique_lock<std::mutex> lock(search_mutex);
+            search_cv.wait(lock, [this] { return search_stopping || search_pending; });
+
+            if (search_stopping)
+            {
+                return;
+            }
+
+            items__ = std::move(search_items);
+            query = search_query;
+            version = search_items_version;
+            generation = search_generation;
+            search_pending = false;
+        }
+
+        /// The index is built once for the items and dropped if the filter changes meanwhile
+        if (version != indexed_version)
+        {
+            indexed_version = 0;
+            search_index.clear();
+
+            bool cancelled = false;
+            for (size_t i = 0; i != items__->size(); ++i)
+            {
+                if (i % 4096 == 0 && search_generation != generation)
+                {
+                    cancelled = true;
+                    break;
+                }
+                search_index.add((*items__)[i].text);
+            }
+
+            if (cancelled)
+            {
+                continue;
+            }
+            indexed_version = version;
+        }
+        items__.reset();
+
+        auto owner = alive;
+        auto chunk = std::make_shared<std::vector<int32_t>>();
+        bool first = true;
+
+        auto send = [&owner, &chunk, &first, generation]() {
+            auto first_ = first;
+            framework::post([owner, chunk, first_, generation]() {
+                if (*owner)
+                {
+                    (*owner)->filtered(generation, *chunk, first_);
+                }
+            });
+            chunk = std::make_shared<std::vector<int32_t>>();
+            first = false;
+        };
+
+        search_index.search(query, [this, &chunk, &send, generation](int32_t n) {
+            if (search_generation != generation)
+            {
+                return false;
+            }
+
+            chunk->emplace_back(n);
+            if (chunk->size() == search_chunk_size)
+            {
+                send();
+            }
+            return true;
+        });
+
+        if (search_generation == generation && (first || !chunk->empty()))
+        {
+            send();
+        }
     }
 }
 
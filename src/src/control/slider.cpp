@@ -18,6 +18,7 @@ slider::slider(int32_t from_, int32_t to_, int32_t value_, std::function<void(in
     from(from_), to(to_), value(value_),
     change_callback(change_callback_),
     tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -47,9 +48,9 @@ void slider::draw(graphic &gr, const rect &)
 
     auto control_pos = position();
 
-    auto slider_width = theme_dimension(tcn, tv_slider_width, theme_);
-    auto slider_height = theme_dimension(tcn, tv_slider_height, theme_);
-    auto slider_round = theme_dimension(tcn, tv_slider_round, theme_);
+    auto slider_width = theme_dimension(tcn_keys[tk_slider_width], theme_);
+    auto slider_height = theme_dimension(tcn_keys[tk_slider_height], theme_);
+    auto slider_round = theme_dimension(tcn_keys[tk_slider_round], theme_);
 
     double total = (orientation == slider_orientation::horizontal ? control_pos.width() : control_pos.height()) - static_cast<double>(slider_width) / 2;
     double slider_pos = (total * static_cast<double>(value)) / static_cast<double>(to - from);
@@ -59,8 +60,8 @@ void slider::draw(graphic &gr, const rect &)
         slider_pos = static_cast<double>(slider_width) / 2;
     }
 
-    auto perform_color = theme_color(tcn, tv_perform, theme_);
-    auto remain_color = theme_color(tcn, active || focused_ ? tv_active : tv_remain, theme_);
+    auto perform_color = theme_color(tcn_keys[tk_perform], theme_);
+    auto remain_color = theme_color(tcn_keys[active || focused_ ? tk_active : tk_remain], theme_);
 
     auto slider_color = active || focused_ ? remain_color : perform_color;
 
@@ -311,6 +312,7 @@ error slider::get_error() const
 void slider::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -14,6 +14,7 @@ namespace wui
     callback(callback_),
     margin_min(-1), margin_max(-1),
     tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -38,7 +39,7 @@ void splitter::draw(graphic &gr, const rect &)
         return;
     }
     
-    gr.draw_rect(position(), theme_color(tcn, active ? tv_active : tv_calm, theme_));
+    gr.draw_rect(position(), theme_color(tcn_keys[active ? tk_active : tk_calm], theme_));
 }
 
 void splitter::receive_control_events(const event &ev)
@@ -206,6 +207,7 @@ error splitter::get_error() const
 void splitter::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
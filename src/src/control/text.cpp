@@ -18,6 +18,7 @@ text::text(std::string_view text__,
     std::string_view theme_control_name,
     std::shared_ptr<i_theme> theme_)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme_),
     position_(),
     parent_(),
@@ -45,7 +46,7 @@ void text::draw(graphic &gr, const rect &)
 
     const auto space_coeff = 1.2;
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
 
     std::stringstream text__(text_);
     std::string line;
@@ -76,30 +77,34 @@ void text::draw(graphic &gr, const rect &)
 
     for (auto &line : lines)
     {
-        truncate_line(line, gr, font_, control_pos.width());
+        /// The lines out of the clip are not measured and drawn
+        if (!gr.clipped({ control_pos.left, line_top, control_pos.right, line_top + line_height }))
+        {
+            truncate_line(line, gr, font_, control_pos.width());
 
-        int32_t left = control_pos.left;
+            int32_t left = control_pos.left;
 
-        switch (hori_alignment_)
-        {
-            case hori_alignment::left:
-                // do nothing
-            break;
-            case hori_alignment::center:
-            {
-                auto line_width = gr.measure_text(line, font_).width();
-                left += ((control_pos.width() - line_width) / 2);
-            }
-            break;
-            case hori_alignment::right:
+            switch (hori_alignment_)
             {
-                auto line_width = gr.measure_text(line, font_).width();
-                left += (control_pos.width() - line_width);
+                case hori_alignment::left:
+                    // do nothing
+                break;
+                case hori_alignment::center:
+                {
+                    auto line_width = gr.measure_text(line, font_).width();
+                    left += ((control_pos.width() - line_width) / 2);
+                }
+                break;
+                case hori_alignment::right:
+                {
+                    auto line_width = gr.measure_text(line, font_).width();
+                    left += (control_pos.width() - line_width);
+                }
+                break;
             }
-            break;
+
+            gr.draw_text({ left, line_top }, line, theme_color(tcn_keys[tk_color], theme_), font_);
         }
-        
-        gr.draw_text({ left, line_top }, line, theme_color(tcn, tv_color, theme_), font_);
 
         line_top += static_cast<int32_t>(line_height * space_coeff);
 
@@ -163,6 +168,7 @@ error text::get_error() const
 void text::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -11,6 +11,7 @@ namespace wui
 
 tooltip::tooltip(std::string_view text_, std::string_view theme_control_name, std::shared_ptr<i_theme> theme__)
     : tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme__),
     position_(),
     parent_(),
@@ -38,19 +39,19 @@ void tooltip::draw(graphic &gr, const rect &)
     auto control_position = position();
 
     gr.draw_rect(control_position,
-        theme_color(tcn, tv_border, theme_),
-        theme_color(tcn, tv_background, theme_),
-        theme_dimension(tcn, tv_border_width, theme_),
-        theme_dimension(tcn, tv_round, theme_));
+        theme_color(tcn_keys[tk_border], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_));
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
 
-    auto text_indent = theme_dimension(tcn, tv_text_indent, theme_);
+    auto text_indent = theme_dimension(tcn_keys[tk_text_indent], theme_);
 
     auto text_position = control_position;
     text_position.move(text_indent, text_indent);
 
-    gr.draw_text(text_position, text, theme_color(tcn, tv_text, theme_), font_);
+    gr.draw_text(text_position, text, theme_color(tcn_keys[tk_text], theme_), font_);
 }
 
 void tooltip::set_position(const rect &position__, bool redraw)
@@ -105,6 +106,7 @@ error tooltip::get_error() const
 void tooltip::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -192,14 +194,14 @@ void tooltip::update_size()
     graphic mem_gr(ctx);
     mem_gr.init({ 0, 0, 1024, 500 }, 0);
 
-    auto font_ = theme_font(tcn, tv_font, theme_);
+    auto font_ = theme_font(tcn_keys[tk_font], theme_);
 
     auto old_position = position_;
 
     auto height = mem_gr.measure_text("`Qj,", font_).bottom;
     auto position__ = mem_gr.measure_text(text, font_);
 
-    auto text_indent = theme_dimension(tcn, tv_text_indent, theme_);
+    auto text_indent = theme_dimension(tcn_keys[tk_text_indent], theme_);
     position__.right += text_indent * 2;
     position__.bottom = height + (text_indent * 2);
 
@@ -4,6 +4,9 @@
 
 #include <wui/framework/i_framework.hpp>
 
+#include <wui/framework/timer_scheduler.hpp>
+#include <wui/framework/task_queue.hpp>
+
 #ifdef _WIN32
 #include <windows.h>
 #include <gdiplus.h>
@@ -20,6 +23,19 @@ namespace framework
 
 static std::shared_ptr<i_framework> instance = nullptr;
 
+/// Never destroyed, because the timers of the static objects can be stopped after the statics destruction
+static timer_scheduler &scheduler()
+{
+    static auto scheduler_ = new timer_scheduler();
+    return *scheduler_;
+}
+
+static task_queue &tasks()
+{
+    static auto tasks_ = new task_queue();
+    return *tasks_;
+}
+
 /// Interface
 
 void init()
@@ -35,9 +51,10 @@ void run()
     {
         return;
     }
-    instance = std::make_shared<framework_win_impl>();
+    instance = std::make_shared<framework_win_impl>(tasks(), scheduler());
 
-    instance->run();
+    auto instance_ = instance; /// stop() resets the instance while the message loop is running
+    instance_->run();
 }
 
 void stop()
@@ -54,6 +71,26 @@ bool runned()
     return instance != nullptr;
 }
 
+void post(std::function<void(void)> task)
+{
+    tasks().push(task);
+}
+
+void post(std::vector<std::function<void(void)>> tasks_)
+{
+    tasks().push(tasks_);
+}
+
+uint64_t start_timer(uint32_t interval, std::function<void(void)> callback)
+{
+    return scheduler().start(interval, callback);
+}
+
+void stop_timer(uint64_t timer_id)
+{
+    scheduler().stop(timer_id);
+}
+
 error get_error()
 {
     if (instance)
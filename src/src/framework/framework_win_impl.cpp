@@ -10,12 +10,32 @@ namespace wui
 namespace framework
 {
 
-framework_win_impl::framework_win_impl()
+static const UINT wm_run_tasks = WM_APP + 1;
+
+framework_win_impl::framework_win_impl(task_queue &tasks_, timer_scheduler &scheduler_)
     : runned_(false),
+    tasks(tasks_),
+    scheduler(scheduler_),
+    message_wnd(0),
     err{}
 {
 }
 
+LRESULT CALLBACK framework_win_impl::message_proc(HWND hwnd, UINT message, WPARAM w_param, LPARAM l_param)
+{
+    if (message == wm_run_tasks)
+    {
+        auto impl = reinterpret_cast<framework_win_impl*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+        if (impl)
+        {
+            impl->tasks.run();
+        }
+        return 0;
+    }
+
+    return DefWindowProc(hwnd, message, w_param, l_param);
+}
+
 void framework_win_impl::run()
 {
     if (runned_)
@@ -27,12 +47,48 @@ void framework_win_impl::run()
     }
     runned_ = true;
 
+    WNDCLASSEXW wcex = { 0 };
+    wcex.cbSize = sizeof(WNDCLASSEXW);
+    wcex.lpfnWndProc = framework_win_impl::message_proc;
+    wcex.hInstance = GetModuleHandle(NULL);
+    wcex.lpszClassName = L"WUI Framework";
+    RegisterClassExW(&wcex);
+
+    message_wnd = CreateWindowExW(0, L"WUI Framework", L"", 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, GetModuleHandle(NULL), NULL);
+    if (message_wnd)
+    {
+        SetWindowLongPtr(message_wnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+        auto wnd = message_wnd;
+        tasks.set_waker([wnd]() { PostMessage(wnd, wm_run_tasks, 0, 0); });
+
+        /// The fired timers come to the UI thread as the posted tasks
+        auto &scheduler_ = scheduler;
+        auto &tasks_ = tasks;
+        scheduler.set_waker([&scheduler_, &tasks_]() { tasks_.push([&scheduler_]() { scheduler_.run_fired(); }); });
+    }
+    else
+    {
+        err.type = error_type::system_error;
+        err.component = "framework_win_impl::run()";
+        err.message = "CreateWindowEx returns null, the posted tasks will wait and the timers will be called on the scheduler thread";
+    }
+
     MSG msg;
     while (GetMessage(&msg, nullptr, 0, 0))
     {
         TranslateMessage(&msg);
         DispatchMessage(&msg);
     }
+
+    scheduler.set_waker(nullptr);
+    tasks.set_waker(nullptr);
+
+    if (message_wnd)
+    {
+        DestroyWindow(message_wnd);
+        message_wnd = 0;
+    }
 }
 
 void framework_win_impl::stop()
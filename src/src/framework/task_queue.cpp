@@ -0,0 +1,118 @@
+#include <wui/framework/task_queue.hpp>
+
+namespace wui
+{
+
+namespace framework
+{
+
+task_queue::task_queue()
+    : head(nullptr),
+    wake_pending(false),
+    waker_mutex(),
+    waker()
+{
+}
+
+task_queue::~task_queue()
+{
+    auto n = head.exchange(nullptr);
+    while (n)
+    {
+        auto next = n->next;
+        delete n;
+        n = next;
+    }
+}
+
+void task_queue::push(std::function<void(void)> task)
+{
+    auto n = new node{ std::move(task), nullptr };
+    push_chain(n, n);
+}
+
+void task_queue::push(std::vector<std::function<void(void)>> tasks)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    /// The stack is reversed by the consumer, so the chain is linked from the last task
+    node *first = nullptr, *last = nullptr;
+    for (auto &task : tasks)
+    {
+        first = new node{ std::move(task), first };
+        if (!last)
+        {
+            last = first;
+        }
+    }
+
+    push_chain(first, last);
+}
+
+void task_queue::push_chain(node *first, node *last)
+{
+    last->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed));
+
+    if (!wake_pending.exchange(true, std::memory_order_acq_rel))
+    {
+        std::lock_guard<std::mutex> lock(waker_mutex);
+        if (waker)
+        {
+            waker();
+        }
+    }
+}
+
+size_t task_queue::run()
+{
+    /// Reset before taking the tasks, so a push after the exchange wakes the consumer again
+    wake_pending.store(false, std::memory_order_release);
+
+    auto n = head.exchange(nullptr, std::memory_order_acquire);
+
+    node *reversed = nullptr;
+    while (n)
+    {
+        auto next = n->next;
+        n->next = reversed;
+        reversed = n;
+        n = next;
+    }
+
+    size_t count = 0;
+    while (reversed)
+    {
+        auto next = reversed->next;
+        if (reversed->task)
+        {
+            reversed->task();
+        }
+        delete reversed;
+        reversed = next;
+        ++count;
+    }
+
+    return count;
+}
+
+void task_queue::set_waker(std::function<void(void)> waker_)
+{
+    {
+        std::lock_guard<std::mutex> lock(waker_mutex);
+        waker = waker_;
+    }
+
+    /// The tasks pushed while there was no waker
+    if (waker_ && wake_pending.load(std::memory_order_acquire))
+    {
+        waker_();
+    }
+}
+
+}
+
+}
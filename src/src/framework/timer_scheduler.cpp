@@ -0,0 +1,201 @@
+#include <wui/framework/timer_scheduler.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+namespace framework
+{
+
+timer_scheduler::timer_scheduler()
+    : mutex_(),
+    cv(), running_cv(),
+    entries(),
+    deadlines(),
+    fired(),
+    waker(),
+    wake_pending(false),
+    next_id(0), running_id(0),
+    running_thread(),
+    stopping(false),
+    thread()
+{
+}
+
+timer_scheduler::~timer_scheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping = true;
+    }
+    cv.notify_one();
+
+    if (thread.joinable()) thread.join();
+}
+
+uint64_t timer_scheduler::start(uint32_t interval, std::function<void(void)> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto timer_id = ++next_id;
+
+    auto interval_ = std::chrono::milliseconds(interval > 0 ? interval : 1);
+    auto deadline = clock::now() + interval_;
+
+    entries[timer_id] = entry{ std::make_shared<std::function<void(void)>>(callback), interval_, deadline, false };
+    deadlines.emplace(deadline, timer_id);
+
+    if (!thread.joinable())
+    {
+        thread = std::thread(&timer_scheduler::run, this);
+    }
+    else if (deadlines.begin()->second == timer_id)
+    {
+        cv.notify_one();
+    }
+
+    return timer_id;
+}
+
+void timer_scheduler::stop(uint64_t timer_id)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = entries.find(timer_id);
+    if (it == entries.end())
+    {
+        return;
+    }
+
+    deadlines.erase({ it->second.deadline, timer_id });
+    entries.erase(it);
+
+    while (running_id == timer_id && running_thread != std::this_thread::get_id())
+    {
+        running_cv.wait(lock);
+    }
+}
+
+void timer_scheduler::set_waker(std::function<void(void)> waker_)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    waker = waker_;
+    wake_pending = false;
+
+    if (!waker)
+    {
+        for (auto timer_id : fired)
+        {
+            auto it = entries.find(timer_id);
+            if (it != entries.end())
+            {
+                it->second.fired = false;
+            }
+        }
+        fired.clear();
+    }
+}
+
+void timer_scheduler::run_fired()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    wake_pending = false;
+
+    std::vector<uint64_t> fired_;
+    fired_.swap(fired);
+
+    for (auto timer_id : fired_)
+    {
+        auto it = entries.find(timer_id);
+        if (it != entries.end())
+        {
+            it->second.fired = false;
+            call(timer_id, lock);
+        }
+    }
+}
+
+void timer_scheduler::call(uint64_t timer_id, std::unique_lock<std::mutex> &lock)
+{
+    auto callback = entries[timer_id].callback;
+
+    running_id = timer_id;
+    running_thread = std::this_thread::get_id();
+
+    lock.unlock();
+    if (callback && *callback)
+    {
+        (*callback)();
+    }
+    lock.lock();
+
+    running_id = 0;
+    running_thread = std::thread::id();
+
+    running_cv.notify_all();
+}
+
+void timer_scheduler::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping)
+    {
+        if (deadlines.empty())
+        {
+            cv.wait(lock);
+            continue;
+        }
+
+        auto nearest = *deadlines.begin();
+        auto now = clock::now();
+        if (nearest.first > now)
+        {
+            cv.wait_until(lock, nearest.first);
+            continue;
+        }
+
+        auto timer_id = nearest.second;
+        deadlines.erase(deadlines.begin());
+
+        auto &entry_ = entries[timer_id];
+
+        /// Keeps the phase, but after a stall the missed ticks are skipped, so a late timer fires once
+        entry_.deadline += entry_.interval;
+        if (entry_.deadline <= now)
+        {
+            entry_.deadline = now + entry_.interval;
+        }
+        deadlines.emplace(entry_.deadline, timer_id);
+
+        if (waker)
+        {
+            if (!entry_.fired)
+            {
+                entry_.fired = true;
+                fired.emplace_back(timer_id);
+            }
+
+            if (!wake_pending)
+            {
+                wake_pending = true;
+
+                auto waker_ = waker;
+                lock.unlock();
+                waker_();
+                lock.lock();
+            }
+        }
+        else
+        {
+            call(timer_id, lock);
+        }
+    }
+}
+
+}
+
+}
@@ -1,18 +1,36 @@
 
 #include <wui/graphic/graphic.hpp>
+#include <wui/graphic/surface_pool.hpp>
+#include <wui/graphic/text_measure_cache.hpp>
+#include <wui/graphic/image_cache.hpp>
 #include <wui/common/flag_helpers.hpp>
 #include <wui/system/tools.hpp>
 
+#ifdef _WIN32
 #include <boost/nowide/convert.hpp>
+#elif __linux__
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#endif
 
 namespace wui
 {
 
+/// The measurements don't depend on the surface, so all the graphics share them
+static text_measure_cache measure_cache;
+
+#ifdef _WIN32
+
 graphic::graphic(system_context &context__)
     : context_(context__),
-      pc(context_),
+      pc(std::make_shared<primitive_container>(context_)),
+      shared_primitives(false),
+      pool(),
       max_size(),
-      background_color(0)
+      background_color(0),
+      clips()
     , mem_dc(0),
       mem_bitmap(0),
 
@@ -20,6 +38,25 @@ graphic::graphic(system_context &context__)
 {
 }
 
+graphic::graphic(system_context &context__, std::shared_ptr<primitive_container> pc_)
+    : context_(context__),
+      pc(pc_),
+      shared_primitives(true),
+      pool(),
+      max_size(),
+      background_color(0),
+      clips(),
+      mem_dc(0),
+      mem_bitmap(0),
+      err{}
+{
+}
+
+std::unique_ptr<graphic> graphic::make_compatible()
+{
+    return std::unique_ptr<graphic>(new graphic(context_, pc));
+}
+
 graphic::~graphic()
 {
     release();
@@ -60,24 +97,31 @@ bool graphic::init(const rect &max_size_, color background_color_)
     SetMapMode(mem_dc, MM_TEXT);
 
     RECT filling_rect = { 0, 0, max_size.width(), max_size.height() };
-    FillRect(mem_dc, &filling_rect, pc.get_brush(background_color));
+    FillRect(mem_dc, &filling_rect, pc->get_brush(background_color));
 
     ReleaseDC(context_.hwnd, wnd_dc);
 
-    pc.init();
+    pc->init();
 
     return true;
 }
 
 void graphic::release()
 {
+    pool.reset();
+
+    clips.clear();
+
     DeleteObject(mem_bitmap);
     mem_bitmap = 0;
 
     DeleteDC(mem_dc);
     mem_dc = 0;
 
-    pc.release();
+    if (!shared_primitives)
+    {
+        pc->release();
+    }
 }
 
 void graphic::set_background_color(color background_color_)
@@ -95,7 +139,7 @@ void graphic::clear(const rect &position)
     }
 
     RECT filling_rect = { position.left, position.top, position.right, position.bottom };
-    FillRect(mem_dc, &filling_rect, pc.get_brush(background_color));
+    FillRect(mem_dc, &filling_rect, pc->get_brush(background_color));
 }
 
 void graphic::flush(const rect &updated_size)
@@ -125,7 +169,7 @@ void graphic::draw_pixel(const rect &position, color color_)
 
 void graphic::draw_line(const rect &position, color color_, uint32_t width)
 {
-    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(PS_SOLID, width, color_));
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc->get_pen(PS_SOLID, width, color_));
 
     MoveToEx(mem_dc, position.left, position.top, (LPPOINT)NULL);
     LineTo(mem_dc, position.right, position.bottom);
@@ -133,9 +177,30 @@ void graphic::draw_line(const rect &position, color color_, uint32_t width)
     SelectObject(mem_dc, old_pen);
 }
 
+void graphic::draw_polyline(const std::vector<point> &points, color color_, uint32_t width)
+{
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc->get_pen(PS_SOLID, width, color_));
+
+    static_assert(sizeof(point) == sizeof(POINT), "the points are passed to GDI without the copy");
+    Polyline(mem_dc, reinterpret_cast<const POINT*>(points.data()), static_cast<int32_t>(points.size()));
+
+    SelectObject(mem_dc, old_pen);
+}
+
 rect graphic::measure_text(std::string_view text_, const font &font__)
 {
-    auto old_font = (HFONT)SelectObject(mem_dc, pc.get_font(font__));
+    rect text_size;
+    if (measure_cache.find(text_, font__, text_size))
+    {
+        return text_size;
+    }
+
+    auto old_font = (HFONT)SelectObject(mem_dc, pc->get_font(font__));
 
     RECT text_rect = { 0 };
     auto wide_str = boost::nowide::widen(text_);
@@ -143,12 +208,25 @@ rect graphic::measure_text(std::string_view text_, const font &font__)
 
     SelectObject(mem_dc, old_font);
 
-    return {0, 0, text_rect.right, text_rect.bottom};
+    text_size = { 0, 0, text_rect.right, text_rect.bottom };
+
+    if (mem_dc)
+    {
+        measure_cache.put(text_, font__, text_size);
+    }
+
+    return text_size;
+}
+
+double graphic::measure_advance(std::string_view text_, const font &font__)
+{
+    /// GDI advances are whole pixels already
+    return measure_text(text_, font__).right;
 }
 
 void graphic::draw_text(const rect &position, std::string_view text_, color color_, const font &font__)
 {
-    auto old_font = (HFONT)SelectObject(mem_dc, pc.get_font(font__));
+    auto old_font = (HFONT)SelectObject(mem_dc, pc->get_font(font__));
     
     SetTextColor(mem_dc, color_);
     SetBkMode(mem_dc, TRANSPARENT);
@@ -162,14 +240,14 @@ void graphic::draw_text(const rect &position, std::string_view text_, color colo
 void graphic::draw_rect(const rect &position, color fill_color)
 {
     RECT position_rect = { position.left, position.top, position.right, position.bottom };
-    FillRect(mem_dc, &position_rect, pc.get_brush(fill_color));
+    FillRect(mem_dc, &position_rect, pc->get_brush(fill_color));
 }
 
 void graphic::draw_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t rnd)
 {
-    auto old_pen = (HPEN)SelectObject(mem_dc, pc.get_pen(border_width != 0 ? PS_SOLID : PS_NULL, border_width, border_color));
+    auto old_pen = (HPEN)SelectObject(mem_dc, pc->get_pen(border_width != 0 ? PS_SOLID : PS_NULL, border_width, border_color));
 
-    auto old_brush = (HBRUSH)SelectObject(mem_dc, pc.get_brush(fill_color));
+    auto old_brush = (HBRUSH)SelectObject(mem_dc, pc->get_brush(fill_color));
 
     RoundRect(mem_dc, position.left, position.top, position.right, position.bottom, rnd, rnd);
 
@@ -180,7 +258,7 @@ void graphic::draw_rect(const rect &position, color border_color, color fill_col
 
 void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift)
 {
-    auto source_bitmap = pc.get_bitmap(position.width(), position.height(), buffer, mem_dc);
+    auto source_bitmap = pc->get_bitmap(position.width(), position.height(), buffer, mem_dc);
     auto source_dc = CreateCompatibleDC(mem_dc);
     SelectObject(source_dc, source_bitmap);
 
@@ -213,6 +291,64 @@ void graphic::draw_graphic(const rect &position, graphic &graphic_, int32_t left
     }
 }
 
+void graphic::apply_clip()
+{
+    if (!mem_dc)
+    {
+        return;
+    }
+
+    if (clips.empty())
+    {
+        SelectClipRgn(mem_dc, NULL);
+        return;
+    }
+
+    auto &clip_ = clips.back();
+
+    auto region = CreateRectRgn(clip_.left, clip_.top, clip_.right, clip_.bottom);
+    SelectClipRgn(mem_dc, region); /// the dc keeps a copy of the region
+    DeleteObject(region);
+}
+
+void graphic::scroll(const rect &area, int32_t dy)
+{
+    if (!mem_dc || dy == 0)
+    {
+        return;
+    }
+
+    RECT scroll_rect = { area.left, area.top, area.right, area.bottom };
+    ScrollDC(mem_dc, 0, dy, &scroll_rect, &scroll_rect, NULL, NULL);
+}
+
+void graphic::draw_image(const rect &position, const cached_image &image_)
+{
+    if (!image_.bitmap())
+    {
+        return;
+    }
+
+    auto source_dc = CreateCompatibleDC(mem_dc);
+    auto old_bitmap = SelectObject(source_dc, image_.bitmap());
+
+    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+    GdiAlphaBlend(mem_dc,
+        position.left,
+        position.top,
+        position.width(),
+        position.height(),
+        source_dc,
+        0,
+        0,
+        image_.width(),
+        image_.height(),
+        blend);
+
+    SelectObject(source_dc, old_bitmap);
+    DeleteDC(source_dc);
+}
+
 HDC graphic::drawable()
 {
     return mem_dc;
@@ -223,4 +359,568 @@ error graphic::get_error() const
     return err;
 }
 
+#elif __linux__
+
+static void set_source_color(cairo_t *cr, color color_)
+{
+    cairo_set_source_rgb(cr,
+        static_cast<double>(color_ & 0xFF) / 255.0,
+        static_cast<double>((color_ >> 8) & 0xFF) / 255.0,
+        static_cast<double>((color_ >> 16) & 0xFF) / 255.0);
+}
+
+static void select_font(cairo_t *cr, const font &font_)
+{
+    cairo_select_font_face(cr,
+        font_.name.c_str(),
+        flag_is_set(font_.decorations_, decorations::italic) ? CAIRO_FONT_SLANT_ITALIC : CAIRO_FONT_SLANT_NORMAL,
+        flag_is_set(font_.decorations_, decorations::bold) ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cr, font_.size);
+}
+
+graphic::graphic(system_context &context__)
+    : context_(context__),
+    pool(),
+    max_size(),
+    background_color(0),
+    clips(),
+    surface(nullptr),
+    cr(nullptr),
+    gc(0),
+    err{}
+{
+}
+
+graphic::~graphic()
+{
+    release();
+}
+
+bool graphic::init(const rect &max_size_, color background_color_)
+{
+    max_size = max_size_;
+    background_color = background_color_;
+
+    if (surface)
+    {
+        err.type = error_type::already_runned;
+        err.component = "graphic::init()";
+        return false;
+    }
+
+    err.reset();
+
+    surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, max_size.width(), max_size.height());
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+    {
+        err.type = error_type::no_handle;
+        err.component = "graphic::init()";
+        err.message = "cairo_image_surface_create returns error: " + std::string(cairo_status_to_string(cairo_surface_status(surface)));
+
+        cairo_surface_destroy(surface);
+        surface = nullptr;
+
+        return false;
+    }
+
+    cr = cairo_create(surface);
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+
+    clear({ 0, 0, max_size.width(), max_size.height() });
+
+    if (context_.valid() && context_.wnd)
+    {
+        gc = xcb_generate_id(context_.connection);
+        xcb_create_gc(context_.connection, gc, context_.wnd, 0, nullptr);
+    }
+
+    return true;
+}
+
+std::unique_ptr<graphic> graphic::make_compatible()
+{
+    return std::unique_ptr<graphic>(new graphic(context_));
+}
+
+void graphic::release()
+{
+    pool.reset();
+
+    clips.clear();
+
+    if (gc && context_.connection)
+    {
+        xcb_free_gc(context_.connection, gc);
+    }
+    gc = 0;
+
+    if (cr)
+    {
+        cairo_destroy(cr);
+        cr = nullptr;
+    }
+
+    if (surface)
+    {
+        cairo_surface_destroy(surface);
+        surface = nullptr;
+    }
+}
+
+void graphic::set_background_color(color background_color_)
+{
+    background_color = background_color_;
+
+    clear({ 0, 0, max_size.width(), max_size.height() });
+}
+
+void graphic::clear(const rect &position)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    set_source_color(cr, background_color);
+    cairo_rectangle(cr, position.left, position.top, position.width(), position.height());
+    cairo_fill(cr);
+}
+
+void graphic::flush(const rect &updated_size)
+{
+    if (!surface || !gc || !context_.valid())
+    {
+        return;
+    }
+
+    cairo_surface_flush(surface);
+
+    auto top = std::max(updated_size.top, 0);
+    auto bottom = std::min(updated_size.bottom, max_size.height());
+    if (bottom <= top)
+    {
+        return;
+    }
+
+    auto data = cairo_image_surface_get_data(surface);
+    auto stride_ = cairo_image_surface_get_stride(surface);
+
+    /// Whole rows are sent in bands fitting in the maximum request length
+    int32_t max_request_bytes = static_cast<int32_t>(xcb_get_maximum_request_length(context_.connection)) * 4 - 64;
+    int32_t band_rows = std::max(max_request_bytes / stride_, 1);
+
+    for (auto row = top; row < bottom; row += band_rows)
+    {
+        auto rows = std::min(band_rows, bottom - row);
+
+        xcb_put_image(context_.connection,
+            XCB_IMAGE_FORMAT_Z_PIXMAP,
+            context_.wnd,
+            gc,
+            static_cast<uint16_t>(max_size.width()), static_cast<uint16_t>(rows),
+            0, static_cast<int16_t>(row),
+            0,
+            context_.screen->root_depth,
+            static_cast<uint32_t>(rows * stride_),
+            data + row * stride_);
+    }
+
+    xcb_flush(context_.connection);
+}
+
+void graphic::draw_pixel(const rect &position, color color_)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    set_source_color(cr, color_);
+    cairo_rectangle(cr, position.left, position.top, 1, 1);
+    cairo_fill(cr);
+}
+
+void graphic::draw_line(const rect &position, color color_, uint32_t width)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    /// Odd widths are shifted to the pixel centers to get the same crisp lines as GDI
+    double shift = width % 2 ? 0.5 : 0.0;
+
+    set_source_color(cr, color_);
+    cairo_set_line_width(cr, width);
+    cairo_move_to(cr, position.left + shift, position.top + shift);
+    cairo_line_to(cr, position.right + shift, position.bottom + shift);
+    cairo_stroke(cr);
+}
+
+void graphic::draw_polyline(const std::vector<point> &points, color color_, uint32_t width)
+{
+    if (!cr || points.size() < 2)
+    {
+        return;
+    }
+
+    double shift = width % 2 ? 0.5 : 0.0;
+
+    set_source_color(cr, color_);
+    cairo_set_line_width(cr, width);
+
+    cairo_move_to(cr, points.front().x + shift, points.front().y + shift);
+    for (auto p = points.begin() + 1; p != points.end(); ++p)
+    {
+        cairo_line_to(cr, p->x + shift, p->y + shift);
+    }
+    cairo_stroke(cr);
+}
+
+rect graphic::measure_text(std::string_view text_, const font &font__)
+{
+    if (!cr)
+    {
+        return { 0 };
+    }
+
+    rect text_size;
+    if (measure_cache.find(text_, font__, text_size))
+    {
+        return text_size;
+    }
+
+    select_font(cr, font__);
+
+    cairo_font_extents_t font_extents;
+    cairo_font_extents(cr, &font_extents);
+
+    cairo_text_extents_t text_extents;
+    cairo_text_extents(cr, std::string(text_).c_str(), &text_extents);
+
+    text_size = { 0, 0, static_cast<int32_t>(std::ceil(text_extents.x_advance)), static_cast<int32_t>(std::ceil(font_extents.height)) };
+
+    measure_cache.put(text_, font__, text_size);
+
+    return text_size;
+}
+
+double graphic::measure_advance(std::string_view text_, const font &font__)
+{
+    if (!cr)
+    {
+        return 0;
+    }
+
+    select_font(cr, font__);
+
+    cairo_text_extents_t text_extents;
+    cairo_text_extents(cr, std::string(text_).c_str(), &text_extents);
+
+    return text_extents.x_advance;
+}
+
+void graphic::draw_text(const rect &position, std::string_view text_, color color_, const font &font__)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    select_font(cr, font__);
+
+    cairo_font_extents_t font_extents;
+    cairo_font_extents(cr, &font_extents);
+
+    std::string text__(text_);
+
+    set_source_color(cr, color_);
+    cairo_move_to(cr, position.left, position.top + font_extents.ascent);
+    cairo_show_text(cr, text__.c_str());
+
+    if (flag_is_set(font__.decorations_, decorations::underline) || flag_is_set(font__.decorations_, decorations::strike_out))
+    {
+        cairo_text_extents_t text_extents;
+        cairo_text_extents(cr, text__.c_str(), &text_extents);
+
+        auto line_width = std::max(font__.size / 16, 1);
+
+        if (flag_is_set(font__.decorations_, decorations::underline))
+        {
+            auto y = position.top + static_cast<int32_t>(font_extents.ascent) + line_width;
+            draw_line({ position.left, y, position.left + static_cast<int32_t>(text_extents.x_advance), y }, color_, line_width);
+        }
+        if (flag_is_set(font__.decorations_, decorations::strike_out))
+        {
+            auto y = position.top + static_cast<int32_t>(font_extents.ascent * 2 / 3);
+            draw_line({ position.left, y, position.left + static_cast<int32_t>(text_extents.x_advance), y }, color_, line_width);
+        }
+    }
+}
+
+void graphic::draw_rect(const rect &position, color fill_color)
+{
+    if (!cr || get_alpha(fill_color) != 0)
+    {
+        return;
+    }
+
+    set_source_color(cr, fill_color);
+    cairo_rectangle(cr, position.left, position.top, position.width(), position.height());
+    cairo_fill(cr);
+}
+
+void graphic::draw_rect(const rect &position, color border_color, color fill_color, uint32_t border_width, uint32_t rnd)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    /// The same geometry as GDI's RoundRect(): rnd is the diameter of the corner ellipse, the pen is centered on the bounds
+    double inset = border_width / 2.0;
+    double left = position.left + inset, top = position.top + inset,
+        right = position.right - inset, bottom = position.bottom - inset;
+    double radius = std::min({ rnd / 2.0, (right - left) / 2.0, (bottom - top) / 2.0 });
+
+    cairo_new_path(cr);
+    if (radius > 0)
+    {
+        cairo_arc(cr, right - radius, top + radius, radius, -M_PI / 2, 0);
+        cairo_arc(cr, right - radius, bottom - radius, radius, 0, M_PI / 2);
+        cairo_arc(cr, left + radius, bottom - radius, radius, M_PI / 2, M_PI);
+        cairo_arc(cr, left + radius, top + radius, radius, M_PI, 3 * M_PI / 2);
+        cairo_close_path(cr);
+    }
+    else
+    {
+        cairo_rectangle(cr, left, top, right - left, bottom - top);
+    }
+
+    if (get_alpha(fill_color) == 0)
+    {
+        set_source_color(cr, fill_color);
+        cairo_fill_preserve(cr);
+    }
+
+    if (border_width != 0)
+    {
+        set_source_color(cr, border_color);
+        cairo_set_line_width(cr, border_width);
+        cairo_stroke_preserve(cr);
+    }
+
+    cairo_new_path(cr);
+}
+
+void graphic::draw_buffer(const rect &position, uint8_t *buffer, int32_t left_shift, int32_t top_shift)
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    /// RGB24 has the same 32 bpp BGRX layout as the GDI bitmap and ignores alpha just like SRCCOPY does
+    auto source_surface = cairo_image_surface_create_for_data(buffer,
+        CAIRO_FORMAT_RGB24,
+        position.width(),
+        position.height(),
+        cairo_format_stride_for_width(CAIRO_FORMAT_RGB24, position.width()));
+
+    cairo_save(cr);
+    cairo_rectangle(cr, position.left, position.top, position.width(), position.height());
+    cairo_clip(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, source_surface, position.left - left_shift, position.top - top_shift);
+    cairo_paint(cr);
+    cairo_restore(cr);
+
+    cairo_surface_destroy(source_surface);
+}
+
+void graphic::draw_graphic(const rect &position, graphic &graphic_, int32_t left_shift, int32_t top_shift)
+{
+    if (!cr || !graphic_.surface)
+    {
+        return;
+    }
+
+    cairo_surface_flush(graphic_.surface);
+
+    /// As in the BitBlt() version, position.right and position.bottom are the width and the height
+    cairo_save(cr);
+    cairo_rectangle(cr, position.left, position.top, position.right, position.bottom);
+    cairo_clip(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cr, graphic_.surface, position.left - left_shift, position.top - top_shift);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+void graphic::apply_clip()
+{
+    if (!cr)
+    {
+        return;
+    }
+
+    cairo_reset_clip(cr);
+
+    if (!clips.empty())
+    {
+        auto &clip_ = clips.back();
+
+        cairo_rectangle(cr, clip_.left, clip_.top, clip_.width(), clip_.height());
+        cairo_clip(cr);
+    }
+}
+
+void graphic::scroll(const rect &area, int32_t dy)
+{
+    if (!surface || dy == 0)
+    {
+        return;
+    }
+
+    auto left = std::max(area.left, 0), right = std::min(area.right, max_size.width());
+    auto top = std::max(area.top, 0), bottom = std::min(area.bottom, max_size.height());
+    if (right <= left || bottom - top <= std::abs(dy))
+    {
+        return;
+    }
+
+    cairo_surface_flush(surface);
+
+    auto data = cairo_image_surface_get_data(surface);
+    auto stride_ = cairo_image_surface_get_stride(surface);
+    auto row_bytes = static_cast<size_t>(right - left) * 4;
+
+    /// Rows are moved from the far side so the source is read before it is overwritten
+    if (dy > 0)
+    {
+        for (auto row = bottom - 1; row >= top + dy; --row)
+        {
+            memmove(data + row * stride_ + left * 4, data + (row - dy) * stride_ + left * 4, row_bytes);
+        }
+    }
+    else
+    {
+        for (auto row = top; row < bottom + dy; ++row)
+        {
+            memmove(data + row * stride_ + left * 4, data + (row - dy) * stride_ + left * 4, row_bytes);
+        }
+    }
+
+    cairo_surface_mark_dirty_rectangle(surface, left, top, right - left, bottom - top);
+}
+
+void graphic::draw_image(const rect &position, const cached_image &image_)
+{
+    if (!cr || !image_.surface() || image_.width() == 0 || image_.height() == 0)
+    {
+        return;
+    }
+
+    cairo_save(cr);
+    cairo_rectangle(cr, position.left, position.top, position.width(), position.height());
+    cairo_clip(cr);
+    cairo_translate(cr, position.left, position.top);
+    if (position.width() != image_.width() || position.height() != image_.height())
+    {
+        cairo_scale(cr, static_cast<double>(position.width()) / image_.width(), static_cast<double>(position.height()) / image_.height());
+    }
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    cairo_set_source_surface(cr, image_.surface(), 0, 0);
+    cairo_paint(cr);
+    cairo_restore(cr);
+}
+
+cairo_t *graphic::drawable()
+{
+    return cr;
+}
+
+const uint8_t *graphic::pixels()
+{
+    if (!surface)
+    {
+        return nullptr;
+    }
+
+    cairo_surface_flush(surface);
+
+    return cairo_image_surface_get_data(surface);
+}
+
+int32_t graphic::stride() const
+{
+    return surface ? cairo_image_surface_get_stride(surface) : 0;
+}
+
+error graphic::get_error() const
+{
+    return err;
+}
+
+#endif
+
+std::shared_ptr<graphic> graphic::offscreen(const rect &size, color background_color_)
+{
+    if (!pool)
+    {
+        pool = std::unique_ptr<surface_pool>(new surface_pool(*this));
+    }
+
+    return pool->get(size, background_color_);
+}
+
+void graphic::push_clip(const rect &position)
+{
+    clips.emplace_back(clip().intersection(position));
+
+    apply_clip();
+}
+
+void graphic::pop_clip()
+{
+    if (!clips.empty())
+    {
+        clips.pop_back();
+    }
+
+    apply_clip();
+}
+
+rect graphic::clip() const
+{
+    return !clips.empty() ? clips.back() : rect{ 0, 0, max_size.width(), max_size.height() };
+}
+
+bool graphic::clipped(const rect &position) const
+{
+    return !clip().in(position);
+}
+
+std::unique_ptr<graphic> graphic::make_offscreen(const rect &size, color background_color_)
+{
+    auto offscreen_ = make_compatible();
+    offscreen_->init(size, background_color_);
+    return offscreen_;
+}
+
+text_measure_statistics graphic::get_text_measure_statistics()
+{
+    return measure_cache.statistics();
+}
+
+void graphic::reset_text_measure_statistics()
+{
+    measure_cache.reset_statistics();
+}
+
+void graphic::set_text_measure_budget(size_t bytes)
+{
+    measure_cache.set_byte_budget(bytes);
+}
+
 }
@@ -0,0 +1,600 @@
+#include <wui/graphic/image_cache.hpp>
+
+#ifdef _WIN32
+#include <boost/nowide/convert.hpp>
+#include <objidl.h>
+#include <gdiplus.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace wui
+{
+
+static uint64_t hash_bytes(const uint8_t *data, size_t size)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i != size; ++i)
+    {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/// image_source
+
+std::string image_source::key() const
+{
+    switch (kind_)
+    {
+        case kind::file:
+            return "f:" + path;
+        case kind::resource:
+            return "r:" + path + ":" + std::to_string(resource_index);
+        case kind::data:
+            return "d:" + std::to_string(hash_bytes(data.data(), data.size())) + ":" + std::to_string(data.size());
+        default:
+            return "";
+    }
+}
+
+image_source image_source::from_file(std::string_view path_)
+{
+    image_source s;
+    s.kind_ = kind::file;
+    s.path = path_;
+    return s;
+}
+
+image_source image_source::from_resource(int32_t resource_index_, std::string_view resource_section)
+{
+    image_source s;
+    s.kind_ = kind::resource;
+    s.path = resource_section;
+    s.resource_index = resource_index_;
+    return s;
+}
+
+image_source image_source::from_data(const std::vector<uint8_t> &data_)
+{
+    image_source s;
+    s.kind_ = kind::data;
+    s.data = data_;
+    return s;
+}
+
+image_source image_source::from_data(const uint8_t *data_, size_t size)
+{
+    image_source s;
+    s.kind_ = kind::data;
+    s.data.assign(data_, data_ + size);
+    return s;
+}
+
+/// cached_image
+
+cached_image::cached_image()
+    : width_(0), height_(0), source_width_(0), source_height_(0),
+#ifdef _WIN32
+    bitmap_(0)
+#elif __linux__
+    surface_(nullptr)
+#endif
+{
+}
+
+cached_image::~cached_image()
+{
+#ifdef _WIN32
+    if (bitmap_)
+    {
+        DeleteObject(bitmap_);
+    }
+#elif __linux__
+    if (surface_)
+    {
+        cairo_surface_destroy(surface_);
+    }
+#endif
+}
+
+int32_t cached_image::width() const
+{
+    return width_;
+}
+
+int32_t cached_image::height() const
+{
+    return height_;
+}
+
+int32_t cached_image::source_width() const
+{
+    return source_width_;
+}
+
+int32_t cached_image::source_height() const
+{
+    return source_height_;
+}
+
+size_t cached_image::bytes() const
+{
+    return static_cast<size_t>(width_) * height_ * 4 + sizeof(cached_image);
+}
+
+#ifdef _WIN32
+HBITMAP cached_image::bitmap() const
+{
+    return bitmap_;
+}
+#elif __linux__
+cairo_surface_t *cached_image::surface() const
+{
+    return surface_;
+}
+#endif
+
+/// image_cache
+
+image_cache::image_cache(size_t byte_budget)
+    : mutex_(),
+    entries(),
+    index(),
+    statistics_{ 0, 0, 0, 0, 0, byte_budget },
+    jobs(),
+    in_flight(),
+    jobs_condition(),
+    workers(),
+    stopping(false)
+{
+}
+
+image_cache::~image_cache()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping = true;
+    }
+    jobs_condition.notify_all();
+
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+}
+
+std::string image_cache::make_key(const image_source &source, int32_t width, int32_t height)
+{
+    return source.key() + "@" + std::to_string(width) + "x" + std::to_string(height);
+}
+
+std::shared_ptr<cached_image> image_cache::get(const image_source &source, int32_t width, int32_t height)
+{
+    if (source.kind_ == image_source::kind::none)
+    {
+        return nullptr;
+    }
+
+    auto key = make_key(source, width, height);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            entries.splice(entries.begin(), entries, it->second);
+            ++statistics_.hits;
+            return it->second->image;
+        }
+        ++statistics_.misses;
+    }
+
+    return insert(key, decode(source, width, height));
+}
+
+std::shared_ptr<cached_image> image_cache::find(const image_source &source, int32_t width, int32_t height)
+{
+    if (source.kind_ == image_source::kind::none)
+    {
+        return nullptr;
+    }
+
+    auto key = make_key(source, width, height);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        ++statistics_.hits;
+        return it->second->image;
+    }
+
+    return nullptr;
+}
+
+void image_cache::get_async(const image_source &source, int32_t width, int32_t height, std::function<void(std::shared_ptr<cached_image>)> done)
+{
+    if (source.kind_ == image_source::kind::none)
+    {
+        if (done)
+        {
+            done(nullptr);
+        }
+        return;
+    }
+
+    auto key = make_key(source, width, height);
+
+    std::shared_ptr<cached_image> cached;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = index.find(key);
+        if (it != index.end())
+        {
+            entries.splice(entries.begin(), entries, it->second);
+            ++statistics_.hits;
+            cached = it->second->image;
+        }
+        else
+        {
+            auto flight = in_flight.find(key);
+            if (flight == in_flight.end())
+            {
+                ++statistics_.misses;
+
+                flight = in_flight.emplace(key, std::vector<std::function<void(std::shared_ptr<cached_image>)>>()).first;
+                jobs.emplace_back(job{ key, source, width, height });
+
+                if (workers.empty())
+                {
+                    auto count = std::max(1u, std::min(4u, std::thread::hardware_concurrency() / 2));
+                    for (auto i = 0u; i != count; ++i)
+                    {
+                        workers.emplace_back(&image_cache::work, this);
+                    }
+                }
+            }
+            if (done)
+            {
+                flight->second.emplace_back(done);
+            }
+        }
+    }
+
+    if (cached)
+    {
+        if (done)
+        {
+            done(cached);
+        }
+        return;
+    }
+
+    jobs_condition.notify_one();
+}
+
+void image_cache::prefetch(const std::vector<image_source> &sources)
+{
+    for (auto &s : sources)
+    {
+        get_async(s, 0, 0, nullptr);
+    }
+}
+
+void image_cache::work()
+{
+    while (true)
+    {
+        job j;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            jobs_condition.wait(lock, [this] { return stopping || !jobs.empty(); });
+
+            if (stopping)
+            {
+                return;
+            }
+
+            j = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        auto img = insert(j.key, decode(j.source, j.width, j.height));
+
+        std::vector<std::function<void(std::shared_ptr<cached_image>)>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            auto flight = in_flight.find(j.key);
+            if (flight != in_flight.end())
+            {
+                callbacks = std::move(flight->second);
+                in_flight.erase(flight);
+            }
+        }
+
+        for (auto &done : callbacks)
+        {
+            done(img);
+        }
+    }
+}
+
+/// Keeps the first image if other thread decoded the same one meanwhile, so the controls share it
+std::shared_ptr<cached_image> image_cache::insert(const std::string &key, std::shared_ptr<cached_image> img)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!img)
+    {
+        ++statistics_.decode_errors;
+        return nullptr;
+    }
+
+    auto it = index.find(key);
+    if (it != index.end())
+    {
+        return it->second->image;
+    }
+
+    entries.push_front(entry{ key, img });
+    index.emplace(key, entries.begin());
+    statistics_.used_bytes += img->bytes();
+
+    shrink();
+
+    return img;
+}
+
+void image_cache::set_byte_budget(size_t byte_budget)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    statistics_.byte_budget = byte_budget;
+    shrink();
+}
+
+void image_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    entries.clear();
+    index.clear();
+    statistics_.used_bytes = 0;
+}
+
+image_cache_statistics image_cache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+/// Must be called under the mutex. The images held by the controls stay, they will be freed with the last holder
+void image_cache::shrink()
+{
+    auto it = entries.end();
+    while (statistics_.used_bytes > statistics_.byte_budget && it != entries.begin())
+    {
+        --it;
+        if (it->image.use_count() == 1)
+        {
+            statistics_.used_bytes -= it->image->bytes();
+            ++statistics_.evictions;
+
+            index.erase(it->key);
+            it = entries.erase(it);
+        }
+    }
+}
+
+#ifdef _WIN32
+
+static Gdiplus::Image *load_from_data(const uint8_t *data, size_t size, IStream **stream)
+{
+    HGLOBAL h_buffer = ::GlobalAlloc(GMEM_MOVEABLE, size);
+    if (!h_buffer)
+    {
+        return nullptr;
+    }
+
+    void *p_buffer = ::GlobalLock(h_buffer);
+    if (!p_buffer)
+    {
+        ::GlobalFree(h_buffer);
+        return nullptr;
+    }
+    memcpy(p_buffer, data, size);
+    ::GlobalUnlock(h_buffer);
+
+    /// The stream owns the memory and must live while the image is used
+    if (::CreateStreamOnHGlobal(h_buffer, TRUE, stream) != S_OK)
+    {
+        ::GlobalFree(h_buffer);
+        return nullptr;
+    }
+
+    return Gdiplus::Image::FromStream(*stream);
+}
+
+static Gdiplus::Image *load_source(const image_source &source, IStream **stream)
+{
+    switch (source.kind_)
+    {
+        case image_source::kind::file:
+            return Gdiplus::Image::FromFile(boost::nowide::widen(source.path).c_str());
+        case image_source::kind::data:
+            return load_from_data(source.data.data(), source.data.size(), stream);
+        case image_source::kind::resource:
+        {
+            auto h_inst = GetModuleHandle(NULL);
+            auto h_resource = FindResource(h_inst, MAKEINTRESOURCE(source.resource_index), boost::nowide::widen(source.path).c_str());
+            if (!h_resource)
+            {
+                return nullptr;
+            }
+
+            auto resource_size = ::SizeofResource(h_inst, h_resource);
+            auto resource_data = ::LockResource(::LoadResource(h_inst, h_resource));
+            if (!resource_size || !resource_data)
+            {
+                return nullptr;
+            }
+
+            return load_from_data(static_cast<const uint8_t*>(resource_data), resource_size, stream);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+std::shared_ptr<cached_image> image_cache::decode(const image_source &source, int32_t width, int32_t height)
+{
+    IStream *stream = nullptr;
+    std::unique_ptr<Gdiplus::Image> src(load_source(source, &stream));
+
+    std::shared_ptr<cached_image> img;
+
+    if (src && src->GetLastStatus() == Gdiplus::Ok && src->GetWidth() != 0 && src->GetHeight() != 0)
+    {
+        img = std::shared_ptr<cached_image>(new cached_image());
+        img->source_width_ = static_cast<int32_t>(src->GetWidth());
+        img->source_height_ = static_cast<int32_t>(src->GetHeight());
+        img->width_ = width > 0 ? width : img->source_width_;
+        img->height_ = height > 0 ? height : img->source_height_;
+
+        /// Scale once with the good filter to the premultiplied format AlphaBlend() wants
+        Gdiplus::Bitmap target(img->width_, img->height_, PixelFormat32bppPARGB);
+        {
+            Gdiplus::Graphics gr(&target);
+            gr.Clear(Gdiplus::Color(0, 0, 0, 0));
+            gr.SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
+            gr.SetPixelOffsetMode(Gdiplus::PixelOffsetModeHalf);
+            gr.DrawImage(src.get(),
+                Gdiplus::Rect(0, 0, img->width_, img->height_),
+                0, 0, img->source_width_, img->source_height_,
+                Gdiplus::UnitPixel);
+        }
+
+        BITMAPINFO bi = {};
+        bi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        bi.bmiHeader.biWidth = img->width_;
+        bi.bmiHeader.biHeight = -img->height_;
+        bi.bmiHeader.biPlanes = 1;
+        bi.bmiHeader.biBitCount = 32;
+        bi.bmiHeader.biCompression = BI_RGB;
+
+        void *bits = nullptr;
+        img->bitmap_ = CreateDIBSection(NULL, &bi, DIB_RGB_COLORS, &bits, NULL, 0);
+
+        Gdiplus::BitmapData data = {};
+        Gdiplus::Rect lock_rect(0, 0, img->width_, img->height_);
+        if (img->bitmap_ && bits && target.LockBits(&lock_rect, Gdiplus::ImageLockModeRead, PixelFormat32bppPARGB, &data) == Gdiplus::Ok)
+        {
+            for (int32_t y = 0; y != img->height_; ++y)
+            {
+                memcpy(static_cast<uint8_t*>(bits) + static_cast<size_t>(y) * img->width_ * 4,
+                    static_cast<const uint8_t*>(data.Scan0) + static_cast<ptrdiff_t>(y) * data.Stride,
+                    static_cast<size_t>(img->width_) * 4);
+            }
+            target.UnlockBits(&data);
+        }
+        else
+        {
+            img.reset();
+        }
+    }
+
+    src.reset();
+    if (stream)
+    {
+        stream->Release();
+    }
+
+    return img;
+}
+
+#elif __linux__
+
+struct png_reader
+{
+    const uint8_t *data;
+    size_t size, pos;
+};
+
+static cairo_status_t read_png(void *closure, unsigned char *out, unsigned int length)
+{
+    auto r = static_cast<png_reader*>(closure);
+    if (r->pos + length > r->size)
+    {
+        return CAIRO_STATUS_READ_ERROR;
+    }
+    memcpy(out, r->data + r->pos, length);
+    r->pos += length;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/// Cairo decodes PNG only, the resources are Windows feature
+std::shared_ptr<cached_image> image_cache::decode(const image_source &source, int32_t width, int32_t height)
+{
+    cairo_surface_t *src = nullptr;
+
+    if (source.kind_ == image_source::kind::file)
+    {
+        src = cairo_image_surface_create_from_png(source.path.c_str());
+    }
+    else if (source.kind_ == image_source::kind::data)
+    {
+        png_reader reader = { source.data.data(), source.data.size(), 0 };
+        src = cairo_image_surface_create_from_png_stream(read_png, &reader);
+    }
+
+    if (!src)
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<cached_image> img;
+
+    if (cairo_surface_status(src) == CAIRO_STATUS_SUCCESS &&
+        cairo_image_surface_get_width(src) != 0 && cairo_image_surface_get_height(src) != 0)
+    {
+        img = std::shared_ptr<cached_image>(new cached_image());
+        img->source_width_ = cairo_image_surface_get_width(src);
+        img->source_height_ = cairo_image_surface_get_height(src);
+        img->width_ = width > 0 ? width : img->source_width_;
+        img->height_ = height > 0 ? height : img->source_height_;
+
+        img->surface_ = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, img->width_, img->height_);
+
+        auto cr = cairo_create(img->surface_);
+        cairo_scale(cr, static_cast<double>(img->width_) / img->source_width_, static_cast<double>(img->height_) / img->source_height_);
+        cairo_set_source_surface(cr, src, 0, 0);
+        cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_GOOD);
+        cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+
+        cairo_surface_flush(img->surface_);
+    }
+
+    cairo_surface_destroy(src);
+
+    return img;
+}
+
+#endif
+
+image_cache &get_image_cache()
+{
+    static auto instance = new image_cache(); /// Never destroyed, the static controls can release their images after the statics destruction
+    return *instance;
+}
+
+}
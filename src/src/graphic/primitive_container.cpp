@@ -1,3 +1,5 @@
+#ifdef _WIN32
+
 
 #include <wui/graphic/primitive_container.hpp>
 
@@ -154,3 +156,5 @@ wui::error primitive_container::get_error() const
 }
 
 }
+
+#endif
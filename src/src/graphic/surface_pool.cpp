@@ -0,0 +1,85 @@
+#include <wui/graphic/surface_pool.hpp>
+#include <wui/graphic/graphic.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static const int32_t size_class_step = 64;
+
+static int32_t size_class(int32_t size)
+{
+    return size > 0 ? ((size + size_class_step - 1) / size_class_step) * size_class_step : size_class_step;
+}
+
+surface_pool::surface_pool(graphic &owner_, size_t max_surfaces_)
+    : owner(owner_),
+    max_surfaces(max_surfaces_ > 0 ? max_surfaces_ : 1),
+    surfaces(),
+    use_counter(0)
+{
+}
+
+surface_pool::~surface_pool()
+{
+    release();
+}
+
+std::shared_ptr<graphic> surface_pool::get(const rect &size, color background_color)
+{
+    auto width_class = size_class(size.width()), height_class = size_class(size.height());
+
+    auto it = std::find_if(surfaces.begin(), surfaces.end(), [width_class, height_class](const std::shared_ptr<surface> &s) {
+        return !s->in_use && s->width_class == width_class && s->height_class == height_class;
+    });
+
+    std::shared_ptr<surface> surface_;
+    if (it != surfaces.end())
+    {
+        surface_ = *it;
+        surface_->graphic_->set_background_color(background_color);
+    }
+    else
+    {
+        drop_unused();
+
+        surface_ = std::shared_ptr<surface>(new surface{ owner.make_compatible(), width_class, height_class, false, 0 });
+        surfaces.emplace_back(surface_);
+        surface_->graphic_->init({ 0, 0, width_class, height_class }, background_color);
+    }
+
+    surface_->in_use = true;
+    surface_->last_use = ++use_counter;
+
+    return std::shared_ptr<graphic>(surface_->graphic_.get(), [surface_](graphic*) { surface_->in_use = false; });
+}
+
+void surface_pool::release()
+{
+    surfaces.clear();
+}
+
+void surface_pool::drop_unused()
+{
+    while (surfaces.size() >= max_surfaces)
+    {
+        auto lru = surfaces.end();
+        for (auto it = surfaces.begin(); it != surfaces.end(); ++it)
+        {
+            if (!(*it)->in_use && (lru == surfaces.end() || (*it)->last_use < (*lru)->last_use))
+            {
+                lru = it;
+            }
+        }
+
+        if (lru == surfaces.end())
+        {
+            return; /// all the surfaces are drawing now, the pool grows
+        }
+
+        surfaces.erase(lru);
+    }
+}
+
+}
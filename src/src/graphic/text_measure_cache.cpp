@@ -0,0 +1,154 @@
+#include <wui/graphic/text_measure_cache.hpp>
+
+#include <functional>
+
+namespace wui
+{
+
+/// The approximate memory taken by one entry besides the strings: the list node and the index node
+static const size_t entry_overhead = sizeof(void*) * 6 + sizeof(uint64_t) + sizeof(std::string) * 2 + sizeof(rect) + sizeof(int32_t) * 2;
+
+static uint64_t make_hash(std::string_view text, const font &font_)
+{
+    uint64_t hash = std::hash<std::string_view>()(text);
+
+    auto combine = [&hash](uint64_t value) { hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2); };
+
+    combine(std::hash<std::string>()(font_.name));
+    combine(static_cast<uint64_t>(font_.size));
+    combine(static_cast<uint64_t>(font_.decorations_));
+
+    return hash;
+}
+
+static size_t entry_size(std::string_view text, const font &font_)
+{
+    return entry_overhead + text.size() + font_.name.size();
+}
+
+text_measure_cache::text_measure_cache(size_t byte_budget_)
+    : mutex_(),
+    entries(),
+    index(),
+    statistics_{ 0, 0, 0, 0, byte_budget_ }
+{
+}
+
+text_measure_cache::entries_t::iterator text_measure_cache::lookup(uint64_t hash, std::string_view text, const font &font_)
+{
+    auto range = index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto &e = *it->second;
+        if (e.text == text && e.font_.size == font_.size && e.font_.decorations_ == font_.decorations_ && e.font_.name == font_.name)
+        {
+            return it->second;
+        }
+    }
+    return entries.end();
+}
+
+bool text_measure_cache::find(std::string_view text, const font &font_, rect &size)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = lookup(make_hash(text, font_), text, font_);
+    if (it == entries.end())
+    {
+        ++statistics_.misses;
+        return false;
+    }
+
+    ++statistics_.hits;
+
+    entries.splice(entries.begin(), entries, it);
+    size = it->size;
+
+    return true;
+}
+
+void text_measure_cache::put(std::string_view text, const font &font_, const rect &size)
+{
+    auto bytes = entry_size(text, font_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (bytes > statistics_.byte_budget)
+    {
+        return;
+    }
+
+    auto hash = make_hash(text, font_);
+
+    auto it = lookup(hash, text, font_);
+    if (it != entries.end())
+    {
+        it->size = size;
+        entries.splice(entries.begin(), entries, it);
+        return;
+    }
+
+    entries.push_front({ hash, std::string(text), font_, size });
+    index.emplace(hash, entries.begin());
+    statistics_.used_bytes += bytes;
+
+    shrink();
+}
+
+void text_measure_cache::set_byte_budget(size_t byte_budget)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    statistics_.byte_budget = byte_budget;
+    shrink();
+}
+
+void text_measure_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    index.clear();
+    entries.clear();
+    statistics_.used_bytes = 0;
+}
+
+text_measure_statistics text_measure_cache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return statistics_;
+}
+
+void text_measure_cache::reset_statistics()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    statistics_.hits = 0;
+    statistics_.misses = 0;
+    statistics_.evictions = 0;
+}
+
+void text_measure_cache::shrink()
+{
+    while (statistics_.used_bytes > statistics_.byte_budget && !entries.empty())
+    {
+        auto last = std::prev(entries.end());
+
+        auto range = index.equal_range(last->hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == last)
+            {
+                index.erase(it);
+                break;
+            }
+        }
+
+        statistics_.used_bytes -= entry_size(last->text, last->font_);
+        ++statistics_.evictions;
+
+        entries.erase(last);
+    }
+}
+
+}
@@ -0,0 +1,177 @@
+#include <wui/graphic/text_width_index.hpp>
+#include <wui/graphic/graphic.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace wui
+{
+
+static size_t codepoint_length(const std::string &text, size_t position)
+{
+    auto lead = static_cast<uint8_t>(text[position]);
+
+    size_t length = 1;
+    if ((lead >> 5) == 0x6)
+    {
+        length = 2;
+    }
+    else if ((lead >> 4) == 0xe)
+    {
+        length = 3;
+    }
+    else if ((lead >> 3) == 0x1e)
+    {
+        length = 4;
+    }
+
+    return std::min(length, text.size() - position);
+}
+
+static bool same_font(const font &a, const font &b)
+{
+    return a.size == b.size && a.decorations_ == b.decorations_ && a.name == b.name;
+}
+
+text_width_index::text_width_index()
+    : codepoint_ends(),
+    advances(),
+    prefix_widths(1, 0),
+    font_{},
+    valid(false),
+    dirty_from(0)
+{
+}
+
+void text_width_index::reset()
+{
+    valid = false;
+}
+
+bool text_width_index::boundary(size_t position, size_t &codepoint) const
+{
+    if (position == 0)
+    {
+        codepoint = 0;
+        return true;
+    }
+
+    auto it = std::lower_bound(codepoint_ends.begin(), codepoint_ends.end(), position);
+    if (it == codepoint_ends.end() || *it != position)
+    {
+        return false;
+    }
+
+    codepoint = (it - codepoint_ends.begin()) + 1;
+    return true;
+}
+
+void text_width_index::parse(const std::string &text, size_t begin, size_t end, std::vector<size_t> &ends) const
+{
+    while (begin < end)
+    {
+        begin += codepoint_length(text, begin);
+        ends.emplace_back(std::min(begin, end));
+    }
+}
+
+void text_width_index::insert(const std::string &text, size_t position, size_t length)
+{
+    size_t codepoint = 0;
+    if (!valid || length == 0 || !boundary(position, codepoint))
+    {
+        valid = valid && length == 0;
+        return;
+    }
+
+    std::vector<size_t> new_ends;
+    parse(text, position, position + length, new_ends);
+
+    for (auto it = codepoint_ends.begin() + codepoint; it != codepoint_ends.end(); ++it)
+    {
+        *it += length;
+    }
+
+    codepoint_ends.insert(codepoint_ends.begin() + codepoint, new_ends.begin(), new_ends.end());
+    advances.insert(advances.begin() + codepoint, new_ends.size(), -1);
+    prefix_widths.insert(prefix_widths.begin() + codepoint + 1, new_ends.size(), 0);
+
+    dirty_from = std::min(dirty_from, codepoint);
+}
+
+void text_width_index::erase(size_t position, size_t length)
+{
+    size_t first = 0, last = 0;
+    if (!valid || length == 0 || !boundary(position, first) || !boundary(position + length, last))
+    {
+        valid = valid && length == 0;
+        return;
+    }
+
+    codepoint_ends.erase(codepoint_ends.begin() + first, codepoint_ends.begin() + last);
+    advances.erase(advances.begin() + first, advances.begin() + last);
+    prefix_widths.erase(prefix_widths.begin() + first + 1, prefix_widths.begin() + last + 1);
+
+    for (auto it = codepoint_ends.begin() + first; it != codepoint_ends.end(); ++it)
+    {
+        *it -= length;
+    }
+
+    dirty_from = std::min(dirty_from, first);
+}
+
+void text_width_index::update(graphic &gr, const std::string &text, const font &font__)
+{
+    auto text_size = codepoint_ends.empty() ? 0 : codepoint_ends.back();
+
+    if (!valid || !same_font(font_, font__) || text_size != text.size())
+    {
+        font_ = font__;
+
+        codepoint_ends.clear();
+        parse(text, 0, text.size(), codepoint_ends);
+
+        advances.assign(codepoint_ends.size(), -1);
+        prefix_widths.assign(codepoint_ends.size() + 1, 0);
+
+        valid = true;
+        dirty_from = 0;
+    }
+
+    for (size_t i = dirty_from; i < advances.size(); ++i)
+    {
+        if (advances[i] < 0)
+        {
+            auto begin = i != 0 ? codepoint_ends[i - 1] : 0;
+            advances[i] = gr.measure_advance(std::string_view(text).substr(begin, codepoint_ends[i] - begin), font_);
+        }
+        prefix_widths[i + 1] = prefix_widths[i] + advances[i];
+    }
+
+    dirty_from = advances.size();
+}
+
+int32_t text_width_index::width(size_t byte_count) const
+{
+    auto codepoint = std::upper_bound(codepoint_ends.begin(), codepoint_ends.end(), byte_count) - codepoint_ends.begin();
+
+    return static_cast<int32_t>(std::lround(prefix_widths[codepoint]));
+}
+
+size_t text_width_index::position(int32_t x) const
+{
+    if (x <= 0 || codepoint_ends.empty())
+    {
+        return 0;
+    }
+
+    auto it = std::lower_bound(prefix_widths.begin() + 1, prefix_widths.end(), x - 0.5);
+    if (it == prefix_widths.end())
+    {
+        return codepoint_ends.back();
+    }
+
+    return codepoint_ends[(it - prefix_widths.begin()) - 1];
+}
+
+}
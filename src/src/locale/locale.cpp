@@ -39,6 +39,15 @@ bool set_locale_from_file(locale_type type, std::string_view name, std::string_v
     return instance->get_error().is_ok();
 }
 
+bool set_locale_from_bundle(locale_type type, std::string_view name, std::string_view file_name)
+{
+    instance.reset();
+    instance = std::make_shared<locale_impl>(type, name);
+    instance->load_bundle(file_name, name);
+
+    return instance->get_error().is_ok();
+}
+
 void set_locale_empty(locale_type type, std::string_view name)
 {
     instance.reset();
@@ -86,4 +95,13 @@ const std::string &locale(std::string_view section, std::string_view value)
     return dummy_string;
 }
 
+std::string_view locale_view(std::string_view section, std::string_view value)
+{
+    if (instance)
+    {
+        return instance->get_view(section, value);
+    }
+    return {};
+}
+
 }
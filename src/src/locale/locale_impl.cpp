@@ -2,6 +2,7 @@
 #include <wui/locale/locale_impl.hpp>
 #include <wui/system/tools.hpp>
 #include <wui/system/path_tools.hpp>
+#include <wui/system/bundle.hpp>
 
 #include <nlohmann/json.hpp>
 #include <boost/nowide/convert.hpp>
@@ -17,7 +18,7 @@ namespace wui
 {
 
 locale_impl::locale_impl(locale_type type_, std::string_view name_)
-    : type(type_), name(name_), strings(), dummy_string(), err{}
+    : type(type_), name(name_), strings(), strings_bundles(), dummy_string(), err{}
 {
 }
 
@@ -38,14 +39,50 @@ void locale_impl::set(std::string_view control, std::string_view value, std::str
 
 const std::string &locale_impl::get(std::string_view control, std::string_view value) const
 {
-    auto it = strings.find({ control.data(), value.data() });
+    auto it = strings.find({ std::string(control), std::string(value) });
     if (it != strings.end())
     {
         return it->second;
     }
+
+    bundle_item item;
+    if (find_bundle_string(control, value, item))
+    {
+        return strings.emplace(std::make_pair(std::string(control), std::string(value)), std::string(item.data)).first->second;
+    }
+
     return dummy_string;
 }
 
+std::string_view locale_impl::get_view(std::string_view control, std::string_view value) const
+{
+    auto it = strings.find({ std::string(control), std::string(value) });
+    if (it != strings.end())
+    {
+        return it->second;
+    }
+
+    bundle_item item;
+    if (find_bundle_string(control, value, item))
+    {
+        return item.data;
+    }
+
+    return {};
+}
+
+bool locale_impl::find_bundle_string(std::string_view control, std::string_view value, bundle_item &item) const
+{
+    for (auto it = strings_bundles.rbegin(); it != strings_bundles.rend(); ++it)
+    {
+        if (it->first->find(it->second, control, value, item) && item.kind == bundle_kind::string)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void locale_impl::load_resource(int32_t resource_index, std::string_view resource_section)
 {
     auto h_inst = GetModuleHandle(NULL);
@@ -139,6 +176,29 @@ void locale_impl::load_file(std::string_view file_name)
 void locale_impl::load_locale(const i_locale &locale_)
 {
     strings = static_cast<const locale_impl*>(&locale_)->strings;
+    strings_bundles = static_cast<const locale_impl*>(&locale_)->strings_bundles;
+}
+
+void locale_impl::load_bundle(std::string_view file_name, std::string_view part)
+{
+    err.reset();
+
+    auto b = std::make_shared<bundle>();
+    if (!b->open(file_name))
+    {
+        err = b->get_error();
+        return;
+    }
+
+    /// The strings of the new bundle replace the ones set or copied before, the others are kept
+    b->visit(part, [this](const bundle_item &item) {
+        if (item.kind == bundle_kind::string)
+        {
+            strings.erase({ std::string(item.section), std::string(item.value) });
+        }
+    });
+
+    strings_bundles.emplace_back(b, part);
 }
 
 error locale_impl::get_error() const
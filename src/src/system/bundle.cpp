@@ -0,0 +1,375 @@
+#include <wui/system/bundle.hpp>
+#include <wui/system/path_tools.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace wui
+{
+
+static const uint32_t bundle_magic = 0x42495557; /// "WUIB"
+static const uint32_t bundle_version = 1;
+
+struct bundle_header
+{
+    uint32_t magic, version;
+    uint32_t entries_count, buckets_count;
+    uint32_t buckets_offset, entries_offset;
+    uint32_t data_offset, data_size;
+};
+
+struct bundle_entry
+{
+    uint64_t hash;
+    uint32_t key_offset, key_size;
+    uint32_t data_offset, data_size;
+    int32_t number;
+    uint16_t kind, flags;
+};
+
+static_assert(sizeof(bundle_header) == 32 && sizeof(bundle_entry) == 32, "bundle layout must not depend on the compiler");
+
+/// FNV-1a, the bundle must be readable by any build, so std::hash is not used
+static uint64_t hash_bytes(uint64_t h, std::string_view s)
+{
+    for (auto c : s)
+    {
+        h ^= static_cast<uint8_t>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+static uint64_t key_hash(std::string_view part, std::string_view section, std::string_view value)
+{
+    static const char separator[] = { 0 };
+
+    auto h = hash_bytes(0xcbf29ce484222325ULL, part);
+    h = hash_bytes(h, std::string_view(separator, 1));
+    h = hash_bytes(h, section);
+    h = hash_bytes(h, std::string_view(separator, 1));
+    return hash_bytes(h, value);
+}
+
+static size_t align8(size_t v)
+{
+    return (v + 7) & ~static_cast<size_t>(7);
+}
+
+bundle::bundle()
+    : file(),
+    data(nullptr),
+    size(0),
+    err{}
+{
+}
+
+bundle::~bundle()
+{
+    close();
+}
+
+bool bundle::open(std::string_view file_name)
+{
+    close();
+    err.reset();
+
+    if (!file.open(file_name))
+    {
+        err = file.get_error();
+        err.component = "bundle::open()";
+        return false;
+    }
+
+    data = reinterpret_cast<const uint8_t*>(file.data());
+    size = static_cast<size_t>(file.size());
+
+    if (!validate())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void bundle::close()
+{
+    file.close();
+
+    data = nullptr;
+    size = 0;
+}
+
+/// All offsets are checked once here, so the lookups trust the file
+bool bundle::validate()
+{
+    err.type = error_type::invalid_bundle;
+    err.component = "bundle::validate()";
+
+    if (size < sizeof(bundle_header))
+    {
+        err.message = "bundle is truncated";
+        return false;
+    }
+
+    auto &h = *reinterpret_cast<const bundle_header*>(data);
+    if (h.magic != bundle_magic || h.version != bundle_version)
+    {
+        err.message = "unknown bundle format";
+        return false;
+    }
+
+    if (h.buckets_count == 0 ||
+        static_cast<uint64_t>(h.buckets_offset) + (static_cast<uint64_t>(h.buckets_count) + 1) * sizeof(uint32_t) > size ||
+        static_cast<uint64_t>(h.entries_offset) + static_cast<uint64_t>(h.entries_count) * sizeof(bundle_entry) > size ||
+        static_cast<uint64_t>(h.data_offset) + h.data_size > size ||
+        h.entries_offset % alignof(bundle_entry) != 0 || h.buckets_offset % alignof(uint32_t) != 0)
+    {
+        err.message = "bundle sections are out of the file";
+        return false;
+    }
+
+    auto buckets = reinterpret_cast<const uint32_t*>(data + h.buckets_offset);
+    for (uint32_t i = 0; i != h.buckets_count; ++i)
+    {
+        if (buckets[i] > buckets[i + 1] || buckets[i + 1] > h.entries_count)
+        {
+            err.message = "bundle index is broken";
+            return false;
+        }
+    }
+
+    auto entries = reinterpret_cast<const bundle_entry*>(data + h.entries_offset);
+    for (uint32_t i = 0; i != h.entries_count; ++i)
+    {
+        auto &e = entries[i];
+        if (static_cast<uint64_t>(e.key_offset) + e.key_size > h.data_size ||
+            static_cast<uint64_t>(e.data_offset) + e.data_size > h.data_size ||
+            e.kind < static_cast<uint16_t>(bundle_kind::integer) || e.kind > static_cast<uint16_t>(bundle_kind::image) ||
+            std::count(data + h.data_offset + e.key_offset, data + h.data_offset + e.key_offset + e.key_size, 0) != 2)
+        {
+            err.message = "bundle entry " + std::to_string(i) + " is broken";
+            return false;
+        }
+    }
+
+    err.reset();
+    return true;
+}
+
+bundle_item bundle::item(uint32_t index) const
+{
+    auto &h = *reinterpret_cast<const bundle_header*>(data);
+    auto &e = reinterpret_cast<const bundle_entry*>(data + h.entries_offset)[index];
+    auto area = reinterpret_cast<const char*>(data + h.data_offset);
+
+    std::string_view key(area + e.key_offset, e.key_size);
+    auto first = key.find('\0'), second = key.find('\0', first + 1);
+
+    return bundle_item{ static_cast<bundle_kind>(e.kind),
+        key.substr(0, first),
+        key.substr(first + 1, second - first - 1),
+        key.substr(second + 1),
+        std::string_view(area + e.data_offset, e.data_size),
+        e.number,
+        e.flags };
+}
+
+bool bundle::find(std::string_view part, std::string_view section, std::string_view value, bundle_item &item_) const
+{
+    if (!data)
+    {
+        return false;
+    }
+
+    auto &h = *reinterpret_cast<const bundle_header*>(data);
+    auto buckets = reinterpret_cast<const uint32_t*>(data + h.buckets_offset);
+    auto entries = reinterpret_cast<const bundle_entry*>(data + h.entries_offset);
+
+    auto hash = key_hash(part, section, value);
+    auto bucket = static_cast<uint32_t>(hash & (h.buckets_count - 1));
+
+    for (auto i = buckets[bucket]; i != buckets[bucket + 1]; ++i)
+    {
+        if (entries[i].hash == hash)
+        {
+            auto candidate = item(i);
+            if (candidate.part == part && candidate.section == section && candidate.value == value)
+            {
+                item_ = candidate;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void bundle::visit(std::string_view part, std::function<void(const bundle_item&)> visitor) const
+{
+    if (!data)
+    {
+        return;
+    }
+
+    auto &h = *reinterpret_cast<const bundle_header*>(data);
+    for (uint32_t i = 0; i != h.entries_count; ++i)
+    {
+        auto it = item(i);
+        if (it.part == part)
+        {
+            visitor(it);
+        }
+    }
+}
+
+error bundle::get_error() const
+{
+    return err;
+}
+
+/// bundle_writer
+
+bundle_writer::bundle_writer()
+    : records(),
+    record_indices()
+{
+}
+
+void bundle_writer::add(bundle_kind kind, std::string_view part, std::string_view section, std::string_view value, std::string_view data_, int32_t number, uint16_t flags)
+{
+    std::string key(part);
+    key.push_back('\0');
+    key.append(section);
+    key.push_back('\0');
+    key.append(value);
+
+    auto exists = record_indices.find(key);
+    if (exists != record_indices.end())
+    {
+        records[exists->second] = record{ kind, key, std::string(data_), number, flags };
+    }
+    else
+    {
+        record_indices.emplace(key, records.size());
+        records.emplace_back(record{ kind, key, std::string(data_), number, flags });
+    }
+}
+
+void bundle_writer::add_integer(std::string_view part, std::string_view section, std::string_view value, int32_t number)
+{
+    add(bundle_kind::integer, part, section, value, "", number, 0);
+}
+
+void bundle_writer::add_string(std::string_view part, std::string_view section, std::string_view value, std::string_view str)
+{
+    add(bundle_kind::string, part, section, value, str, 0, 0);
+}
+
+void bundle_writer::add_font(std::string_view part, std::string_view section, std::string_view value, std::string_view name, int32_t size, uint16_t decorations)
+{
+    add(bundle_kind::font, part, section, value, name, size, decorations);
+}
+
+void bundle_writer::add_image(std::string_view part, std::string_view name, const std::vector<uint8_t> &image)
+{
+    add(bundle_kind::image, part, "", name, std::string_view(reinterpret_cast<const char*>(image.data()), image.size()), 0, 0);
+}
+
+std::vector<uint8_t> bundle_writer::build() const
+{
+    uint32_t buckets_count = 1;
+    while (buckets_count < records.size())
+    {
+        buckets_count <<= 1;
+    }
+
+    struct placed
+    {
+        const record *rec;
+        uint64_t hash;
+        uint32_t bucket;
+    };
+
+    std::vector<placed> order;
+    order.reserve(records.size());
+    for (auto &r : records)
+    {
+        auto first = r.key.find('\0'), second = r.key.find('\0', first + 1);
+        std::string_view key(r.key);
+        auto hash = key_hash(key.substr(0, first), key.substr(first + 1, second - first - 1), key.substr(second + 1));
+        order.emplace_back(placed{ &r, hash, static_cast<uint32_t>(hash & (buckets_count - 1)) });
+    }
+    std::stable_sort(order.begin(), order.end(), [](const placed &a, const placed &b) { return a.bucket < b.bucket; });
+
+    bundle_header h = {};
+    h.magic = bundle_magic;
+    h.version = bundle_version;
+    h.entries_count = static_cast<uint32_t>(order.size());
+    h.buckets_count = buckets_count;
+    h.buckets_offset = sizeof(bundle_header);
+    h.entries_offset = static_cast<uint32_t>(align8(h.buckets_offset + (buckets_count + 1) * sizeof(uint32_t)));
+    h.data_offset = h.entries_offset + h.entries_count * sizeof(bundle_entry);
+
+    std::vector<uint32_t> buckets(buckets_count + 1, 0);
+    for (auto &p : order)
+    {
+        ++buckets[p.bucket + 1];
+    }
+    for (uint32_t i = 0; i != buckets_count; ++i)
+    {
+        buckets[i + 1] += buckets[i];
+    }
+
+    std::string area;
+    std::vector<bundle_entry> entries;
+    entries.reserve(order.size());
+    for (auto &p : order)
+    {
+        bundle_entry e = {};
+        e.hash = p.hash;
+        e.key_offset = static_cast<uint32_t>(area.size());
+        e.key_size = static_cast<uint32_t>(p.rec->key.size());
+        area.append(p.rec->key);
+        e.data_offset = static_cast<uint32_t>(area.size());
+        e.data_size = static_cast<uint32_t>(p.rec->data.size());
+        area.append(p.rec->data);
+        e.number = p.rec->number;
+        e.kind = static_cast<uint16_t>(p.rec->kind);
+        e.flags = p.rec->flags;
+        entries.emplace_back(e);
+    }
+    h.data_size = static_cast<uint32_t>(area.size());
+
+    std::vector<uint8_t> out(h.data_offset + area.size(), 0);
+    memcpy(out.data(), &h, sizeof(h));
+    memcpy(out.data() + h.buckets_offset, buckets.data(), buckets.size() * sizeof(uint32_t));
+    if (!entries.empty())
+    {
+        memcpy(out.data() + h.entries_offset, entries.data(), entries.size() * sizeof(bundle_entry));
+    }
+    if (!area.empty())
+    {
+        memcpy(out.data() + h.data_offset, area.data(), area.size());
+    }
+
+    return out;
+}
+
+bool bundle_writer::save(std::string_view file_name) const
+{
+    auto out = build();
+
+    std::ofstream f(real_path(file_name), std::ios::binary | std::ios::trunc);
+    if (!f)
+    {
+        return false;
+    }
+
+    f.write(reinterpret_cast<const char*>(out.data()), out.size());
+    return f.good();
+}
+
+}
@@ -0,0 +1,154 @@
+#include <wui/system/mapped_file.hpp>
+#include <wui/system/path_tools.hpp>
+
+#include <boost/nowide/convert.hpp>
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace wui
+{
+
+mapped_file::mapped_file()
+    : data_(nullptr),
+    size_(0),
+#ifdef _WIN32
+    file(INVALID_HANDLE_VALUE),
+    mapping(NULL),
+#elif __linux__
+    file(-1),
+#endif
+    err{}
+{
+}
+
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+bool mapped_file::open(std::string_view file_name, bool sequential)
+{
+    close();
+    err.reset();
+
+#ifdef _WIN32
+    file = CreateFileW(boost::nowide::widen(real_path(file_name)).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        err.type = error_type::file_not_found;
+        err.component = "mapped_file::open()";
+        err.message = "Unable to open file: " + real_path(file_name) + " error: " + std::to_string(GetLastError());
+        return false;
+    }
+
+    LARGE_INTEGER file_size = { 0 };
+    GetFileSizeEx(file, &file_size);
+    size_ = static_cast<uint64_t>(file_size.QuadPart);
+
+    if (size_ != 0 && size_ <= SIZE_MAX)
+    {
+        mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping)
+        {
+            data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+#elif __linux__
+    file = ::open(real_path(file_name).c_str(), O_RDONLY);
+    if (file == -1)
+    {
+        err.type = error_type::file_not_found;
+        err.component = "mapped_file::open()";
+        err.message = "Unable to open file: " + real_path(file_name) + " errno: " + std::to_string(errno);
+        return false;
+    }
+
+    struct stat st = {};
+    fstat(file, &st);
+    size_ = static_cast<uint64_t>(st.st_size);
+
+    if (size_ != 0 && size_ <= SIZE_MAX)
+    {
+        auto ptr = mmap(nullptr, static_cast<size_t>(size_), PROT_READ, MAP_PRIVATE, file, 0);
+        if (ptr != MAP_FAILED)
+        {
+            data_ = static_cast<const char*>(ptr);
+
+            if (sequential)
+            {
+                madvise(ptr, static_cast<size_t>(size_), MADV_SEQUENTIAL);
+            }
+        }
+    }
+#endif
+
+    if (!data_ && size_ != 0)
+    {
+        err.type = error_type::system_error;
+        err.component = "mapped_file::open()";
+        err.message = "Unable to map file: " + real_path(file_name);
+
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void mapped_file::close()
+{
+#ifdef _WIN32
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping)
+    {
+        CloseHandle(mapping);
+        mapping = NULL;
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+#elif __linux__
+    if (data_)
+    {
+        munmap(const_cast<char*>(data_), static_cast<size_t>(size_));
+    }
+    if (file != -1)
+    {
+        ::close(file);
+        file = -1;
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+const char *mapped_file::data() const
+{
+    return data_;
+}
+
+uint64_t mapped_file::size() const
+{
+    return size_;
+}
+
+error mapped_file::get_error() const
+{
+    return err;
+}
+
+}
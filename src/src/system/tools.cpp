@@ -52,9 +52,14 @@ void update_control_position(rect &control_position,
     auto prev_position = control_position;
     control_position = new_control_position;
 
+    auto parent_ = parent.lock();
+    if (parent_)
+    {
+        parent_->invalidate_controls_grid();
+    }
+
     if (redraw)
     {
-        auto parent_ = parent.lock();
         if (parent_)
         {
             if (parent_->parent().lock() != nullptr)
@@ -7,6 +7,7 @@ namespace wui
 
 static std::shared_ptr<i_theme> instance = nullptr;
 static std::string dummy_string;
+static font dummy_font;
 static std::vector<uint8_t> dummy_image;
 
 /// Interface
@@ -38,6 +39,15 @@ bool set_default_theme_from_file(std::string_view name, std::string_view file_na
     return instance->get_error().is_ok();
 }
 
+bool set_default_theme_from_bundle(std::string_view name, std::string_view file_name)
+{
+    instance.reset();
+    instance = std::make_shared<theme_impl>(name);
+    instance->load_bundle(file_name, name);
+
+    return instance->get_error().is_ok();
+}
+
 void set_default_theme_empty(std::string_view name)
 {
     instance.reset();
@@ -119,7 +129,7 @@ const std::string &theme_string(std::string_view control, std::string_view value
     return dummy_string;
 }
 
-font theme_font(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_)
+const font &theme_font(std::string_view control, std::string_view value, std::shared_ptr<i_theme> theme_)
 {
     if (theme_)
     {
@@ -129,7 +139,31 @@ font theme_font(std::string_view control, std::string_view value, std::shared_pt
     {
         return instance->get_font(control, value);
     }
-    return font();
+    return dummy_font;
+}
+
+color theme_color(theme_key key, const std::shared_ptr<i_theme> &theme_)
+{
+    auto t = theme_ ? theme_.get() : instance.get();
+    return t ? t->get_color(key) : 0;
+}
+
+int32_t theme_dimension(theme_key key, const std::shared_ptr<i_theme> &theme_)
+{
+    auto t = theme_ ? theme_.get() : instance.get();
+    return t ? t->get_dimension(key) : 0;
+}
+
+const std::string &theme_string(theme_key key, const std::shared_ptr<i_theme> &theme_)
+{
+    auto t = theme_ ? theme_.get() : instance.get();
+    return t ? t->get_string(key) : dummy_string;
+}
+
+const font &theme_font(theme_key key, const std::shared_ptr<i_theme> &theme_)
+{
+    auto t = theme_ ? theme_.get() : instance.get();
+    return t ? t->get_font(key) : dummy_font;
 }
 
 const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i_theme> theme_)
@@ -146,4 +180,18 @@ const std::vector<uint8_t> &theme_image(std::string_view name, std::shared_ptr<i
     return dummy_image;
 }
 
+std::string_view theme_image_view(std::string_view name, std::shared_ptr<i_theme> theme_)
+{
+    if (theme_)
+    {
+        return theme_->get_image_view(name);
+    }
+    else if (instance)
+    {
+        return instance->get_image_view(name);
+    }
+
+    return {};
+}
+
 }
@@ -1,6 +1,7 @@
 ﻿#include <wui/theme/theme_impl.hpp>
 #include <wui/system/tools.hpp>
 #include <wui/system/path_tools.hpp>
+#include <wui/system/bundle.hpp>
 
 #include <nlohmann/json.hpp>
 #include <boost/nowide/convert.hpp>
@@ -14,7 +15,7 @@ namespace wui
 {
 
 theme_impl::theme_impl(std::string_view name_)
-    : name(name_), ints(), strings(), fonts(), imgs(), dummy_string(), dummy_image(), err{}
+    : name(name_), ints(), strings(), fonts(), imgs(), images_bundles(), dummy_string(), dummy_font(), dummy_image(), err{}
 {
 }
 
@@ -23,64 +24,78 @@ std::string theme_impl::get_name() const
     return name;
 }
 
+template<typename T>
+void theme_impl::store(std::vector<T> &values, theme_key key, const T &value)
+{
+    if (key >= values.size())
+    {
+        values.resize(key + 1);
+    }
+    values[key] = value;
+}
+
 void theme_impl::set_color(std::string_view control, std::string_view value, color color_)
 {
-    ints[{ control.data(), value.data() }] = color_;
+    store(ints, make_theme_key(control, value), static_cast<int32_t>(color_));
 }
 
 color theme_impl::get_color(std::string_view control, std::string_view value) const
 {
-    auto it = ints.find({ control.data(), value.data() });
-    if (it != ints.end())
-    {
-        return static_cast<color>(it->second);
-    }
-    return 0;
+    theme_key key = 0;
+    return find_theme_key(control, value, key) ? get_color(key) : 0;
+}
+
+color theme_impl::get_color(theme_key key) const
+{
+    return key < ints.size() ? static_cast<color>(ints[key]) : 0;
 }
 
 void theme_impl::set_dimension(std::string_view control, std::string_view value, int32_t dimension)
 {
-    ints[{ control.data(), value.data() }] = dimension;
+    store(ints, make_theme_key(control, value), dimension);
 }
 
 int32_t theme_impl::get_dimension(std::string_view control, std::string_view value) const
 {
-    auto it = ints.find({ control.data(), value.data() });
-    if (it != ints.end())
-    {
-        return it->second;
-    }
-    return 0;
+    theme_key key = 0;
+    return find_theme_key(control, value, key) ? get_dimension(key) : 0;
+}
+
+int32_t theme_impl::get_dimension(theme_key key) const
+{
+    return key < ints.size() ? ints[key] : 0;
 }
 
 void theme_impl::set_string(std::string_view control, std::string_view value, std::string_view str)
 {
-    strings[{ control.data(), value.data() }] = str;
+    store(strings, make_theme_key(control, value), std::string(str));
 }
 
 const std::string &theme_impl::get_string(std::string_view control, std::string_view value) const
 {
-    auto it = strings.find({ control.data(), value.data() });
-    if (it != strings.end())
-    {
-        return it->second;
-    }
-    return dummy_string;
+    theme_key key = 0;
+    return find_theme_key(control, value, key) ? get_string(key) : dummy_string;
+}
+
+const std::string &theme_impl::get_string(theme_key key) const
+{
+    return key < strings.size() ? strings[key] : dummy_string;
 }
 
 void theme_impl::set_font(std::string_view control, std::string_view value, const font &font_)
 {
-    fonts[{ control.data(), value.data() }] = font_;
+    store(fonts, make_theme_key(control, value), font_);
 }
 
-font theme_impl::get_font(std::string_view control, std::string_view value) const
+const font &theme_impl::get_font(std::string_view control, std::string_view value) const
 {
-    auto it = fonts.find({ control.data(), value.data() });
-    if (it != fonts.end())
-    {
-        return it->second;
-    }
-    return font();
+    theme_key key = 0;
+    return find_theme_key(control, value, key) ? get_font(key) : dummy_font;
+}
+
+const font &theme_impl::get_font(theme_key key) const
+{
+    return key < fonts.size() ? fonts[key] : dummy_font;
 }
 
 void theme_impl::set_image(std::string_view name_, const std::vector<uint8_t> &data)
@@ -90,14 +105,52 @@ void theme_impl::set_image(std::string_view name_, const std::vector<uint8_t> &d
 
 const std::vector<uint8_t> &theme_impl::get_image(std::string_view name_)
 {
-    auto it = imgs.find(name_.data());
+    auto it = imgs.find(std::string(name_));
     if (it != imgs.end())
     {
         return it->second;
     }
+
+    bundle_item item;
+    if (find_bundle_image(name_, item))
+    {
+        auto &img = imgs[std::string(name_)];
+        img.assign(item.data.begin(), item.data.end());
+        return img;
+    }
+
     return dummy_image;
 }
 
+std::string_view theme_impl::get_image_view(std::string_view name_) const
+{
+    auto it = imgs.find(std::string(name_));
+    if (it != imgs.end())
+    {
+        return std::string_view(reinterpret_cast<const char*>(it->second.data()), it->second.size());
+    }
+
+    bundle_item item;
+    if (find_bundle_image(name_, item))
+    {
+        return item.data;
+    }
+
+    return {};
+}
+
+bool theme_impl::find_bundle_image(std::string_view name_, bundle_item &item) const
+{
+    for (auto it = images_bundles.rbegin(); it != images_bundles.rend(); ++it)
+    {
+        if (it->first->find(it->second, "", name_, item) && item.kind == bundle_kind::image)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void theme_impl::load_resource(int32_t resource_index, std::string_view resource_section)
 {
     auto h_inst = GetModuleHandle(NULL);
@@ -163,7 +216,7 @@ void theme_impl::load_json(std::string_view json_)
                             str.insert(0, "0x");
                             int32_t color = std::stol(str, nullptr, 16);
 
-                            ints[{ control, kvp.first }] = make_color(get_red(color), get_green(color), get_blue(color));
+                            set_color(control, kvp.first, make_color(get_red(color), get_green(color), get_blue(color)));
                         }
                         catch (...)
                         {
@@ -174,12 +227,12 @@ void theme_impl::load_json(std::string_view json_)
                     }
                     else
                     {
-                        strings[{ control, kvp.first }] = str;
+                        set_string(control, kvp.first, str);
                     }
                 }
                 else if (kvp.second.is_number_integer())
                 {
-                    ints[{ control, kvp.first }] = kvp.second.get<int32_t>();
+                    set_dimension(control, kvp.first, kvp.second.get<int32_t>());
                 }
                 else if (kvp.second.is_object() && kvp.first.find("font") != std::string::npos)
                 {
@@ -213,7 +266,7 @@ void theme_impl::load_json(std::string_view json_)
                         size = size_it->second.get<std::int32_t>();
                     }
 
-                    fonts[{ control, kvp.first }] = font{ font_name, size, static_cast<decorations>(decorations_) };
+                    set_font(control, kvp.first, font{ font_name, size, static_cast<decorations>(decorations_) });
                 }
             }
         }
@@ -300,6 +353,40 @@ void theme_impl::load_theme(const i_theme &theme_)
     ints = static_cast<const theme_impl*>(&theme_)->ints;
     strings = static_cast<const theme_impl*>(&theme_)->strings;
     fonts = static_cast<const theme_impl*>(&theme_)->fonts;
+    images_bundles = static_cast<const theme_impl*>(&theme_)->images_bundles;
+}
+
+void theme_impl::load_bundle(std::string_view file_name, std::string_view part)
+{
+    err.reset();
+
+    auto b = std::make_shared<bundle>();
+    if (!b->open(file_name))
+    {
+        err = b->get_error();
+        return;
+    }
+
+    b->visit(part, [this](const bundle_item &item) {
+        switch (item.kind)
+        {
+            case bundle_kind::integer:
+                store(ints, make_theme_key(item.section, item.value), item.number);
+            break;
+            case bundle_kind::string:
+                store(strings, make_theme_key(item.section, item.value), std::string(item.data));
+            break;
+            case bundle_kind::font:
+                store(fonts, make_theme_key(item.section, item.value), font{ std::string(item.data), item.number, static_cast<decorations>(item.flags) });
+            break;
+            case bundle_kind::image:
+                /// The image of the new bundle replaces the one set or copied before
+                imgs.erase(std::string(item.value));
+            break;
+        }
+    });
+
+    images_bundles.emplace_back(b, part);
 }
 
 error theme_impl::get_error() const
@@ -0,0 +1,89 @@
+#include <wui/theme/theme_key.hpp>
+
+#include <unordered_map>
+#include <mutex>
+
+namespace wui
+{
+
+struct key_registry
+{
+    std::mutex mutex;
+    std::unordered_multimap<size_t, theme_key> index;
+    std::vector<std::pair<std::string, std::string>> names;
+};
+
+/// Never destroyed, because the controls of the static objects can resolve keys after the statics destruction
+static key_registry &registry()
+{
+    static auto instance = new key_registry();
+    return *instance;
+}
+
+static size_t key_hash(std::string_view control, std::string_view value)
+{
+    auto h = std::hash<std::string_view>()(control);
+    return h ^ (std::hash<std::string_view>()(value) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+theme_key make_theme_key(std::string_view control, std::string_view value)
+{
+    auto &r = registry();
+    auto hash = key_hash(control, value);
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    auto range = r.index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto &name = r.names[it->second];
+        if (name.first == control && name.second == value)
+        {
+            return it->second;
+        }
+    }
+
+    auto key = static_cast<theme_key>(r.names.size());
+    r.names.emplace_back(std::string(control), std::string(value));
+    r.index.emplace(hash, key);
+
+    return key;
+}
+
+bool find_theme_key(std::string_view control, std::string_view value, theme_key &key)
+{
+    auto &r = registry();
+    auto hash = key_hash(control, value);
+
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    auto range = r.index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto &name = r.names[it->second];
+        if (name.first == control && name.second == value)
+        {
+            key = it->second;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+theme_key theme_keys_count()
+{
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return static_cast<theme_key>(r.names.size());
+}
+
+void theme_keys::reset()
+{
+    for (size_t i = 0; i != keys.size(); ++i)
+    {
+        keys[i] = make_theme_key(control, values[i]);
+    }
+}
+
+}
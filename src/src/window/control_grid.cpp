@@ -0,0 +1,124 @@
+#include <wui/window/control_grid.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+static uint64_t cell_key(int32_t column, int32_t row)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+}
+
+control_grid::control_grid(int32_t cell_size_, int32_t max_cells_per_control_)
+    : cell_size(cell_size_ > 0 ? cell_size_ : 64),
+    max_cells_per_control(max_cells_per_control_),
+    positions(),
+    cells(),
+    large_controls()
+{
+}
+
+int32_t control_grid::cell(int32_t coordinate) const
+{
+    return coordinate >= 0 ? coordinate / cell_size : -((-coordinate + cell_size - 1) / cell_size);
+}
+
+void control_grid::clear()
+{
+    positions.clear();
+    cells.clear();
+    large_controls.clear();
+}
+
+void control_grid::insert(int32_t order, const rect &position)
+{
+    if (static_cast<int32_t>(positions.size()) <= order)
+    {
+        positions.resize(order + 1);
+    }
+    positions[order] = position;
+
+    if (position.right < position.left || position.bottom < position.top)
+    {
+        /// The rect test of the malformed positions is not local, so check it always
+        large_controls.emplace_back(order);
+        return;
+    }
+
+    auto first_column = cell(position.left), last_column = cell(position.right),
+        first_row = cell(position.top), last_row = cell(position.bottom);
+
+    if (static_cast<int64_t>(last_column - first_column + 1) * (last_row - first_row + 1) > max_cells_per_control)
+    {
+        large_controls.emplace_back(order);
+        return;
+    }
+
+    for (auto column = first_column; column <= last_column; ++column)
+    {
+        for (auto row = first_row; row <= last_row; ++row)
+        {
+            cells[cell_key(column, row)].emplace_back(order);
+        }
+    }
+}
+
+void control_grid::query(int32_t x, int32_t y, std::vector<int32_t> &orders) const
+{
+    orders.clear();
+
+    auto it = cells.find(cell_key(cell(x), cell(y)));
+    if (it != cells.end())
+    {
+        std::merge(it->second.begin(), it->second.end(), large_controls.begin(), large_controls.end(), std::back_inserter(orders));
+    }
+    else
+    {
+        orders = large_controls;
+    }
+
+    orders.erase(std::remove_if(orders.begin(), orders.end(), [this, x, y](int32_t order) { return !positions[order].in(x, y); }), orders.end());
+}
+
+void control_grid::query(const rect &area, std::vector<int32_t> &orders) const
+{
+    orders.clear();
+
+    auto first_column = cell(area.left), last_column = cell(area.right),
+        first_row = cell(area.top), last_row = cell(area.bottom);
+
+    if (area.right < area.left || area.bottom < area.top ||
+        static_cast<int64_t>(last_column - first_column + 1) * (last_row - first_row + 1) > static_cast<int64_t>(cells.size()))
+    {
+        /// The area is larger than the filled part of the grid, the plain scan is cheaper
+        for (int32_t order = 0; order != static_cast<int32_t>(positions.size()); ++order)
+        {
+            if (positions[order].in(area))
+            {
+                orders.emplace_back(order);
+            }
+        }
+        return;
+    }
+
+    for (auto column = first_column; column <= last_column; ++column)
+    {
+        for (auto row = first_row; row <= last_row; ++row)
+        {
+            auto it = cells.find(cell_key(column, row));
+            if (it != cells.end())
+            {
+                orders.insert(orders.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+    orders.insert(orders.end(), large_controls.begin(), large_controls.end());
+
+    std::sort(orders.begin(), orders.end());
+    orders.erase(std::unique(orders.begin(), orders.end()), orders.end());
+
+    orders.erase(std::remove_if(orders.begin(), orders.end(), [this, &area](int32_t order) { return !positions[order].in(area); }), orders.end());
+}
+
+}
@@ -0,0 +1,119 @@
+#include <wui/window/damage_region.hpp>
+
+#include <algorithm>
+
+namespace wui
+{
+
+/// Returns true if the rects overlap or share an edge, the corner contact is not counted
+static bool touching(const rect &a, const rect &b)
+{
+    bool overlap_x = a.left < b.right && b.left < a.right, touch_x = a.left <= b.right && b.left <= a.right;
+    bool overlap_y = a.top < b.bottom && b.top < a.bottom, touch_y = a.top <= b.bottom && b.top <= a.bottom;
+
+    return (touch_x && overlap_y) || (overlap_x && touch_y);
+}
+
+static rect unite(const rect &a, const rect &b)
+{
+    return { std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+damage_region::damage_region(size_t max_rects_)
+    : max_rects(max_rects_ > 0 ? max_rects_ : 1),
+    rects_(),
+    statistics_{ 0, 0 }
+{
+    rects_.reserve(max_rects + 1);
+}
+
+void damage_region::add(const rect &damaged_rect)
+{
+    if (damaged_rect.width() <= 0 || damaged_rect.height() <= 0)
+    {
+        return;
+    }
+
+    ++statistics_.submitted_rects;
+
+    auto merged = damaged_rect;
+
+    /// The grown rect can touch the rects which were skipped before, so repeat until nothing is absorbed
+    bool absorbed = true;
+    while (absorbed)
+    {
+        absorbed = false;
+
+        for (auto it = rects_.begin(); it != rects_.end();)
+        {
+            if (touching(*it, merged))
+            {
+                merged = unite(*it, merged);
+                it = rects_.erase(it);
+                absorbed = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    rects_.emplace_back(merged);
+
+    if (rects_.size() > max_rects)
+    {
+        auto bounds_ = bounds();
+        rects_.clear();
+        rects_.emplace_back(bounds_);
+    }
+}
+
+bool damage_region::empty() const
+{
+    return rects_.empty();
+}
+
+const std::vector<rect> &damage_region::rects() const
+{
+    return rects_;
+}
+
+rect damage_region::bounds() const
+{
+    if (rects_.empty())
+    {
+        return { 0 };
+    }
+
+    auto out = rects_.front();
+    for (auto &r : rects_)
+    {
+        out = unite(out, r);
+    }
+
+    return out;
+}
+
+std::vector<rect> damage_region::flush()
+{
+    std::vector<rect> out;
+    out.swap(rects_);
+    rects_.reserve(max_rects + 1);
+
+    statistics_.painted_rects += out.size();
+
+    return out;
+}
+
+damage_statistics damage_region::statistics() const
+{
+    return statistics_;
+}
+
+void damage_region::reset_statistics()
+{
+    statistics_ = { 0, 0 };
+}
+
+}
@@ -16,7 +16,6 @@
 
 #include <algorithm>
 #include <set>
-#include <random>
 
 #include <windowsx.h>
 
@@ -46,7 +45,12 @@ namespace wui
 window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> theme_)
     : context_{ 0 },
     graphic_(context_),
+    damage_(),
+    damage_erase(false),
     controls(),
+    controls_grid(),
+    controls_grid_valid(false),
+    grid_hits(),
     active_control(),
     caption(),
     position_(), normal_position(),
@@ -54,6 +58,7 @@ window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> the
     window_style_(window_style::frame),
     window_state_(window_state::normal), prev_window_state_(window_state_),
     tcn(theme_control_name),
+    tcn_keys(tcn, theme_values),
     theme_(theme_),
     showed_(true), enabled_(true), skip_draw_(false),
     focused_index(0),
@@ -61,18 +66,24 @@ window::window(std::string_view theme_control_name, std::shared_ptr<i_theme> the
     my_control_sid(), my_plain_sid(),
     transient_window(), docked_(false), docked_control(),
     subscribers_(),
+    free_subscriber_slots(),
+    plain_subscribers(),
+    control_subscribers(),
+    subscriber_generation(0),
+    dispatch_depth(0),
+    subscribers_dirty(false),
     moving_mode_(moving_mode::none),
     x_click(0), y_click(0),
     err{},
     close_callback(),
     control_callback(),
     default_push_control(),
-	switch_lang_button(std::make_shared<button>(locale(tcn, cl_switch_lang), std::bind(&window::switch_lang, this), button_view::image, theme_image(ti_switch_lang), 24, button::tc_tool)),
-    switch_theme_button(std::make_shared<button>(locale(tcn, cl_light_theme), std::bind(&window::switch_theme, this), button_view::image, theme_image(ti_switch_theme), 24, button::tc_tool)),
-    pin_button(std::make_shared<button>(locale(tcn, cl_pin), std::bind(&window::pin, this), button_view::image, theme_image(ti_pin), 24, button::tc_tool)),
-    minimize_button(std::make_shared<button>("", std::bind(&window::minimize, this), button_view::image, theme_image(ti_minimize), 24, button::tc_tool)),
-    expand_button(std::make_shared<button>("", [this]() { window_state_ == window_state::normal ? expand() : normal(); }, button_view::image, window_state_ == window_state::normal ? theme_image(ti_expand) : theme_image(ti_normal), 24, button::tc_tool)),
-    close_button(std::make_shared<button>("", std::bind(&window::destroy, this), button_view::image, theme_image(ti_close), 24, button::tc_tool_red)),
+	switch_lang_button(std::make_shared<button>(locale(tcn, cl_switch_lang), std::bind(&window::switch_lang, this), button_view::image, ti_switch_lang, 24, button::tc_tool)),
+    switch_theme_button(std::make_shared<button>(locale(tcn, cl_light_theme), std::bind(&window::switch_theme, this), button_view::image, ti_switch_theme, 24, button::tc_tool)),
+    pin_button(std::make_shared<button>(locale(tcn, cl_pin), std::bind(&window::pin, this), button_view::image, ti_pin, 24, button::tc_tool)),
+    minimize_button(std::make_shared<button>("", std::bind(&window::minimize, this), button_view::image, ti_minimize, 24, button::tc_tool)),
+    expand_button(std::make_shared<button>("", [this]() { window_state_ == window_state::normal ? expand() : normal(); }, button_view::image, window_state_ == window_state::normal ? ti_expand : ti_normal, 24, button::tc_tool)),
+    close_button(std::make_shared<button>("", std::bind(&window::destroy, this), button_view::image, ti_close, 24, button::tc_tool_red)),
     mouse_tracked(false)
 {
 	switch_lang_button->disable_focusing();
@@ -104,6 +115,7 @@ void window::add_control(std::shared_ptr<i_control> control, const rect &control
         control->set_parent(shared_from_this());
         control->set_position(control_position, false);
         controls.emplace_back(control);
+        controls_grid_valid = false;
 
         redraw(control->position());
     }
@@ -120,6 +132,7 @@ void window::remove_control(std::shared_ptr<i_control> control)
     if (exists != controls.end())
     {
         controls.erase(exists);
+        controls_grid_valid = false;
     }
 
     if (control == docked_control)
@@ -143,6 +156,7 @@ void window::bring_to_front(std::shared_ptr<i_control> control)
             controls.erase(it);
         }
         controls.emplace_back(control);
+        controls_grid_valid = false;
     }
 }
 
@@ -157,6 +171,7 @@ void window::move_to_back(std::shared_ptr<i_control> control)
             controls.erase(it);
         }
         controls.insert(controls.begin(), control);
+        controls_grid_valid = false;
     }
 }
 
@@ -174,45 +189,145 @@ void window::redraw(const rect &redraw_position, bool clear)
     }
     else
     {
-        RECT invalidatingRect = { redraw_position.left > 0 ? redraw_position.left : 0,
-            redraw_position.top > 0 ? redraw_position.top : 0,
-            redraw_position.right > 0 ? redraw_position.right : 0,
-            redraw_position.bottom > 0 ? redraw_position.bottom : 0 };
-        InvalidateRect(context_.hwnd, &invalidatingRect, clear ? TRUE : FALSE);
+        /// The damage out of the client area gets no WM_PAINT, which is the only place clearing the damage, so it is not kept
+        RECT client_rect = { 0 };
+        GetClientRect(context_.hwnd, &client_rect);
+
+        rect damaged_rect = { std::max(redraw_position.left, static_cast<int32_t>(client_rect.left)),
+            std::max(redraw_position.top, static_cast<int32_t>(client_rect.top)),
+            std::min(redraw_position.right, static_cast<int32_t>(client_rect.right)),
+            std::min(redraw_position.bottom, static_cast<int32_t>(client_rect.bottom)) };
+
+        if (damaged_rect.right <= damaged_rect.left || damaged_rect.bottom <= damaged_rect.top)
+        {
+            return;
+        }
+
+        /// Only the first damage of the frame asks the system for WM_PAINT, the next ones are accumulated until it comes
+        bool paint_requested = !damage_.empty();
+
+        damage_.add(damaged_rect);
+        damage_erase = damage_erase || clear;
+
+        if (!paint_requested && !damage_.empty())
+        {
+            RECT invalidatingRect = { damaged_rect.left, damaged_rect.top, damaged_rect.right, damaged_rect.bottom };
+            InvalidateRect(context_.hwnd, &invalidatingRect, FALSE);
+        }
     }
 }
 
-std::string window::subscribe(std::function<void(const event&)> receive_callback_, event_type event_types_, std::shared_ptr<i_control> control_)
+static size_t event_type_index(event_type type)
 {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> uid(0, 61);
+    auto value = static_cast<uint32_t>(type);
 
-    auto randchar = [&uid, &gen]() -> char
+    size_t index = 0;
+    while (value > 1)
     {
-        const char charset[] =
-            "0123456789"
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "abcdefghijklmnopqrstuvwxyz";
-        const size_t max_index = (sizeof(charset) - 1);
-        return charset[uid(gen)];
-    };
+        value >>= 1;
+        ++index;
+    }
+
+    return index;
+}
+
+subscription_id window::subscribe(std::function<void(const event&)> receive_callback_, event_type event_types_, std::shared_ptr<i_control> control_)
+{
+    size_t slot = subscribers_.size();
+    if (!free_subscriber_slots.empty())
+    {
+        slot = free_subscriber_slots.back();
+        free_subscriber_slots.pop_back();
+    }
+    else
+    {
+        subscribers_.emplace_back();
+    }
+
+    if (++subscriber_generation == 0)
+    {
+        ++subscriber_generation;
+    }
+
+    auto id = (static_cast<subscription_id>(subscriber_generation) << 32) | static_cast<uint32_t>(slot);
 
-    std::string id(20, 0);
-    std::generate_n(id.begin(), 20, randchar);
+    subscribers_[slot] = event_subscriber{ id, receive_callback_, event_types_, control_ };
+
+    auto &slots = control_ ? control_subscribers[control_.get()] : plain_subscribers;
+    for (size_t i = 0; i != event_types_count; ++i)
+    {
+        if (static_cast<uint32_t>(event_types_) & (1 << i))
+        {
+            slots[i].emplace_back(slot);
+        }
+    }
 
-    subscribers_.emplace_back(event_subscriber{ id, receive_callback_, event_types_, control_ });
     return id;
 }
 
-void window::unsubscribe(std::string_view subscriber_id)
+void window::unsubscribe(subscription_id id)
 {
-    auto it = std::find_if(subscribers_.begin(), subscribers_.end(), [&subscriber_id](const event_subscriber &es) {
-        return es.id == subscriber_id;
-    });
-    if (it != subscribers_.end())
+    auto slot = static_cast<size_t>(id & 0xFFFFFFFF);
+    if (id == 0 || slot >= subscribers_.size() || subscribers_[slot].id != id)
     {
-        subscribers_.erase(it);
+        return;
+    }
+
+    auto &subscriber = subscribers_[slot];
+    subscriber.id = 0;
+    subscribers_dirty = true;
+
+    if (dispatch_depth == 0)
+    {
+        /// The callback is not running, so it can be released now
+        subscriber.receive_callback = nullptr;
+        subscriber.control.reset();
+    }
+}
+
+void window::compact_subscribers()
+{
+    if (!subscribers_dirty || dispatch_depth != 0)
+    {
+        return;
+    }
+    subscribers_dirty = false;
+
+    auto dead = [this](size_t slot) { return subscribers_[slot].id == 0; };
+
+    for (auto &slots : plain_subscribers)
+    {
+        slots.erase(std::remove_if(slots.begin(), slots.end(), dead), slots.end());
+    }
+
+    for (auto it = control_subscribers.begin(); it != control_subscribers.end();)
+    {
+        bool empty = true;
+        for (auto &slots : it->second)
+        {
+            slots.erase(std::remove_if(slots.begin(), slots.end(), dead), slots.end());
+            empty = empty && slots.empty();
+        }
+
+        if (empty)
+        {
+            it = control_subscribers.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    free_subscriber_slots.clear();
+    for (size_t slot = 0; slot != subscribers_.size(); ++slot)
+    {
+        if (subscribers_[slot].id == 0)
+        {
+            subscribers_[slot].receive_callback = nullptr;
+            subscribers_[slot].control.reset();
+            free_subscriber_slots.emplace_back(slot);
+        }
     }
 }
 
@@ -241,41 +356,21 @@ void window::draw(graphic &gr, const rect &paint_rect)
     auto window_pos = position();
 
     gr.draw_rect(window_pos, 
-        theme_color(tcn, tv_background, theme_),
-        theme_color(tcn, tv_background, theme_),
-        theme_dimension(tcn, tv_border_width, theme_),
-        theme_dimension(tcn, tv_round, theme_)
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_color(tcn_keys[tk_background], theme_),
+        theme_dimension(tcn_keys[tk_border_width], theme_),
+        theme_dimension(tcn_keys[tk_round], theme_)
     );
 
     if (flag_is_set(window_style_, window_style::title_showed))
     {
         gr.draw_text({ window_pos.left + 10, window_pos.top + 10, 0, 0 },
             caption,
-            theme_color(tcn, tv_text, theme_),
-            theme_font(tcn, tv_caption_font, theme_));
+            theme_color(tcn_keys[tk_text], theme_),
+            theme_font(tcn_keys[tk_caption_font], theme_));
     }
 
-    std::vector<std::shared_ptr<i_control>> topmost_controls;
-    
-    for (auto &control : controls)
-    {
-        if (control->position().in(paint_rect))
-        {
-            if (!control->topmost())
-            {
-                control->draw(gr, paint_rect);
-            }
-            else
-            {
-                topmost_controls.emplace_back(control);
-            }
-        }
-    }
-
-    for (auto &control : topmost_controls)
-    {
-        control->draw(gr, paint_rect);
-    }
+    draw_controls(gr, paint_rect);
 
     if (flag_is_set(window_style_, window_style::border_left) &&
         flag_is_set(window_style_, window_style::border_top) &&
@@ -283,10 +378,10 @@ void window::draw(graphic &gr, const rect &paint_rect)
         flag_is_set(window_style_, window_style::border_bottom))
     {
         gr.draw_rect(window_pos, 
-            theme_color(tcn, tv_border, theme_),
+            theme_color(tcn_keys[tk_border], theme_),
             make_color(0, 0, 0, 255),
-            theme_dimension(tcn, tv_border_width, theme_),
-            theme_dimension(tcn, tv_round, theme_)
+            theme_dimension(tcn_keys[tk_border_width], theme_),
+            theme_dimension(tcn_keys[tk_round], theme_)
         );
     }
     else
@@ -420,6 +515,7 @@ void window::set_position(const rect &position__, bool redraw_)
         }
 
         position_ = { left, top, left + position___.width(), top + position___.height() };
+        parent__->invalidate_controls_grid();
 
         skip_draw_ = true;
         send_internal(internal_event_type::size_changed, position_.width(), position_.height());
@@ -529,6 +625,7 @@ bool window::focusing() const
 void window::update_theme_control_name(std::string_view theme_control_name)
 {
     tcn = theme_control_name;
+    tcn_keys.reset();
     update_theme(theme_);
 }
 
@@ -542,7 +639,7 @@ void window::update_theme(std::shared_ptr<i_theme> theme__)
 
     if (context_.valid() && !parent_.lock())
     {
-        graphic_.set_background_color(theme_color(tcn, tv_background, theme_));
+        graphic_.set_background_color(theme_color(tcn_keys[tk_background], theme_));
 
         RECT client_rect;
         GetClientRect(context_.hwnd, &client_rect);
@@ -738,7 +835,7 @@ void window::expand()
                 SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
         }
     }
-    expand_button->set_image(theme_image(ti_normal, theme_));
+    expand_button->set_image(ti_normal);
 }
 
 void window::normal()
@@ -766,7 +863,7 @@ void window::normal()
         set_position(normal_position, false);
     }
 
-    expand_button->set_image(theme_image(ti_expand, theme_));
+    expand_button->set_image(ti_expand);
 
     update_buttons();
 
@@ -882,6 +979,16 @@ bool window::draw_enabled() const
     return !skip_draw_;
 }
 
+damage_statistics window::get_damage_statistics() const
+{
+    return damage_.statistics();
+}
+
+void window::reset_damage_statistics()
+{
+    damage_.reset_statistics();
+}
+
 void window::emit_event(int32_t x, int32_t y)
 {
     auto parent__ = parent_.lock();
@@ -907,26 +1014,45 @@ void window::set_default_push_control(std::shared_ptr<i_control> control)
 
 void window::send_event_to_control(const std::shared_ptr<i_control> &control_, const event &ev)
 {
-    auto it = std::find_if(subscribers_.begin(), subscribers_.end(), [control_, ev](const event_subscriber &es) {
-        return flag_is_set(es.event_types, ev.type) && es.control == control_;
-    });
-    
-    if (it != subscribers_.end())
+    compact_subscribers();
+
+    auto it = control_subscribers.find(control_.get());
+    if (it == control_subscribers.end())
     {
-        it->receive_callback(ev);
+        return;
+    }
+
+    for (auto slot : it->second[event_type_index(ev.type)])
+    {
+        auto &subscriber = subscribers_[slot];
+        if (subscriber.id != 0 && subscriber.receive_callback)
+        {
+            ++dispatch_depth;
+            subscriber.receive_callback(ev);
+            --dispatch_depth;
+
+            return;
+        }
     }
 }
 
 void window::send_event_to_plains(const event &ev)
 {
-    auto subscribers__ = subscribers_; // This is necessary to be able to remove the subscriber in the callback
-    for (auto &s : subscribers__)
+    compact_subscribers();
+
+    auto &slots = plain_subscribers[event_type_index(ev.type)];
+
+    /// The subscribers added by the callbacks get the next event, the removed ones are skipped
+    ++dispatch_depth;
+    for (size_t i = 0, count = slots.size(); i != count; ++i)
     {
-        if (!s.control && flag_is_set(s.event_types, ev.type) && s.receive_callback)
+        auto &subscriber = subscribers_[slots[i]];
+        if (subscriber.id != 0 && subscriber.receive_callback)
         {
-            s.receive_callback(ev);
+            subscriber.receive_callback(ev);
         }
     }
+    --dispatch_depth;
 }
 
 void window::send_mouse_event(const mouse_event &ev)
@@ -982,42 +1108,36 @@ void window::send_mouse_event(const mouse_event &ev)
 
     if (enabled_)
     {
-        auto end = controls.rend();
-        for (auto control = controls.rbegin(); control != end; ++control)
+        auto control = find_control(ev.x, ev.y, true);
+        if (!control)
         {
-            if (*control && (*control)->topmost() && (*control)->showed() && (*control)->position().in(ev.x, ev.y))
-            {
-                return send_mouse_event_to_control(*control, ev);
-            }
+            control = find_control(ev.x, ev.y, false);
         }
 
-        for (auto control = controls.rbegin(); control != end; ++control)
+        if (control)
         {
-            if (*control && (*control)->showed() && (*control)->position().in(ev.x, ev.y))
-            {
-                return send_mouse_event_to_control(*control, ev);
-            }
+            return send_mouse_event_to_control(control, ev);
         }
     }
-    else
+    else if (docked_control && docked_control->position().in(ev.x, ev.y))
     {
-        for (auto &control : controls)
-        {
-            if (control && control->position().in(ev.x, ev.y) && control == docked_control)
-            {
-                return send_mouse_event_to_control(control, ev);
-            }
-        }
+        auto control = docked_control;
+        return send_mouse_event_to_control(control, ev);
     }
 }
 
 bool window::check_control_here(int32_t x, int32_t y)
 {
-    for (auto &control : controls)
+    compact_subscribers();
+    update_controls_grid();
+
+    auto origin = grid_origin();
+    controls_grid.query(x - origin.left, y - origin.top, grid_hits);
+
+    for (auto order : grid_hits)
     {
-        if (control->showed() &&
-            control->position().in(x, y) &&
-            std::find_if(subscribers_.begin(), subscribers_.end(), [&control](const event_subscriber &es) { return es.control == control; }) != subscribers_.end())
+        auto &control = controls[order];
+        if (control->showed() && control_subscribers.find(control.get()) != control_subscribers.end())
         {
             return true;
         }
@@ -1171,18 +1291,18 @@ std::shared_ptr<i_control> window::get_focused()
 
 void window::update_button_images()
 {
-	switch_lang_button->set_image(theme_image(ti_switch_lang, theme_));
-    switch_theme_button->set_image(theme_image(ti_switch_theme, theme_));
-    pin_button->set_image(theme_image(ti_pin, theme_));
-    minimize_button->set_image(theme_image(ti_minimize, theme_));
-    expand_button->set_image(theme_image(window_state_ == window_state::normal ? ti_expand : ti_normal, theme_));
-    close_button->set_image(theme_image(ti_close, theme_));
+	switch_lang_button->set_image(ti_switch_lang);
+    switch_theme_button->set_image(ti_switch_theme);
+    pin_button->set_image(ti_pin);
+    minimize_button->set_image(ti_minimize);
+    expand_button->set_image(window_state_ == window_state::normal ? ti_expand : ti_normal);
+    close_button->set_image(ti_close);
 }
 
 void window::update_buttons()
 {
-	auto border_height = flag_is_set(window_style_, window_style::border_top) ? theme_dimension(tcn, tv_border_width, theme_) : 0;
-    auto border_width = flag_is_set(window_style_, window_style::border_right) ? theme_dimension(tcn, tv_border_width, theme_) : 0;
+	auto border_height = flag_is_set(window_style_, window_style::border_top) ? theme_dimension(tcn_keys[tk_border_width], theme_) : 0;
+    auto border_width = flag_is_set(window_style_, window_style::border_right) ? theme_dimension(tcn_keys[tk_border_width], theme_) : 0;
 
     auto btn_size = 28;
     auto left = position_.width() - btn_size - border_width;
@@ -1272,8 +1392,8 @@ void window::update_buttons()
 
 void window::draw_border(graphic &gr)
 {
-    auto c = theme_color(tcn, tv_border, theme_);
-    auto x = theme_dimension(tcn, tv_border_width, theme_);
+    auto c = theme_color(tcn_keys[tk_border], theme_);
+    auto x = theme_dimension(tcn_keys[tk_border_width], theme_);
 
     int32_t l = 0, t = 0, w = 0, h = 0;
 
@@ -1311,6 +1431,133 @@ void window::draw_border(graphic &gr)
     }
 }
 
+void window::paint(const rect &paint_rect, bool erase)
+{
+    if (erase)
+    {
+        graphic_.clear(paint_rect);
+    }
+    if (flag_is_set(window_style_, window_style::title_showed) && !parent_.lock())
+    {
+        auto caption_font = theme_font(tcn_keys[tk_caption_font], theme_);
+
+        auto caption_rect = graphic_.measure_text(caption, caption_font);
+        caption_rect.move(5, 5);
+
+        if (caption_rect.in(paint_rect))
+        {
+            graphic_.draw_rect(caption_rect, theme_color(tcn_keys[tk_background], theme_));
+            graphic_.draw_text(caption_rect,
+                caption,
+                theme_color(tcn_keys[tk_text], theme_),
+                caption_font);
+        }
+    }
+
+    draw_border(graphic_);
+
+    draw_controls(graphic_, paint_rect);
+
+    graphic_.flush(paint_rect);
+}
+
+void window::draw_controls(graphic &gr, const rect &paint_rect)
+{
+    update_controls_grid();
+
+    auto origin = grid_origin();
+    auto grid_rect = paint_rect;
+    grid_rect.move(-origin.left, -origin.top);
+
+    controls_grid.query(grid_rect, grid_hits);
+
+    /// Copied because a control can change the controls list while drawing
+    std::vector<std::shared_ptr<i_control>> visible_controls, topmost_controls;
+    for (auto order : grid_hits)
+    {
+        visible_controls.emplace_back(controls[order]);
+    }
+
+    /// The controls draw themselves whole, the clip keeps the pixels outside the damaged area
+    gr.push_clip(paint_rect);
+
+    for (auto &control : visible_controls)
+    {
+        if (!control->topmost())
+        {
+            control->draw(gr, paint_rect);
+        }
+        else
+        {
+            topmost_controls.emplace_back(control);
+        }
+    }
+
+    for (auto &control : topmost_controls)
+    {
+        control->draw(gr, paint_rect);
+    }
+
+    gr.pop_clip();
+}
+
+rect window::grid_origin() const
+{
+    /// The controls of the child window are placed relative to its parent,
+    /// so the grid keeps them relative to this window and survives the window moving
+    if (parent_.lock())
+    {
+        auto pos = position();
+        return { pos.left, pos.top, pos.left, pos.top };
+    }
+    return { 0 };
+}
+
+void window::update_controls_grid()
+{
+    if (controls_grid_valid)
+    {
+        return;
+    }
+
+    auto origin = grid_origin();
+
+    controls_grid.clear();
+    for (int32_t order = 0; order != static_cast<int32_t>(controls.size()); ++order)
+    {
+        auto control_position = controls[order]->position();
+        control_position.move(-origin.left, -origin.top);
+
+        controls_grid.insert(order, control_position);
+    }
+
+    controls_grid_valid = true;
+}
+
+void window::invalidate_controls_grid()
+{
+    controls_grid_valid = false;
+}
+
+std::shared_ptr<i_control> window::find_control(int32_t x, int32_t y, bool topmost_only)
+{
+    update_controls_grid();
+
+    auto origin = grid_origin();
+    controls_grid.query(x - origin.left, y - origin.top, grid_hits);
+
+    for (auto order = grid_hits.rbegin(); order != grid_hits.rend(); ++order)
+    {
+        auto &control = controls[*order];
+        if (control && (!topmost_only || control->topmost()) && control->showed())
+        {
+            return control;
+        }
+    }
+
+    return nullptr;
+}
+
 void window::send_internal(internal_event_type type, int32_t x, int32_t y)
 {
     event ev_;
@@ -1506,6 +1753,7 @@ void window::destroy()
     active_control.reset();
 
     controls.clear();
+    controls_grid_valid = false;
 
     auto parent__ = parent_.lock();
     if (parent__)
@@ -1574,7 +1822,7 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
 
             window* wnd = reinterpret_cast<window*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
 
-            wnd->graphic_.init(get_screen_size(wnd->context_), theme_color(wnd->tcn, tv_background, wnd->theme_));
+            wnd->graphic_.init(get_screen_size(wnd->context_), theme_color(wnd->tcn_keys[tk_background], wnd->theme_));
 
             wnd->send_internal(internal_event_type::window_created, 0, 0);
         }
@@ -1591,58 +1839,31 @@ LRESULT CALLBACK window::wnd_proc(HWND hwnd, UINT message, WPARAM w_param, LPARA
                 return 0;
             }
 
-            const rect paint_rect{ ps.rcPaint.left,
-                ps.rcPaint.top,
-                ps.rcPaint.right,
-                ps.rcPaint.bottom };
-
-            if (ps.fErase)
-            {
-                wnd->graphic_.clear(paint_rect);
-            }
-            if (flag_is_set(wnd->window_style_, window_style::title_showed) && !wnd->parent_.lock())
+            /// The system invalidated area (moving, uncovering) is painted together with the accumulated damage
+            const rect system_rect{ ps.rcPaint.left, ps.rcPaint.top, ps.rcPaint.right, ps.rcPaint.bottom };
+            auto &damaged_rects = wnd->damage_.rects();
+            if (std::none_of(damaged_rects.begin(), damaged_rects.end(), [&system_rect](const rect &r) {
+                    return r.left <= system_rect.left && r.top <= system_rect.top && r.right >= system_rect.right && r.bottom >= system_rect.bottom;
+                }))
             {
-                auto caption_font = theme_font(wnd->tcn, tv_caption_font, wnd->theme_);
-
-                auto caption_rect = wnd->graphic_.measure_text(wnd->caption, caption_font);
-                caption_rect.move(5, 5);
-
-                if (caption_rect.in(paint_rect))
-                {
-                    wnd->graphic_.draw_rect(caption_rect, theme_color(wnd->tcn, tv_background, wnd->theme_));
-                    wnd->graphic_.draw_text(caption_rect,
-                        wnd->caption,
-                        theme_color(wnd->tcn, tv_text, wnd->theme_),
-                        caption_font);
-                }
+                wnd->damage_.add(system_rect);
             }
 
-            wnd->draw_border(wnd->graphic_);
-
-            std::vector<std::shared_ptr<i_control>> topmost_controls;
+            bool erase = ps.fErase || wnd->damage_erase;
+            wnd->damage_erase = false;
 
-            for (auto &control : wnd->controls)
+            for (auto &paint_rect : wnd->damage_.flush())
             {
-                if (control->position().in(paint_rect))
-                {
-                    if (!control->topmost())
-                    {
-                        control->draw(wnd->graphic_, paint_rect);
-                    }
-                    else
-                    {
-                        topmost_controls.emplace_back(control);
-                    }
-                }
+                wnd->paint(paint_rect, erase);
             }
 
-            for (auto &control : topmost_controls)
+            if (!wnd->damage_.empty()) /// some control asked for redraw while painting
             {
-                control->draw(wnd->graphic_, paint_rect);
+                auto bounds = wnd->damage_.bounds();
+                RECT invalidatingRect = { bounds.left, bounds.top, bounds.right, bounds.bottom };
+                InvalidateRect(hwnd, &invalidatingRect, FALSE);
             }
 
-            wnd->graphic_.flush(paint_rect);
-
             EndPaint(hwnd, &ps);
         }
         break;
@@ -0,0 +1,281 @@
+/// Compiles the theme and locale JSONs with their images into one binary bundle.
+/// The application loads it by set_default_theme_from_bundle() / set_locale_from_bundle(),
+/// the file is mapped and used without parsing.
+///
+/// Usage: bundle_compiler <output> [--theme name=file.json]... [--locale name=file.json]... [--images name=dir]... [--bench]
+
+#include <wui/system/bundle.hpp>
+#include <wui/common/color.hpp>
+#include <wui/common/font.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <map>
+
+namespace
+{
+
+struct source
+{
+    std::string kind, part, path;
+};
+
+bool read_file(const std::string &path, std::string &out)
+{
+    std::ifstream f(path, std::ios::binary);
+    if (!f)
+    {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << f.rdbuf();
+    out = buffer.str();
+    return true;
+}
+
+/// Same rules as theme_impl::load_json(): "#rrggbb" is a color, the objects with "font" in the name are fonts
+uint16_t font_decorations(const std::string &d)
+{
+    uint32_t v = static_cast<uint32_t>(wui::decorations::normal);
+    if (d.find("bold") != std::string::npos) v |= static_cast<uint32_t>(wui::decorations::bold);
+    if (d.find("italic") != std::string::npos) v |= static_cast<uint32_t>(wui::decorations::italic);
+    if (d.find("underline") != std::string::npos) v |= static_cast<uint32_t>(wui::decorations::underline);
+    if (d.find("strike") != std::string::npos) v |= static_cast<uint32_t>(wui::decorations::strike_out);
+    return static_cast<uint16_t>(v);
+}
+
+int32_t theme_color(const std::string &hex)
+{
+    auto c = static_cast<wui::color>(std::stol(hex, nullptr, 16));
+    return static_cast<int32_t>(wui::make_color(wui::get_red(c), wui::get_green(c), wui::get_blue(c)));
+}
+
+std::vector<uint8_t> decode_hex_image(const std::string &s)
+{
+    std::vector<uint8_t> data;
+    std::string byte_val;
+    for (auto c : s)
+    {
+        if (c == ' ' || c == ',')
+        {
+            continue;
+        }
+        byte_val += c;
+        if (byte_val.size() == 4)
+        {
+            data.emplace_back(static_cast<uint8_t>(std::stoul(byte_val, nullptr, 16)));
+            byte_val.clear();
+        }
+    }
+    return data;
+}
+
+void compile_theme(wui::bundle_writer &w, const std::string &part, const std::string &json)
+{
+    auto j = nlohmann::json::parse(json);
+
+    for (auto &c : j.at("controls"))
+    {
+        auto control = c.at("type").get<std::string>();
+        for (auto &kvp : c.get<nlohmann::json::object_t>())
+        {
+            if (kvp.first == "type")
+            {
+                continue;
+            }
+
+            if (kvp.second.is_string())
+            {
+                auto str = kvp.second.get<std::string>();
+                if (!str.empty() && str[0] == '#')
+                {
+                    w.add_integer(part, control, kvp.first, theme_color(str.substr(1)));
+                }
+                else
+                {
+                    w.add_string(part, control, kvp.first, str);
+                }
+            }
+            else if (kvp.second.is_number_integer())
+            {
+                w.add_integer(part, control, kvp.first, kvp.second.get<int32_t>());
+            }
+            else if (kvp.second.is_object() && kvp.first.find("font") != std::string::npos)
+            {
+                auto &fnt = kvp.second;
+                w.add_font(part, control, kvp.first,
+                    fnt.value("name", std::string("Segoe UI")),
+                    fnt.value("size", 18),
+                    font_decorations(fnt.value("decorations", std::string())));
+            }
+        }
+    }
+
+    if (j.contains("images"))
+    {
+        for (auto &i : j.at("images"))
+        {
+            for (auto &kvp : i.get<nlohmann::json::object_t>())
+            {
+                w.add_image(part, kvp.first, decode_hex_image(kvp.second.get<std::string>()));
+            }
+        }
+    }
+}
+
+void compile_locale(wui::bundle_writer &w, const std::string &part, const std::string &json)
+{
+    auto j = nlohmann::json::parse(json);
+
+    for (auto &s : j.at("sections"))
+    {
+        auto section = s.at("type").get<std::string>();
+        for (auto &kvp : s.get<nlohmann::json::object_t>())
+        {
+            if (kvp.first != "type" && kvp.second.is_string())
+            {
+                w.add_string(part, section, kvp.first, kvp.second.get<std::string>());
+            }
+        }
+    }
+}
+
+void compile_images(wui::bundle_writer &w, const std::string &part, const std::string &dir)
+{
+    for (auto &entry : std::filesystem::directory_iterator(dir))
+    {
+        std::string data;
+        if (entry.is_regular_file() && read_file(entry.path().string(), data))
+        {
+            w.add_image(part, entry.path().filename().string(), std::vector<uint8_t>(data.begin(), data.end()));
+        }
+    }
+}
+
+/// Compare the cold start of the JSON path (read, parse, hex decoding) with the mapped bundle
+void bench(const std::vector<source> &sources, const std::string &output)
+{
+    using clock = std::chrono::steady_clock;
+    const int rounds = 100;
+
+    auto json_start = clock::now();
+    for (int r = 0; r != rounds; ++r)
+    {
+        wui::bundle_writer scratch;
+        for (auto &s : sources)
+        {
+            std::string json;
+            if (s.kind != "images" && read_file(s.path, json))
+            {
+                s.kind == "theme" ? compile_theme(scratch, s.part, json) : compile_locale(scratch, s.part, json);
+            }
+        }
+    }
+    auto json_time = std::chrono::duration<double, std::micro>(clock::now() - json_start).count() / rounds;
+
+    size_t items = 0;
+    auto bundle_start = clock::now();
+    for (int r = 0; r != rounds; ++r)
+    {
+        wui::bundle b;
+        b.open(output);
+        for (auto &s : sources)
+        {
+            std::map<std::pair<std::string, std::string>, std::string> strings;
+            b.visit(s.part, [&](const wui::bundle_item &item) {
+                if (item.kind == wui::bundle_kind::string)
+                {
+                    strings[{ std::string(item.section), std::string(item.value) }] = item.data;
+                }
+                ++items;
+            });
+        }
+    }
+    auto bundle_time = std::chrono::duration<double, std::micro>(clock::now() - bundle_start).count() / rounds;
+
+    std::cout << "json load: " << json_time << " us, bundle load: " << bundle_time << " us (" << items / rounds << " items)" << std::endl;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: bundle_compiler <output> [--theme name=file.json] [--locale name=file.json] [--images name=dir] [--bench]" << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    std::vector<source> sources;
+    bool run_bench = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--bench")
+        {
+            run_bench = true;
+        }
+        else if ((arg == "--theme" || arg == "--locale" || arg == "--images") && i + 1 < argc)
+        {
+            std::string spec = argv[++i];
+            auto eq = spec.find('=');
+            if (eq == std::string::npos)
+            {
+                std::cerr << "expected name=path: " << spec << std::endl;
+                return 1;
+            }
+            sources.emplace_back(source{ arg.substr(2), spec.substr(0, eq), spec.substr(eq + 1) });
+        }
+        else
+        {
+            std::cerr << "unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    wui::bundle_writer writer;
+    try
+    {
+        for (auto &s : sources)
+        {
+            if (s.kind == "images")
+            {
+                compile_images(writer, s.part, s.path);
+                continue;
+            }
+
+            std::string json;
+            if (!read_file(s.path, json))
+            {
+                std::cerr << "unable to read: " << s.path << std::endl;
+                return 1;
+            }
+            s.kind == "theme" ? compile_theme(writer, s.part, json) : compile_locale(writer, s.part, json);
+        }
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "compile error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!writer.save(output))
+    {
+        std::cerr << "unable to write: " << output << std::endl;
+        return 1;
+    }
+
+    if (run_bench)
+    {
+        bench(sources, output);
+    }
+
+    return 0;
+}